@@ -0,0 +1,101 @@
+// Measures the throughput of a gtl::concurrent_flat_hash_set<uint64_t>, whose
+// insert() and contains() take no lock, against a parallel_flat_hash_set_m
+// with 2^4 and 2^6 submaps, for an increasing number of threads.
+// Every thread inserts keys drawn from a shared range, as a crawler's dedup
+// set would (so about half of the insertions find the key already present),
+// then checks whether keys are present, as a graph traversal's visited set.
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtl/concurrent_flat_hash_set.hpp>
+#include <gtl/phmap.hpp>
+#include <gtl/stopwatch.hpp>
+
+template<size_t N>
+using ParallelSet = gtl::parallel_flat_hash_set_m<uint64_t,
+                                                  gtl::priv::hash_default_hash<uint64_t>,
+                                                  gtl::priv::hash_default_eq<uint64_t>,
+                                                  std::allocator<uint64_t>,
+                                                  N>;
+
+using ConcurrentSet = gtl::concurrent_flat_hash_set<uint64_t>;
+
+static constexpr uint64_t num_keys       = 1 << 22;
+static constexpr size_t   ops_per_thread = 2000000;
+
+static bool inserted(bool b) { return b; }
+
+template<class It>
+static bool inserted(const std::pair<It, bool>& p) {
+    return p.second;
+}
+
+// ---------------------------------------------------------------------------------
+// returns millions of operations per second for the insertions and the lookups
+// ---------------------------------------------------------------------------------
+template<class Set>
+std::pair<double, double> run(size_t num_threads) {
+    Set s(num_keys);
+
+    auto run_phase = [&](bool insert) {
+        std::vector<std::thread> threads;
+        std::vector<uint64_t>    found(num_threads);
+        gtl::stopwatch           sw;
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&s, &found, t, insert]() {
+                uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1), cnt = 0;
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    x ^= x << 13; // xorshift64
+                    x ^= x >> 7;
+                    x ^= x << 17;
+                    uint64_t k = x % num_keys;
+                    if (insert)
+                        cnt += inserted(s.insert(k));
+                    else
+                        cnt += s.contains(k);
+                }
+                found[t] = cnt;
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        sw.snap();
+
+        uint64_t total = 0;
+        for (auto f : found)
+            total += f;
+        if (total == 0 || s.size() > num_keys)
+            printf("error!\n");
+        return (double)(num_threads * ops_per_thread) / (sw.start_to_snap() * 1000);
+    };
+
+    double ins = run_phase(true);
+    return { ins, run_phase(false) };
+}
+
+template<size_t N>
+void print_parallel(size_t num_threads) {
+    auto [ins, find] = run<ParallelSet<N>>(num_threads);
+    printf("%8zu parallel_flat_hash_set_m<N=%zu>    %12.1f %12.1f\n", num_threads, N, ins, find);
+}
+
+// ---------------------------------------------------------------------------------
+int main() {
+    size_t max_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    printf("%zu keys, %zu ops per thread and phase, throughput in Mops/s\n\n", (size_t)num_keys, ops_per_thread);
+    printf("%8s %-32s %12s %12s\n", "threads", "set", "insert", "contains");
+
+    for (size_t num_threads = 1; num_threads <= 2 * max_threads; num_threads *= 2) {
+        auto [ins, find] = run<ConcurrentSet>(num_threads);
+        printf("%8zu %-32s %12.1f %12.1f\n", num_threads, "concurrent_flat_hash_set", ins, find);
+        print_parallel<4>(num_threads);
+        print_parallel<6>(num_threads);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Compares the lookup latency and the memory used per entry of a
+// frozen_flat_hash_map<uint64_t, uint64_t> with those of a flat_hash_map
+// holding the same keys, for successful (hit) and unsuccessful (miss) lookups.
+// The memory is measured with an allocator counting the bytes it allocates.
+// ---------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include <gtl/frozen_flat_hash_map.hpp>
+#include <gtl/phmap.hpp>
+#include <gtl/stopwatch.hpp>
+
+static constexpr size_t num_lookups = 10000000;
+
+static size_t allocated = 0;
+
+template<class T>
+struct counting_allocator : std::allocator<T> {
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template<class U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    template<class U>
+    struct rebind {
+        using other = counting_allocator<U>;
+    };
+
+    T* allocate(size_t n) {
+        allocated += n * sizeof(T);
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        allocated -= n * sizeof(T);
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+using Value  = std::pair<const uint64_t, uint64_t>;
+using Hash   = gtl::priv::hash_default_hash<uint64_t>;
+using Eq     = gtl::priv::hash_default_eq<uint64_t>;
+using Map    = gtl::flat_hash_map<uint64_t, uint64_t, Hash, Eq, counting_allocator<Value>>;
+using Frozen = gtl::frozen_flat_hash_map<uint64_t, uint64_t, Hash, Eq, counting_allocator<Value>>;
+
+// ---------------------------------------------------------------------------------
+// returns nanoseconds per lookup of keys drawn from `keys`
+// ---------------------------------------------------------------------------------
+template<class M>
+static double lookup(const M& m, const std::vector<uint64_t>& keys) {
+    std::mt19937_64 rng(7);
+    uint64_t        found = 0;
+    gtl::stopwatch  sw;
+    for (size_t i = 0; i < num_lookups; ++i)
+        found += m.contains(keys[rng() % keys.size()]);
+    sw.snap();
+    if (found == 0xdeadbeef)
+        printf("unlikely\n");
+    return sw.start_to_snap() * 1e6 / num_lookups;
+}
+
+template<class M>
+static void report(const char* name, const M& m, size_t bytes, const std::vector<uint64_t>& hits,
+                   const std::vector<uint64_t>& misses) {
+    printf("%10zu %8s %10.4f %10.2f %10.2f %14.2f\n",
+           m.size(),
+           name,
+           m.load_factor(),
+           lookup(m, hits),
+           lookup(m, misses),
+           (double)bytes / m.size());
+}
+
+static void run(size_t size) {
+    std::mt19937_64       rng(42);
+    std::vector<uint64_t> hits, misses;
+
+    size_t before = allocated;
+    Map    m;
+    while (m.size() < size) {
+        uint64_t k = rng();
+        if (m.emplace(k, k).second)
+            hits.push_back(k);
+    }
+    size_t map_bytes = allocated - before;
+    while (misses.size() < hits.size()) {
+        uint64_t k = rng();
+        if (!m.contains(k))
+            misses.push_back(k);
+    }
+
+    before = allocated;
+    gtl::stopwatch sw;
+    Frozen         f(m);
+    sw.snap();
+    size_t frozen_bytes = allocated - before;
+
+    report("flat", m, map_bytes, hits, misses);
+    report("frozen", f, frozen_bytes, hits, misses);
+    printf("%10s built in %.1f ms\n", "", sw.start_to_snap());
+}
+
+// ---------------------------------------------------------------------------------
+int main() {
+    printf("%10s %8s %10s %10s %10s %14s\n", "size", "map", "load", "hit (ns)", "miss (ns)", "bytes/entry");
+
+    for (size_t size : { size_t(50000), size_t(1000000), size_t(10000000) }) {
+        run(size);
+        printf("\n");
+    }
+    return 0;
+}
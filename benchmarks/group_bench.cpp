@@ -0,0 +1,90 @@
+// Compares lookup speed of flat_hash_map<uint64_t, uint64_t> for the different
+// control byte Group widths. This file is built twice by cmake:
+//    - bench_group:      default group (GroupSse2Impl when SSE2 is available)
+//    - bench_group_avx2: compiled with -mavx2 -DGTL_USE_AVX2_GROUP=1 (GroupAvx2Impl)
+//
+// Tables are filled close to their maximum load factor, where probe sequences
+// are longest, and then queried with keys that are present (hit) and absent (miss).
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtl/phmap.hpp>
+#include <gtl/stopwatch.hpp>
+
+using Map = gtl::flat_hash_map<uint64_t, uint64_t>;
+
+// ---------------------------------------------------------------------------------
+template<class Map>
+uint64_t lookup(const Map& m, const std::vector<uint64_t>& keys, size_t num_loops) {
+    uint64_t res = 0;
+    for (size_t l = 0; l < num_loops; ++l) {
+        for (auto k : keys) {
+            auto it = m.find(k);
+            if (it != m.end())
+                res += it->second;
+            else
+                ++res;
+        }
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------------
+void bench(size_t capacity, size_t num_lookups) {
+    std::mt19937_64 rng(capacity);
+
+    // fill up to the max load factor (7/8) without triggering a resize
+    // ----------------------------------------------------------------
+    Map m;
+    m.reserve(capacity - capacity / 8);
+    size_t num_keys = m.capacity() - m.capacity() / 8;
+
+    std::vector<uint64_t> hits, misses;
+    hits.reserve(num_keys);
+    while (m.size() < num_keys) {
+        uint64_t k = rng();
+        if (m.emplace(k, k).second)
+            hits.push_back(k);
+    }
+    while (misses.size() < num_keys) {
+        uint64_t k = rng();
+        if (!m.contains(k))
+            misses.push_back(k);
+    }
+    std::shuffle(hits.begin(), hits.end(), rng);
+
+    size_t num_loops = std::max(num_lookups / num_keys, size_t(1));
+    double total     = double(num_keys) * double(num_loops);
+
+    gtl::stopwatch sw;
+    uint64_t       res_hit = lookup(m, hits, num_loops);
+    sw.snap();
+    double hit_ns = sw.start_to_snap() * 1e6 / total;
+
+    sw.start();
+    uint64_t res_miss = lookup(m, misses, num_loops);
+    sw.snap();
+    double miss_ns = sw.start_to_snap() * 1e6 / total;
+
+    printf("%12zu %12zu %7.3f %10.2f %10.2f   (%llu)\n",
+           m.capacity(),
+           m.size(),
+           m.load_factor(),
+           hit_ns,
+           miss_ns,
+           (unsigned long long)(res_hit + res_miss));
+}
+
+// ---------------------------------------------------------------------------------
+int main() {
+    printf("Group::kWidth = %d\n\n", (int)gtl::priv::Group::kWidth);
+    printf("%12s %12s %7s %10s %10s\n", "capacity", "size", "load", "hit (ns)", "miss (ns)");
+
+    constexpr size_t num_lookups = 50000000;
+    for (size_t capacity = 1024; capacity <= (size_t(1) << 26); capacity *= 4)
+        bench(capacity, num_lookups);
+    return 0;
+}
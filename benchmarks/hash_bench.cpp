@@ -1,7 +1,10 @@
 #include <iostream>
 #include <string>
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <vector>
 #include <limits>
 #include <random>
 #include <utility>
@@ -117,37 +120,92 @@ struct PMHash
 };
 
 
-int main()
+struct StdHash
 {
-    PMHash::init();
+    template<class T>
+    std::size_t operator()(T const& s) const
+    {
+        return std::hash<T>()(s);
+    }
+};
 
-    // using Map = gtl::flat_hash_map<std::string, uint32_t, PMHash>; // try using polymur_hash
-    using Map = gtl::flat_hash_map<std::string, uint32_t>;
+struct GtlHash
+{
+    template<class T>
+    std::size_t operator()(T const& s) const
+    {
+        return gtl::Hash<T>()(s);
+    }
+};
+
+using clock_type = std::chrono::steady_clock;
+
+// hashes `len` bytes at successive offsets of a buffer, returns GB/s
+template<class H>
+double bytes_throughput(const std::vector<char>& buf, size_t len)
+{
+    const size_t num   = std::max<size_t>(1000, (size_t(1) << 28) / std::max<size_t>(len, 16));
+    const size_t range = buf.size() - len;
+    H            h;
+    size_t       res   = 0;
+    auto         start = clock_type::now();
+    for (size_t i = 0; i < num; ++i)
+        res += h(std::string_view(buf.data() + (i * 7 + (res & 1)) % range, len));
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
+    if (res == 42)
+        std::cout << ""; // keep res alive
+    return (double)num * len / secs / 1e9;
+}
+
+// the map-level test: count occurrences of short random strings
+template<class Map>
+void map_throughput(const char* name, size_t n)
+{
     Map map;
     map.reserve((size_t)(65536 * 1.1)); // we will create a maximun of 65536 different strings
 
-    sfc64                  rng(123);
-    constexpr size_t const n = 50000000;
+    sfc64 rng(123);
+    auto  start = clock_type::now();
     for (size_t i = 0; i < n; ++i) {
         auto s = to_str(rng());
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
-        map[s]++;
+        for (int j = 0; j < 10; ++j)
+            map[s]++;
     }
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
 
     uint64_t cnt = 0;
-    for (const auto& s : map) {
-        if (++cnt == 6)
-            break;
-        std::cout << s.first << ": " << s.second << '\n';
+    for (const auto& s : map)
+        cnt += s.second;
+    printf("%-12s %8.1f M lookups/s   (%zu strings, %llu)\n",
+           name,
+           (double)n * 10 / secs / 1e6,
+           map.size(),
+           (unsigned long long)cnt);
+}
+
+int main()
+{
+    PMHash::init();
+
+    std::vector<char> buf(1 << 20);
+    sfc64             rng(42);
+    for (auto& c : buf)
+        c = (char)rng();
+
+    printf("hash throughput in GB/s by input length\n\n");
+    printf("%8s %12s %12s %12s\n", "bytes", "gtl::Hash", "std::hash", "polymur");
+    for (size_t len : { 4, 8, 16, 24, 32, 64, 128, 256, 1024, 4096, 65536 }) {
+        printf("%8zu %12.2f %12.2f %12.2f\n",
+               len,
+               bytes_throughput<GtlHash>(buf, len),
+               bytes_throughput<StdHash>(buf, len),
+               bytes_throughput<PMHash>(buf, len));
     }
 
+    printf("\nflat_hash_map<std::string, uint32_t> with 4 byte keys\n\n");
+    constexpr size_t const n = 5000000;
+    map_throughput<gtl::flat_hash_map<std::string, uint32_t>>("default", n);
+    map_throughput<gtl::flat_hash_map<std::string, uint32_t, StdHash>>("std::hash", n);
+    map_throughput<gtl::flat_hash_map<std::string, uint32_t, PMHash>>("polymur", n);
     return 0;
 }
@@ -0,0 +1,81 @@
+// Measures the latency of every single insertion into a growing hash map, and
+// compares the regular tables, which move all their elements at once when they
+// resize, with the incrementally rehashing ones (flat_hash_map_incremental and
+// parallel_flat_hash_map_incremental), which spread that work over the
+// following insertions.
+//
+// The total insertion time is reported together with the latency percentiles;
+// the maximum is the latency of the largest resize for the regular tables.
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtl/phmap.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------------
+template<class Map>
+void bench(const char* name, const std::vector<uint64_t>& keys) {
+    std::vector<uint32_t> latencies(keys.size()); // in ns
+    Map                   m;
+
+    auto start = clock_type::now();
+    auto prev  = start;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        m.emplace(keys[i], i);
+        auto now     = clock_type::now();
+        latencies[i] = (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - prev).count();
+        prev         = now;
+    }
+    double total_ms = std::chrono::duration<double, std::milli>(prev - start).count();
+
+    // lookups, to show the cost of checking the draining table
+    auto     lookup_start = clock_type::now();
+    uint64_t res          = 0;
+    for (auto k : keys)
+        res += m.find(k)->second;
+    double lookup_ms = std::chrono::duration<double, std::milli>(clock_type::now() - lookup_start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) { return latencies[std::min(latencies.size() - 1, size_t(p * latencies.size()))]; };
+
+    printf("%-38s %10.1f %10.1f %8u %8u %8u %12.1f   (%llu)\n",
+           name,
+           total_ms,
+           lookup_ms,
+           pct(0.99),
+           pct(0.9999),
+           pct(0.999999),
+           latencies.back() / 1000.0,
+           (unsigned long long)(res + m.size()));
+}
+
+// ---------------------------------------------------------------------------------
+int main() {
+    constexpr size_t num_keys = 1 << 23;
+
+    std::mt19937_64       rng(42);
+    std::vector<uint64_t> keys(num_keys);
+    for (auto& k : keys)
+        k = rng();
+
+    printf("inserting %zu keys, insert latencies in ns (max in us)\n\n", num_keys);
+    printf("%-38s %10s %10s %8s %8s %8s %12s\n",
+           "map",
+           "insert ms",
+           "lookup ms",
+           "p99",
+           "p99.99",
+           "p99.9999",
+           "max (us)");
+
+    bench<gtl::flat_hash_map<uint64_t, uint64_t>>("flat_hash_map", keys);
+    bench<gtl::flat_hash_map_incremental<uint64_t, uint64_t>>("flat_hash_map_incremental", keys);
+    bench<gtl::parallel_flat_hash_map<uint64_t, uint64_t>>("parallel_flat_hash_map", keys);
+    bench<gtl::parallel_flat_hash_map_incremental<uint64_t, uint64_t>>("parallel_flat_hash_map_incremental", keys);
+    return 0;
+}
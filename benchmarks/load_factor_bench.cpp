@@ -0,0 +1,74 @@
+// Measures the effect of the maximum load factor of a flat_hash_map<uint64_t,
+// uint64_t> on the lookup latency, for successful (hit) and unsuccessful (miss)
+// lookups, and on the memory used per entry. Each table is filled up to its
+// maximum load factor, just before it would grow, which is the worst case for
+// both the probe lengths and the memory use.
+// ---------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtl/phmap.hpp>
+#include <gtl/stopwatch.hpp>
+
+using Map = gtl::flat_hash_map<uint64_t, uint64_t>;
+
+static constexpr size_t num_lookups = 10000000;
+
+// ---------------------------------------------------------------------------------
+// returns nanoseconds per lookup of keys drawn from `keys`
+// ---------------------------------------------------------------------------------
+static double lookup(const Map& m, const std::vector<uint64_t>& keys) {
+    std::mt19937_64 rng(7);
+    uint64_t        found = 0;
+    gtl::stopwatch  sw;
+    for (size_t i = 0; i < num_lookups; ++i)
+        found += m.contains(keys[rng() % keys.size()]);
+    sw.snap();
+    if (found == 0xdeadbeef)
+        printf("unlikely\n");
+    return sw.start_to_snap() * 1e6 / num_lookups;
+}
+
+static void run(size_t capacity, float max_load) {
+    const size_t growth = gtl::priv::CapacityToGrowth(capacity, gtl::priv::ToMaxLoad(max_load));
+    Map          m;
+    m.max_load_factor(max_load);
+    m.reserve(growth);
+
+    std::mt19937_64       rng(42);
+    std::vector<uint64_t> hits, misses;
+    while (m.size() < growth) {
+        uint64_t k = rng();
+        if (m.emplace(k, k).second)
+            hits.push_back(k);
+    }
+    if (m.capacity() != capacity)
+        printf("error!\n");
+    while (misses.size() < hits.size()) {
+        uint64_t k = rng();
+        if (!m.contains(k))
+            misses.push_back(k);
+    }
+
+    double bytes = (double)m.capacity() * (sizeof(Map::value_type) + 1) / m.size();
+    printf("%10zu %8.4f %10zu %10.2f %10.2f %14.2f\n",
+           m.capacity(),
+           m.max_load_factor(),
+           m.size(),
+           lookup(m, hits),
+           lookup(m, misses),
+           bytes);
+}
+
+// ---------------------------------------------------------------------------------
+int main() {
+    printf("%10s %8s %10s %10s %10s %14s\n", "capacity", "max_load", "size", "hit (ns)", "miss (ns)", "bytes/entry");
+
+    for (size_t capacity : { (size_t(1) << 16) - 1, (size_t(1) << 20) - 1, (size_t(1) << 24) - 1 }) {
+        for (float max_load : { 0.5f, 0.75f, 0.875f, 0.9375f })
+            run(capacity, max_load);
+        printf("\n");
+    }
+    return 0;
+}
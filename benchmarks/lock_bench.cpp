@@ -0,0 +1,101 @@
+// Measures the throughput of a parallel_flat_hash_map<uint64_t, uint64_t>
+// under contention, for each of the mutex types supported by LockableImpl,
+// an increasing number of threads, and a varying number of submaps (2^N).
+// Every thread runs a mix of 80% lookups and 20% insertions/updates on a
+// shared key range, so the submap locks are taken for very short times.
+// ---------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include <gtl/phmap.hpp>
+#include <gtl/stopwatch.hpp>
+
+template<size_t N, class Mutex>
+using Map = gtl::parallel_flat_hash_map<uint64_t,
+                                        uint64_t,
+                                        gtl::priv::hash_default_hash<uint64_t>,
+                                        gtl::priv::hash_default_eq<uint64_t>,
+                                        std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                        N,
+                                        Mutex>;
+
+static constexpr uint64_t num_keys       = 1 << 16;
+static constexpr size_t   ops_per_thread = 2000000;
+
+// ---------------------------------------------------------------------------------
+// returns millions of operations per second
+// ---------------------------------------------------------------------------------
+template<size_t N, class Mutex>
+double run(size_t num_threads) {
+    Map<N, Mutex> m;
+    for (uint64_t i = 0; i < num_keys; i += 2)
+        m.emplace(i, i);
+
+    std::vector<std::thread> threads;
+    std::vector<uint64_t>    found(num_threads); // one entry per thread, written once
+    gtl::stopwatch           sw;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&m, &found, t]() {
+            uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1), cnt = 0;
+            for (size_t i = 0; i < ops_per_thread; ++i) {
+                x ^= x << 13; // xorshift64
+                x ^= x >> 7;
+                x ^= x << 17;
+                uint64_t k = x % num_keys;
+                if (x % 5 == 0)
+                    m.try_emplace_l(k, [](auto& v) { ++v.second; }, k);
+                else
+                    cnt += m.contains(k);
+            }
+            found[t] = cnt;
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    sw.snap();
+
+    uint64_t total = 0;
+    for (auto f : found)
+        total += f;
+    if (total == 0 || m.size() > num_keys)
+        printf("error!\n");
+    return (double)(num_threads * ops_per_thread) / (sw.start_to_snap() * 1000);
+}
+
+template<size_t N>
+void run_all(size_t num_threads) {
+    printf("%8zu %4zu %12.1f %12.1f %12.1f %12.1f %12.1f\n",
+           num_threads,
+           N,
+           run<N, std::mutex>(num_threads),
+           run<N, std::shared_mutex>(num_threads),
+           run<N, gtl::spin_mutex>(num_threads),
+           run<N, gtl::ticket_mutex>(num_threads),
+           run<N, gtl::rw_spin_mutex>(num_threads));
+}
+
+// ---------------------------------------------------------------------------------
+int main() {
+    size_t max_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    printf("%zu keys, %zu ops per thread, 80%% lookups, throughput in Mops/s\n\n", (size_t)num_keys, ops_per_thread);
+    printf("%8s %4s %12s %12s %12s %12s %12s\n",
+           "threads",
+           "N",
+           "std::mutex",
+           "shared_mtx",
+           "spin_mutex",
+           "ticket_mtx",
+           "rw_spin_mtx");
+
+    for (size_t num_threads = 1; num_threads <= 2 * max_threads; num_threads *= 2) {
+        run_all<0>(num_threads);
+        run_all<2>(num_threads);
+        run_all<4>(num_threads);
+        run_all<6>(num_threads);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Measures the time to resize a large flat_hash_map<uint64_t, uint64_t> using
+// the multi-threaded rehash (raw_hash_set::rehash(n, num_threads)), for an
+// increasing number of threads.
+// ---------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <gtl/phmap.hpp>
+#include <gtl/stopwatch.hpp>
+
+using Map = gtl::flat_hash_map<uint64_t, uint64_t>;
+
+// ---------------------------------------------------------------------------------
+int main() {
+    constexpr size_t num_elems = 1 << 24;
+
+    std::mt19937_64 rng(42);
+    Map             m;
+    m.reserve(num_elems);
+    while (m.size() < num_elems) {
+        uint64_t k = rng();
+        m.emplace(k, k);
+    }
+    const size_t capacity = m.capacity();
+
+    size_t max_threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    printf("resizing %zu elements from capacity %zu to %zu\n\n", m.size(), capacity, capacity * 2 + 1);
+    printf("%8s %12s %10s\n", "threads", "time (ms)", "speedup");
+
+    {
+        // warm up: the first resize pays for faulting in fresh memory pages
+        Map copy = m;
+        copy.rehash(capacity * 2 + 1);
+    }
+
+    float serial_ms = 0;
+    for (size_t num_threads = 0; num_threads <= max_threads; num_threads = num_threads ? num_threads * 2 : 1) {
+        Map copy = m; // reserves m.size(), so has the same capacity as m
+
+        gtl::stopwatch sw;
+        if (num_threads == 0)
+            copy.rehash(capacity * 2 + 1); // regular single threaded resize
+        else
+            copy.rehash(capacity * 2 + 1, num_threads);
+        sw.snap();
+
+        float ms = sw.start_to_snap();
+        if (num_threads == 0)
+            serial_ms = ms;
+        if (copy.size() != m.size() || copy.capacity() != capacity * 2 + 1)
+            printf("error!\n");
+
+        printf("%8s %12.1f %10.2f\n",
+               num_threads ? std::to_string(num_threads).c_str() : "serial",
+               ms,
+               serial_ms / ms);
+    }
+    return 0;
+}
@@ -10,6 +10,13 @@
     #define MAPNAME gtl::flat_hash_map
     #define NMSP gtl
     #define EXTRAARGS
+#elif defined(GTL_FLAT_CACHED_HASH)
+    // stores the full hash in each slot: compare the time and memory of the
+    // string benchmarks with the GTL_FLAT build.
+    #include "gtl/phmap.hpp"
+    #define MAPNAME gtl::flat_hash_map_cached_hash
+    #define NMSP gtl
+    #define EXTRAARGS
 #else
     #if 1
         #include <mutex>
@@ -326,6 +333,9 @@ Timer _delete(vector<T>& v, HT& hash) {
     return timer;
 }
 
+// --------------------------------------------------------------------------
+std::string long_key(int64_t i) { return "session/" + std::to_string(i) + "/user"; }
+
 // --------------------------------------------------------------------------
 void memlog() {
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -418,6 +428,25 @@ int main(int argc, char** argv) {
             timer.reset();
             for (i = 0; i < num_keys; i++)
                 str_hash.erase(std::to_string(i));
+        } else if (!strcmp(bench_name, "lookupstring")) {
+            // keys longer than the small string buffer, half of them missing
+            for (i = 0; i < num_keys; i++)
+                str_hash.insert({ long_key(i), value });
+            vector<std::string> keys(static_cast<size_t>(num_keys));
+            for (i = 0; i < num_keys; i++)
+                keys[i] = long_key(i * 2);
+            size_t num_present = 0;
+            timer.reset();
+            for (const auto& k : keys)
+                num_present += str_hash.contains(k);
+            out(bench_name, num_present, timer);
+        } else if (!strcmp(bench_name, "rehashstring")) {
+            // time to move all the elements to a table twice as large
+            for (i = 0; i < num_keys; i++)
+                str_hash.insert({ long_key(i), value });
+            timer.reset();
+            str_hash.rehash(str_hash.capacity() * 2);
+            out(bench_name, num_keys, timer);
         }
 
         // printf("%f\n", (float)((double)timer.elapsed().count() / 1000));
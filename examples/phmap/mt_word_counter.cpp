@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <gtl/phmap.hpp>
+#include <gtl/combining_map.hpp>
 #include <gtl/btree.hpp>
 #include <gtl/stopwatch.hpp>
 #include <thread>
@@ -49,40 +50,59 @@ int main() {
 
     using Map =
         gtl::parallel_flat_hash_map_m<std::string, size_t>; // parallel_flat_hash_map_m has default internal mutex
-    Map word_counts;
-
-    gtl::stopwatch sw(true);
+    constexpr size_t num_times = 256;
 
     // run 16 threads, each thread processing lines from one of the vectors
+    // and calling `count_word(word, state)` for each word
     // -------------------------------------------------------------------
-    constexpr size_t num_times = 256;
-    for (size_t x = 0; x < num_times; ++x) {
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        for (size_t i = 0; i < num_threads; ++i) {
-            threads.emplace_back(
-                [&word_counts](const std::vector<std::string>& lines) {
-                    for (const auto& line : lines) {
-                        std::istringstream iss(line);
-                        std::string        word;
-                        while (iss >> word) {
-                            // use lazy_emplace to modify the map while the mutex is locked
-                            word_counts.lazy_emplace_l(
-                                word,
-                                [&](Map::value_type& p) { ++p.second; }, // called only when key was already present
-                                [&](const Map::constructor& ctor) // construct value_type in place when key not present
-                                { ctor(std::move(word), 1); });
+    auto run = [&](auto make_state, auto count_word) {
+        gtl::stopwatch sw(true);
+        for (size_t x = 0; x < num_times; ++x) {
+            std::vector<std::thread> threads;
+            threads.reserve(num_threads);
+            for (size_t i = 0; i < num_threads; ++i) {
+                threads.emplace_back(
+                    [&](const std::vector<std::string>& lines) {
+                        auto state = make_state();
+                        for (const auto& line : lines) {
+                            std::istringstream iss(line);
+                            std::string        word;
+                            while (iss >> word)
+                                count_word(std::move(word), state);
                         }
-                    }
-                },
-                lines_array[i]);
+                    },
+                    lines_array[i]);
+            }
+
+            for (auto& thread : threads)
+                thread.join();
         }
+        sw.snap();
+        return sw.start_to_snap() / 1000;
+    };
 
-        for (auto& thread : threads)
-            thread.join();
-    }
+    // 1. one lock round-trip per word
+    // -------------------------------
+    Map  word_counts;
+    auto locked_time = run([]() { return 0; },
+                           [&](std::string&& word, int) {
+                               // use lazy_emplace to modify the map while the mutex is locked
+                               word_counts.lazy_emplace_l(
+                                   word,
+                                   [&](Map::value_type& p) { ++p.second; }, // called only when key was already present
+                                   [&](const Map::constructor& ctor) // construct value_type in place when key not present
+                                   { ctor(std::move(word), 1); });
+                           });
+
+    // 2. counts combined in a per-thread buffer, flushed to the map one submap at a time
+    // ----------------------------------------------------------------------------------
+    Map                combined_counts;
+    gtl::combining_map combiner(combined_counts, 4096);
+    auto               combined_time =
+        run([&]() { return combiner.local(); }, [&](std::string&& word, auto& buf) { buf.update(std::move(word), 1); });
 
-    sw.snap();
+    if (combined_counts != word_counts)
+        std::cout << "Error: the two methods give different counts\n";
 
     // print one word used at each frequency
     // -------------------------------------
@@ -93,6 +113,7 @@ int main() {
     for (const auto& [freq, word] : result)
         std::cout << (freq / num_times) << ": " << word << '\n';
 
-    printf("\n\nphmap time: %10.2fs\n", sw.start_to_snap() / 1000);
+    printf("\n\nphmap time, lazy_emplace_l:  %10.2fs\n", locked_time);
+    printf("phmap time, combining_map: %10.2fs\n", combined_time);
     return 0;
 }
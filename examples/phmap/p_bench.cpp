@@ -7,9 +7,16 @@
 // concurrent threads (The map is protected by internal mutexes), but then doing a
 // swap to get rid of the mutexes (and all locking) for accessing the same hash_map
 // in `read` only mode, again concurrently from multiple threads.
+//
+// It then compares, for mixes of lookups and updates, the locking submaps
+// (std::mutex and std::shared_mutex) with parallel_flat_hash_map_seqlock, whose
+// lookups don't take any lock, and the bulk load of a map by concurrent
+// insertions with parallel_insert(), which partitions the keys by submap.
 // --------------------------------------------------------------------------------
 #include <random>
+#include <cstdio>
 #include <iostream>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include "gtl/phmap.hpp"
@@ -102,6 +109,80 @@ using pmap_nullmutex = gtl::parallel_flat_hash_map<uint64_t,
                                                    gtl::NullMutex>;
 
 
+template<int n>
+using pmap_shared_mutex = gtl::parallel_flat_hash_map<uint64_t,
+                                                      uint64_t,
+                                                      std::hash<uint64_t>,
+                                                      std::equal_to<uint64_t>,
+                                                      std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                                      n,
+                                                      std::shared_mutex>;
+
+template<int n>
+using pmap_seqlock = gtl::parallel_flat_hash_map_seqlock<uint64_t,
+                                                         uint64_t,
+                                                         std::hash<uint64_t>,
+                                                         std::equal_to<uint64_t>,
+                                                         gtl::retaining_allocator<std::pair<const uint64_t, uint64_t>>,
+                                                         n>;
+
+// `num_ops` operations over the keys, of which `read_pct`% are lookups and the
+// others updates, spread over `num_threads` threads. Prints Mops/s.
+template<typename Map>
+void read_write_mix(const std::vector<uint64_t>& keys, uint64_t num_ops, int read_pct, int num_threads) {
+    Map map;
+    for (uint64_t i = 0; i < keys.size(); i++)
+        map.emplace(keys[i], i);
+
+    std::atomic<uint64_t> found{ 0 };
+    timer                 stopwatch;
+    threadpool            pool(num_threads);
+
+    stopwatch.start();
+    pool.parallel_for(num_threads, [&](uint64_t tid) {
+        uint64_t x = tid * 0x9E3779B97F4A7C15ULL + 1, cnt = 0;
+        for (uint64_t i = 0; i < num_ops / num_threads; i++) {
+            x ^= x << 13; // xorshift
+            x ^= x >> 7;
+            x ^= x << 17;
+            uint64_t key = keys[x % keys.size()];
+            if ((int)(x >> 57) * 100 < read_pct * 128)
+                cnt += map.if_contains(key, [&](const auto& v) { cnt += v.second & 1; });
+            else
+                map.insert_or_assign(key, i);
+        }
+        found += cnt;
+    });
+    stopwatch.stop();
+    printf(" %10.1f", num_ops / stopwatch.elapsed() / 1e6);
+    if (found == 42)
+        std::cout << ' ';
+}
+
+// Loads `keys` into an empty map from `num_threads` threads, either with each
+// thread inserting a slice of the keys, or with parallel_insert(). Prints ms.
+template<typename Map>
+void bulk_load(const std::vector<std::pair<uint64_t, uint64_t>>& keys, int num_threads) {
+    timer stopwatch;
+    {
+        Map        map;
+        threadpool pool(num_threads);
+        stopwatch.start();
+        pool.parallel_for(keys.size(), [&](uint64_t i) { map.insert(keys[i]); });
+        stopwatch.stop();
+        printf(" %12.1f", stopwatch.elapsed() * 1000);
+    }
+    {
+        Map map;
+        stopwatch.start();
+        map.parallel_insert(keys, (size_t)num_threads);
+        stopwatch.stop();
+        printf(" %16.1f", stopwatch.elapsed() * 1000);
+        if (map.size() > keys.size())
+            printf("error!");
+    }
+}
+
 template<typename Map, typename Map_nomutex>
 void renumber(const std::vector<uint64_t>& vertex_ids, std::vector<std::array<uint64_t, 4>> elements, int num_threads) {
     bool supports_parallel_insertion = !std::is_same<Map, std::unordered_map<uint64_t, uint64_t>>::value;
@@ -177,4 +258,30 @@ int main() {
 
     std::cout << "pmap6, 32 threads: ";
     renumber<pmap<6>, pmap_nullmutex<6>>(vertex_ids, elements, 32);
+
+    int num_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    vertex_ids.resize(1000000);
+    printf("\nlookups and updates of 1M keys, %d threads, Mops/s\n\n", num_threads);
+    printf("%-12s %10s %10s %10s\n", "read ratio", "mutex", "shared", "seqlock");
+    for (int read_pct : { 50, 90, 98, 100 }) {
+        constexpr uint64_t num_ops = 20000000;
+        printf("%10d%% ", read_pct);
+        read_write_mix<pmap<6>>(vertex_ids, num_ops, read_pct, num_threads);
+        read_write_mix<pmap_shared_mutex<6>>(vertex_ids, num_ops, read_pct, num_threads);
+        read_write_mix<pmap_seqlock<6>>(vertex_ids, num_ops, read_pct, num_threads);
+        printf("\n");
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> kv(nvertices);
+    for (uint64_t i = 0; i < nvertices; i++)
+        kv[i] = { vertex_id_dist(gen), i };
+    printf("\nbulk load of %zu keys, ms\n\n", kv.size());
+    printf("%-8s %-6s %12s %16s\n", "threads", "map", "insert", "parallel_insert");
+    for (int t = 1; t <= num_threads; t *= 2) {
+        printf("%-8d %-6s", t, "pmap4");
+        bulk_load<pmap<4>>(kv, t);
+        printf("\n%-8d %-6s", t, "pmap6");
+        bulk_load<pmap<6>>(kv, t);
+        printf("\n");
+    }
 }
\ No newline at end of file
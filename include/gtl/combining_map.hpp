@@ -0,0 +1,210 @@
+#ifndef gtl_combining_map_hpp_
+#define gtl_combining_map_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <gtl/phmap.hpp>
+#include <utility>
+#include <vector>
+
+namespace gtl {
+
+// ------------------------------------------------------------------------------
+// default merge functor of combining_map: `dst += src`
+// ------------------------------------------------------------------------------
+struct plus_assign {
+    template<class T, class U>
+    void operator()(T& dst, U&& src) const {
+        dst += std::forward<U>(src);
+    }
+};
+
+// ------------------------------------------------------------------------------
+// Write-combining front end for a parallel_flat_hash_map (or any parallel map
+// with an internal mutex) which is updated concurrently, such as a map of
+// counters.
+//
+// Each thread gets its own `local_buffer`, a small flat_hash_map in which the
+// updates of the same key are combined with `Merge(mapped_type& dst, U&& src)`
+// without any locking. When the buffer holds `capacity` keys, or when
+// `flush()` is called, the buffered values are merged into the parallel map,
+// taking each submap's lock only once for all the keys falling into it.
+// With skewed keys, most updates are combined locally, and the parallel map
+// sees a few lock acquisitions per flush instead of one per update.
+//
+// The parallel map only contains the updates which have been flushed: the
+// buffer's destructor flushes it, so the totals are complete once all the
+// threads are done.
+//
+//   gtl::parallel_flat_hash_map_m<std::string, size_t> counts;
+//   gtl::combining_map combiner(counts);
+//
+//   // in each thread
+//   auto buf = combiner.local();
+//   for (auto& word : words)
+//       buf.update(word, 1);
+//   buf.flush();
+//
+// see example: examples/phmap/mt_word_counter.cpp
+// ------------------------------------------------------------------------------
+template<class Map, class Merge = plus_assign>
+class combining_map {
+public:
+    using map_type    = Map;
+    using key_type    = typename Map::key_type;
+    using mapped_type = typename Map::mapped_type;
+    using hasher      = typename Map::hasher;
+    using key_equal   = typename Map::key_equal;
+
+    explicit combining_map(Map& map, size_t capacity = 1024, Merge merge = Merge())
+        : map_(map)
+        , capacity_((std::max)(capacity, size_t(1)))
+        , merge_(std::move(merge)) {}
+
+    // -----------------------------------------------------------------------
+    // Buffers the updates of one thread. It is not thread safe: each thread
+    // needs its own local_buffer.
+    // -----------------------------------------------------------------------
+    class local_buffer {
+    public:
+        explicit local_buffer(combining_map& cm)
+            : cm_(&cm)
+            , buf_(0, cm.map_.hash_function(), cm.map_.key_eq()) {
+            buf_.reserve(cm.capacity_);
+        }
+
+        local_buffer(local_buffer&&) = default;
+        local_buffer& operator=(local_buffer&& o) {
+            if (this != &o) {
+                flush();
+                buf_     = std::move(o.buf_);
+                entries_ = std::move(o.entries_);
+                cm_      = o.cm_;
+            }
+            return *this;
+        }
+
+        local_buffer(const local_buffer&)            = delete;
+        local_buffer& operator=(const local_buffer&) = delete;
+
+        // a destructor must not throw: if the final flush fails, the updates
+        // which were not merged yet are dropped. Call flush() first to see
+        // the error.
+        ~local_buffer() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        // merges `v` into the buffered value for `key`, flushing the buffer
+        // when it is full
+        template<class K, class U>
+        void update(K&& key, U&& v) {
+            // the hash is kept with the value, so that the flush doesn't compute it again
+            size_t hashval  = buf_.hash(key);
+            bool   inserted = false;
+            auto   it       = buf_.lazy_emplace_with_hash(key, hashval, [&](const auto& ctor) {
+                inserted = true;
+                ctor(std::piecewise_construct,
+                     std::forward_as_tuple(std::forward<K>(key)),
+                     std::forward_as_tuple(std::forward<U>(v), hashval));
+            });
+            if (!inserted)
+                cm_->merge_(it->second.first, std::forward<U>(v));
+            else if (buf_.size() >= cm_->capacity_)
+                flush();
+        }
+
+        // merges all the buffered values into the parallel map. If merging
+        // throws, the values already merged are removed from the buffer, and
+        // the others are kept for the next flush.
+        void flush() {
+            if (!buf_.empty()) {
+                cm_->merge_into_map(buf_, entries_);
+                buf_.clear();
+            }
+        }
+
+        size_t size() const { return buf_.size(); }
+
+    private:
+        using buffer_type = gtl::flat_hash_map<key_type, std::pair<mapped_type, size_t>, hasher, key_equal>;
+
+        combining_map*                                  cm_;
+        buffer_type                                     buf_;
+        std::vector<typename buffer_type::value_type*> entries_;
+    };
+
+    local_buffer local() { return local_buffer(*this); }
+
+    Map&       map() { return map_; }
+    const Map& map() const { return map_; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    template<class Buffer, class Entries>
+    void merge_into_map(Buffer& buf, Entries& entries) {
+        // group the keys by submap (counting sort), so that each submap is
+        // locked only once
+        constexpr size_t num_submaps = Map::subcnt();
+        size_t           start[num_submaps + 1] = {};
+        for (auto& v : buf)
+            ++start[Map::subidx(v.second.second) + 1];
+        for (size_t i = 0; i < num_submaps; ++i)
+            start[i + 1] += start[i];
+
+        entries.resize(buf.size());
+        size_t pos[num_submaps];
+        std::copy(start, start + num_submaps, pos);
+        for (auto& v : buf)
+            entries[pos[Map::subidx(v.second.second)]++] = &v;
+
+        size_t merged = 0; // entries[0, merged) are in the map
+        try {
+            for (size_t idx = 0; idx < num_submaps; ++idx) {
+                size_t first = start[idx], last = start[idx + 1];
+                if (first == last)
+                    continue;
+                map_.with_submap_m(idx, [&](auto& set) {
+                    for (size_t i = first; i < last; ++i)
+                        set.prefetch_hash(entries[i]->second.second);
+                    for (size_t i = first; i < last; ++i) {
+                        auto& [key, val] = *entries[i];
+                        auto it          = set.find(key, val.second);
+                        if (it != set.end())
+                            merge_(it->second, std::move(val.first));
+                        else
+                            set.emplace_with_hash(val.second, key, std::move(val.first));
+                        ++merged;
+                    }
+                });
+            }
+        } catch (...) {
+            // erasing doesn't move the other values, so the pointers stay valid
+            for (size_t i = 0; i < merged; ++i)
+                buf.erase(buf.find(entries[i]->first, entries[i]->second.second));
+            throw;
+        }
+    }
+
+    Map&   map_;
+    size_t capacity_;
+    Merge  merge_;
+};
+
+} // namespace gtl
+
+#endif // gtl_combining_map_hpp_
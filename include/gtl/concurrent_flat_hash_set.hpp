@@ -0,0 +1,351 @@
+#ifndef gtl_concurrent_flat_hash_set_hpp_
+#define gtl_concurrent_flat_hash_set_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gtl/phmap.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace gtl {
+
+// ------------------------------------------------------------------------------
+// A fixed capacity hash set of trivially copyable keys, such as the `uint64_t`
+// ids of a crawler's dedup set or a graph traversal's visited set, where
+// `insert()` and `contains()` are lock-free: no thread ever waits for another
+// one to finish its insertion.
+//
+// The table uses the control bytes and `Group` matching of `raw_hash_set`,
+// with groups aligned on `Group::kWidth` bytes. An insertion claims the first
+// empty slot of its probe sequence with a compare-exchange of its control
+// byte from `kEmpty` to `kBusy`, writes the key, and publishes it by setting
+// the byte to the key's H2. Lookups load the control bytes with acquire
+// semantics, so a key is only read once it has been published.
+//
+// Two threads inserting the same key may both publish it. After publishing,
+// an insertion rescans the slots before its own in the probe sequence, and
+// the lower slot wins: the loser turns its own slot into a `kDeleted`
+// tombstone and returns false. A slot of the prefix which is claimed but not
+// yet published is marked `kPoisoned` instead of being waited for. The
+// publication of a poisoned slot fails, and that insertion then returns false
+// if the key is published anywhere else in its probe sequence.
+//
+// * There is no erase: the slots only go from empty to busy to full, or to a
+//   tombstone when a concurrent insertion of the same key wins.
+// * The capacity is set at construction, for at most `max_elements` keys. The
+//   table never grows, and `insert()` throws `std::length_error` when every
+//   slot of the table is taken. Keep it under 7/8 full for short probes.
+// * `size()` counts the full slots, in O(capacity). While two insertions of
+//   the same key are resolving, `for_each()` and `size()` may see both.
+// * `clear()`, assignment and destruction must not run concurrently with
+//   anything else.
+//
+//   gtl::concurrent_flat_hash_set<uint64_t> visited(num_vertices);
+//   // in any thread
+//   if (visited.insert(v))
+//       process(v);
+// ------------------------------------------------------------------------------
+template<class K,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<K>>
+class concurrent_flat_hash_set {
+    static_assert(std::is_trivially_copyable_v<K>, "concurrent_flat_hash_set requires trivially copyable keys");
+
+    using ctrl_t = gtl::priv::ctrl_t;
+    using Group  = gtl::priv::Group;
+    using word_t = uint64_t; // the control bytes are accessed a word at a time
+
+    static constexpr size_t kWidth        = Group::kWidth;
+    static constexpr size_t kWordsInGroup = (kWidth + sizeof(word_t) - 1) / sizeof(word_t);
+    static constexpr ctrl_t kBusy         = gtl::priv::kSentinel; // claimed, key not yet published
+    static constexpr ctrl_t kPoisoned     = -3;                   // busy, and passed over by a later insertion
+
+    static_assert(kWidth % sizeof(word_t) == 0, "a group must hold whole words");
+
+public:
+    using key_type       = K;
+    using value_type     = K;
+    using size_type      = size_t;
+    using hasher         = Hash;
+    using key_equal      = Eq;
+    using allocator_type = Alloc;
+
+    explicit concurrent_flat_hash_set(size_t max_elements, const hasher& hash = hasher(),
+                                      const key_equal& eq = key_equal(), const Alloc& alloc = Alloc())
+        : hash_(hash)
+        , eq_(eq)
+        , num_groups_(num_groups_for(max_elements))
+        , ctrl_(num_groups_ * kWordsInGroup, word_alloc(alloc))
+        , slots_(num_groups_ * kWidth, alloc) {
+        reset_ctrl();
+    }
+
+    concurrent_flat_hash_set(const concurrent_flat_hash_set&)            = delete;
+    concurrent_flat_hash_set& operator=(const concurrent_flat_hash_set&) = delete;
+
+    // Returns true if `key` was inserted, false if it was already present.
+    // -----------------------------------------------------------------------
+    bool insert(const key_type& key) {
+        const size_t hashval = hash(key);
+        const ctrl_t h2      = static_cast<ctrl_t>(gtl::priv::H2(hashval));
+        size_t       g       = first_group(hashval);
+        for (size_t step = 1;; ++step) {
+            ctrl_t bytes[kWidth];
+            for (;;) {
+                load_group(g, bytes);
+                if (find_in_group(g, bytes, h2, key))
+                    return false;
+                auto empty = match_empty(bytes);
+                if (!empty)
+                    break; // full group, probe the next one
+                // the empty slots of the snapshot are tried in order, so that
+                // every slot before the one we claim is taken when we rescan it
+                for (uint32_t j : empty) {
+                    size_t i = g * kWidth + j;
+                    if (cas_byte(i, gtl::priv::kEmpty, kBusy) == gtl::priv::kEmpty) {
+                        slots_[i] = key;
+                        return commit(i, hashval, h2, key);
+                    }
+                }
+                // every empty slot was claimed by other insertions, reload the group
+            }
+            if (step == num_groups_)
+                ThrowStdLengthError("concurrent_flat_hash_set: the table is full");
+            g = (g + step) & (num_groups_ - 1);
+        }
+    }
+
+    // Returns true if `key` was inserted before this call, or by a
+    // concurrent insert() which has published it.
+    // -----------------------------------------------------------------------
+    bool contains(const key_type& key) const {
+        const size_t hashval = hash(key);
+        const ctrl_t h2      = static_cast<ctrl_t>(gtl::priv::H2(hashval));
+        size_t       g       = first_group(hashval);
+        for (size_t step = 1; step <= num_groups_; ++step) {
+            ctrl_t bytes[kWidth];
+            load_group(g, bytes);
+            if (find_in_group(g, bytes, h2, key))
+                return true;
+            if (match_empty(bytes))
+                return false;
+            g = (g + step) & (num_groups_ - 1);
+        }
+        return false;
+    }
+
+    size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+    // calls `f(key)` for each published key
+    template<class F>
+    void for_each(F&& f) const {
+        for (size_t g = 0; g < num_groups_; ++g) {
+            ctrl_t bytes[kWidth];
+            load_group(g, bytes);
+            for (size_t j = 0; j < kWidth; ++j)
+                if (gtl::priv::IsFull(bytes[j]))
+                    f(std::as_const(slots_[g * kWidth + j]));
+        }
+    }
+
+    size_type size() const {
+        size_type sz = 0;
+        for_each([&](const key_type&) { ++sz; });
+        return sz;
+    }
+
+    bool      empty() const { return size() == 0; }
+    size_type capacity() const { return num_groups_ * kWidth; }
+
+    void clear() { reset_ctrl(); }
+
+    template<class K2>
+    size_t hash(const K2& key) const {
+#ifdef GTL_DISABLE_MIX
+        return hash_(key);
+#else
+        return phmap_mix<sizeof(size_t)>()(static_cast<size_t>(hash_(key)));
+#endif
+    }
+
+    hasher         hash_function() const { return hash_; }
+    key_equal      key_eq() const { return eq_; }
+    allocator_type get_allocator() const { return slots_.get_allocator(); }
+
+private:
+    using word_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<word_t>>;
+
+    // a power of 2 number of groups, for a load of at most 7/8
+    static size_t num_groups_for(size_t max_elements) {
+        size_t slots  = max_elements + max_elements / 7 + 1;
+        size_t groups = 1;
+        while (groups * kWidth < slots)
+            groups *= 2;
+        return groups;
+    }
+
+    size_t first_group(size_t hashval) const { return gtl::priv::H1(hashval, nullptr) & (num_groups_ - 1); }
+
+    void reset_ctrl() {
+        word_t empty;
+        ctrl_t bytes[sizeof(word_t)];
+        std::memset(bytes, gtl::priv::kEmpty, sizeof(bytes));
+        std::memcpy(&empty, bytes, sizeof(word_t));
+        for (auto& w : ctrl_)
+            w.store(empty, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void load_group(size_t g, ctrl_t* bytes, std::memory_order order = std::memory_order_acquire) const {
+        for (size_t w = 0; w < kWordsInGroup; ++w) {
+            word_t v = ctrl_[g * kWordsInGroup + w].load(order);
+            std::memcpy(bytes + w * sizeof(word_t), &v, sizeof(word_t));
+        }
+    }
+
+    // true if a published slot of group `g` holds `key`
+    bool find_in_group(size_t g, const ctrl_t* bytes, ctrl_t h2, const key_type& key) const {
+        for (uint32_t j : Group{ bytes }.Match(static_cast<gtl::priv::h2_t>(h2)))
+            if (eq_(slots_[g * kWidth + j], key))
+                return true;
+        return false;
+    }
+
+    // `kBusy` and `kPoisoned` are neither empty nor full, but the portable
+    // `Group::MatchEmpty()` is only exact for the control bytes of
+    // `raw_hash_set`, so match `kEmpty` itself.
+    static auto match_empty(const ctrl_t* bytes) {
+        return Group{ bytes }.Match(static_cast<gtl::priv::h2_t>(gtl::priv::kEmpty));
+    }
+
+    // publishes the key written to slot `i`, and returns false if it must
+    // give way to another insertion of the same key
+    bool commit(size_t i, size_t hashval, ctrl_t h2, const key_type& key) {
+        while (cas_byte(i, kBusy, h2) != kBusy) {
+            // a later insertion went past our slot without knowing its key,
+            // and may have published the same key
+            cas_byte(i, kPoisoned, kBusy);
+            if (find_other(i, hashval, h2, key)) {
+                retire(i);
+                return false;
+            }
+        }
+        if (in_prefix(i, hashval, h2, key)) {
+            retire(i);
+            return false;
+        }
+        return true;
+    }
+
+    // true if `key` is published in a slot other than `i`, anywhere in its
+    // probe sequence
+    bool find_other(size_t i, size_t hashval, ctrl_t h2, const key_type& key) const {
+        size_t g = first_group(hashval);
+        for (size_t step = 1; step <= num_groups_; ++step) {
+            ctrl_t bytes[kWidth];
+            load_group(g, bytes, std::memory_order_seq_cst);
+            for (uint32_t j : Group{ bytes }.Match(static_cast<gtl::priv::h2_t>(h2)))
+                if (g * kWidth + j != i && eq_(slots_[g * kWidth + j], key))
+                    return true;
+            if (match_empty(bytes))
+                return false;
+            g = (g + step) & (num_groups_ - 1);
+        }
+        return false;
+    }
+
+    // true if `key` is published in a slot before `i` in its probe sequence.
+    // The slots before `i` which are not published yet are poisoned, so that
+    // their insertion checks for our key when it publishes.
+    bool in_prefix(size_t i, size_t hashval, ctrl_t h2, const key_type& key) {
+        size_t g = first_group(hashval);
+        for (size_t step = 1;; ++step) {
+            const bool last = g == i / kWidth;
+            for (size_t k = g * kWidth, end = last ? i : k + kWidth; k < end; ++k)
+                if (holds_key(k, h2, key))
+                    return true;
+            if (last)
+                return false;
+            g = (g + step) & (num_groups_ - 1);
+        }
+    }
+
+    bool holds_key(size_t k, ctrl_t h2, const key_type& key) {
+        auto&  word = word_of(k);
+        word_t cur  = word.load();
+        for (;;) {
+            ctrl_t c = byte_of(cur, k);
+            if (gtl::priv::IsFull(c))
+                return c == h2 && eq_(slots_[k], key);
+            if (c != kBusy && c != kPoisoned)
+                return false; // a tombstone
+            if (word.compare_exchange_weak(cur, cur ^ byte_mask(k, c ^ kPoisoned)))
+                return false;
+        }
+    }
+
+    // the slot of an insertion which gave way becomes a tombstone
+    void retire(size_t i) {
+        auto&  word = word_of(i);
+        word_t cur  = word.load();
+        while (!word.compare_exchange_weak(cur, cur ^ byte_mask(i, byte_of(cur, i) ^ gtl::priv::kDeleted)))
+            ;
+    }
+
+    // the word holding control byte `i`, and a mask with `b` at its position
+    std::atomic<word_t>& word_of(size_t i) { return ctrl_[i / sizeof(word_t)]; }
+
+    static word_t byte_mask(size_t i, ctrl_t b) {
+        ctrl_t bytes[sizeof(word_t)] = {};
+        bytes[i % sizeof(word_t)]    = b;
+        word_t w;
+        std::memcpy(&w, bytes, sizeof(word_t));
+        return w;
+    }
+
+    static ctrl_t byte_of(word_t w, size_t i) {
+        ctrl_t bytes[sizeof(word_t)];
+        std::memcpy(bytes, &w, sizeof(word_t));
+        return bytes[i % sizeof(word_t)];
+    }
+
+    // sets control byte `i` from `from` to `to`, and returns the byte found.
+    // The insertions access the control bytes with sequentially consistent
+    // operations, so that of two insertions of the same key which each
+    // publish and then rescan, at least one sees the other.
+    ctrl_t cas_byte(size_t i, ctrl_t from, ctrl_t to) {
+        auto&  word = word_of(i);
+        word_t cur  = word.load();
+        for (;;) {
+            ctrl_t c = byte_of(cur, i);
+            if (c != from)
+                return c;
+            if (word.compare_exchange_weak(cur, cur ^ byte_mask(i, from ^ to)))
+                return from;
+        }
+    }
+
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS hasher    hash_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS key_equal eq_;
+    size_t                                    num_groups_;
+    std::vector<std::atomic<word_t>, word_alloc> ctrl_;
+    std::vector<K, Alloc>                        slots_;
+};
+
+} // namespace gtl
+
+#endif // gtl_concurrent_flat_hash_set_hpp_
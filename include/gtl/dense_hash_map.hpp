@@ -0,0 +1,527 @@
+#ifndef gtl_dense_hash_map_hpp_
+#define gtl_dense_hash_map_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <gtl/phmap.hpp>
+#include <gtl/vector.hpp>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gtl {
+
+// ------------------------------------------------------------------------------
+// A hash map which stores its elements contiguously, in insertion order, in a
+// `gtl::vector<std::pair<K, V>>`. The hash table itself is a
+// `gtl::flat_hash_set` of 32 bit indices into that vector, so lookups use the
+// same SIMD control byte matching as `gtl::flat_hash_map`, while:
+//
+// * iteration is a linear scan of the live elements only, whatever the load
+//   of the table. `values()` returns them as a `std::span`.
+// * erasing an element moves the last element into its place (swap and pop),
+//   so the order is the insertion order only until the first erase.
+// * `phmap_dump()` writes the elements with a single write, and `phmap_load()`
+//   rebuilds the index from them.
+// * an insertion or an erase invalidates the iterators and references.
+//
+// The elements are `std::pair<K, V>` rather than `std::pair<const K, V>`, as
+// they are moved around by erase: the keys must not be modified through the
+// iterators. At most 2^32 - 1 elements can be stored.
+//
+// The vector and the index are allocated on the first insertion. A moved-from
+// dense_hash_map is empty and can be used again, and the move constructor does
+// not allocate.
+//
+//   gtl::dense_hash_map<std::string, int> m;
+//   m.try_emplace("a", 1);
+//   for (auto& [k, v] : m.values()) ...
+// ------------------------------------------------------------------------------
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<std::pair<K, V>>>
+class dense_hash_map {
+public:
+    using key_type        = K;
+    using mapped_type     = V;
+    using value_type      = std::pair<K, V>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using allocator_type  = Alloc;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using values_type     = gtl::vector<value_type, Alloc>;
+    using iterator        = typename values_type::iterator;
+    using const_iterator  = typename values_type::const_iterator;
+
+    template<class T>
+    using key_arg = typename KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>::template type<T, K>;
+
+    explicit dense_hash_map(size_t bucket_count  = 0,
+                            const hasher&    hash  = hasher(),
+                            const key_equal& eq    = key_equal(),
+                            const Alloc&     alloc = Alloc())
+        : hash_(hash)
+        , eq_(eq)
+        , alloc_(alloc) {
+        if (bucket_count)
+            reserve(bucket_count);
+    }
+
+    template<class InputIt>
+    dense_hash_map(InputIt first, InputIt last, size_t bucket_count = 0, const hasher& hash = hasher(),
+                   const key_equal& eq = key_equal(), const Alloc& alloc = Alloc())
+        : dense_hash_map(bucket_count, hash, eq, alloc) {
+        insert(first, last);
+    }
+
+    dense_hash_map(std::initializer_list<value_type> init, size_t bucket_count = 0, const hasher& hash = hasher(),
+                   const key_equal& eq = key_equal(), const Alloc& alloc = Alloc())
+        : dense_hash_map(init.begin(), init.end(), bucket_count, hash, eq, alloc) {}
+
+    dense_hash_map(const dense_hash_map& o)
+        : hash_(o.hash_)
+        , eq_(o.eq_)
+        , alloc_(o.alloc_) {
+        if (!o.empty()) {
+            core_ref().values = o.core_->values;
+            rebuild_index();
+        }
+    }
+
+    // leaves `o` without a core, as the index functors point to the core
+    dense_hash_map(dense_hash_map&& o) noexcept(std::is_nothrow_copy_constructible_v<hasher> &&
+                                                std::is_nothrow_copy_constructible_v<key_equal> &&
+                                                std::is_nothrow_copy_constructible_v<Alloc>)
+        : hash_(o.hash_)
+        , eq_(o.eq_)
+        , alloc_(o.alloc_)
+        , core_(std::move(o.core_)) {}
+
+    dense_hash_map& operator=(const dense_hash_map& o) {
+        if (this != &o)
+            *this = dense_hash_map(o);
+        return *this;
+    }
+
+    dense_hash_map& operator=(dense_hash_map&& o) noexcept(std::is_nothrow_copy_assignable_v<hasher> &&
+                                                           std::is_nothrow_copy_assignable_v<key_equal> &&
+                                                           std::is_nothrow_copy_assignable_v<Alloc>) {
+        if (this != &o) {
+            hash_  = o.hash_;
+            eq_    = o.eq_;
+            alloc_ = o.alloc_;
+            core_  = std::move(o.core_);
+        }
+        return *this;
+    }
+
+    // ------------------------------ iterators ------------------------------
+    iterator       begin() noexcept { return core_ ? core_->values.begin() : nullptr; }
+    iterator       end() noexcept { return core_ ? core_->values.end() : nullptr; }
+    const_iterator begin() const noexcept { return core_ ? core_->values.begin() : nullptr; }
+    const_iterator end() const noexcept { return core_ ? core_->values.end() : nullptr; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // the elements, contiguous in memory
+    std::span<value_type>       values() noexcept { return { begin(), size() }; }
+    std::span<const value_type> values() const noexcept { return { begin(), size() }; }
+
+    // ------------------------------ capacity -------------------------------
+    bool      empty() const noexcept { return size() == 0; }
+    size_type size() const noexcept { return core_ ? core_->values.size() : 0; }
+    size_type max_size() const noexcept { return std::numeric_limits<uint32_t>::max(); }
+
+    size_t bucket_count() const { return core_ ? core_->index.bucket_count() : 0; }
+    size_t capacity() const { return core_ ? core_->index.capacity() : 0; }
+    float  load_factor() const { return core_ ? core_->index.load_factor() : 0.0f; }
+
+    void clear() {
+        if (core_) {
+            core_->index.clear();
+            core_->values.clear();
+        }
+    }
+
+    void reserve(size_t n) {
+        core_ref().values.reserve(n);
+        core_->index.reserve(n);
+    }
+
+    void rehash(size_t n) { core_ref().index.rehash(n); }
+
+    // ------------------------------- lookups -------------------------------
+    template<class K2 = key_type>
+    iterator find(const key_arg<K2>& key) {
+        size_t i = find_index<key_arg<K2>>(key, hash(key));
+        return i == npos ? end() : begin() + i;
+    }
+
+    template<class K2 = key_type>
+    const_iterator find(const key_arg<K2>& key) const {
+        return const_cast<dense_hash_map*>(this)->template find<K2>(key);
+    }
+
+    template<class K2 = key_type>
+    bool contains(const key_arg<K2>& key) const {
+        return find_index<key_arg<K2>>(key, hash(key)) != npos;
+    }
+
+    template<class K2 = key_type>
+    size_type count(const key_arg<K2>& key) const {
+        return contains<K2>(key) ? 1 : 0;
+    }
+
+    template<class K2 = key_type>
+    mapped_type& at(const key_arg<K2>& key) {
+        auto it = find<K2>(key);
+        if (it == end())
+            ThrowStdOutOfRange("dense_hash_map at(): lookup non-existent key");
+        return it->second;
+    }
+
+    template<class K2 = key_type>
+    const mapped_type& at(const key_arg<K2>& key) const {
+        return const_cast<dense_hash_map*>(this)->template at<K2>(key);
+    }
+
+    // ----------------------------- insertions ------------------------------
+    // The index entry is added first, in the same probe as the lookup, and
+    // erased again if constructing the element throws.
+    template<class K2 = key_type, class... Args>
+    std::pair<iterator, bool> try_emplace(K2&& key, Args&&... args) {
+        check_size();
+        auto& c  = core_ref();
+        auto  it = find_or_add_index<std::remove_cvref_t<K2>>(key, hash(key), size());
+        if (it->idx != size())
+            return { begin() + it->idx, false };
+        try {
+            c.values.emplace_back(std::piecewise_construct,
+                                  std::forward_as_tuple(std::forward<K2>(key)),
+                                  std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            c.index.erase(it);
+            throw;
+        }
+        return { end() - 1, true };
+    }
+
+    template<class K2 = key_type, class V2>
+    std::pair<iterator, bool> insert_or_assign(K2&& key, V2&& v) {
+        auto res = try_emplace(std::forward<K2>(key), std::forward<V2>(v));
+        if (!res.second)
+            res.first->second = std::forward<V2>(v);
+        return res;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type&& v) { return try_emplace(std::move(v.first), std::move(v.second)); }
+
+    template<class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    // The element is constructed before the lookup, and destroyed again if
+    // its key is already present, or if growing the index throws.
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        check_size();
+        auto&           values = core_ref().values;
+        const key_type& key    = values.emplace_back(std::forward<Args>(args)...).first;
+        size_t          i;
+        try {
+            i = find_or_add_index<key_type>(key, hash(key), values.size() - 1)->idx;
+        } catch (...) {
+            values.pop_back();
+            throw;
+        }
+        if (i != size() - 1) {
+            values.pop_back();
+            return { begin() + i, false };
+        }
+        return { end() - 1, true };
+    }
+
+    template<class K2 = key_type>
+    mapped_type& operator[](K2&& key) {
+        return try_emplace(std::forward<K2>(key)).first->second;
+    }
+
+    // ------------------------------- erasure -------------------------------
+    // Moves the last element into the erased one's place, and returns an
+    // iterator to it (or `end()`), so that
+    //    for (auto it = m.begin(); it != m.end();)
+    //        it = pred(*it) ? m.erase(it) : std::next(it);
+    // visits every element.
+    // -----------------------------------------------------------------------
+    iterator erase(const_iterator pos) {
+        size_t i = static_cast<size_t>(pos - cbegin());
+        core_->index.erase(find_slot(i));
+        return erase_value(i);
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    template<class K2 = key_type>
+    size_type erase(const key_arg<K2>& key) {
+        if (!core_)
+            return 0;
+        auto& index = core_->index;
+        auto  it    = index.template find<key_arg<K2>>(key, hash(key));
+        if (it == index.end())
+            return 0;
+        size_t i = it->idx;
+        index.erase(it);
+        erase_value(i);
+        return 1;
+    }
+
+    template<class Pred>
+    friend size_type erase_if(dense_hash_map& m, Pred pred) {
+        size_type num_erased = 0;
+        for (auto it = m.begin(); it != m.end();) {
+            if (pred(std::as_const(*it))) {
+                it = m.erase(it);
+                ++num_erased;
+            } else {
+                ++it;
+            }
+        }
+        return num_erased;
+    }
+
+    void swap(dense_hash_map& o) noexcept {
+        using std::swap;
+        swap(hash_, o.hash_);
+        swap(eq_, o.eq_);
+        swap(alloc_, o.alloc_);
+        core_.swap(o.core_);
+    }
+    friend void swap(dense_hash_map& a, dense_hash_map& b) noexcept { a.swap(b); }
+
+    friend bool operator==(const dense_hash_map& a, const dense_hash_map& b) {
+        if (a.size() != b.size())
+            return false;
+        for (const auto& v : a) {
+            auto it = b.find(v.first);
+            if (it == b.end() || !(it->second == v.second))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const dense_hash_map& a, const dense_hash_map& b) { return !(a == b); }
+
+    // -------------------------------- misc ---------------------------------
+    // the hash of the index, which mixes the user hash as raw_hash_set does
+    template<class K2>
+    size_t hash(const K2& key) const {
+#ifdef GTL_DISABLE_MIX
+        return hash_(key);
+#else
+        return phmap_mix<sizeof(size_t)>()(static_cast<size_t>(hash_(key)));
+#endif
+    }
+
+    hasher    hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+    Alloc     get_allocator() const { return alloc_; }
+
+    // The elements are written with a single write when `std::pair<K, V>` has
+    // no padding, and key by value otherwise, so that no uninitialized byte
+    // is written. The index is rebuilt when they are loaded: the hashes may
+    // differ from one run to the next.
+    // -----------------------------------------------------------------------
+    template<typename OutputArchive>
+    bool phmap_dump(OutputArchive& ar) const {
+        static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                      "value_type should be trivially copyable");
+        size_t sz = size();
+        ar.saveBinary(&sz, sizeof(size_t));
+        if constexpr (kPackedPair) {
+            if (sz)
+                ar.saveBinary(begin(), sizeof(value_type) * sz);
+        } else {
+            for (const auto& v : *this) {
+                ar.saveBinary(&v.first, sizeof(K));
+                ar.saveBinary(&v.second, sizeof(V));
+            }
+        }
+        return true;
+    }
+
+    template<typename InputArchive>
+    bool phmap_load(InputArchive& ar) {
+        static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                      "value_type should be trivially copyable");
+        clear();
+        size_t sz = 0;
+        ar.loadBinary(&sz, sizeof(size_t));
+        if (sz > max_size())
+            return false;
+        auto& values = core_ref().values;
+        values.resize(sz);
+        if constexpr (kPackedPair) {
+            if (sz)
+                ar.loadBinary(values.data(), sizeof(value_type) * sz);
+        } else {
+            for (auto& v : values) {
+                ar.loadBinary(&v.first, sizeof(K));
+                ar.loadBinary(&v.second, sizeof(V));
+            }
+        }
+        rebuild_index();
+        return true;
+    }
+
+private:
+    // the elements of the index, wrapped so that they are never mistaken for
+    // keys by the transparent hash and equality below
+    struct dense_index {
+        uint32_t idx;
+    };
+
+    struct core;
+
+    // hash and equality of the index: an index stands for the key of the
+    // element it points to
+    struct index_hash {
+        using is_transparent = void;
+
+        size_t operator()(dense_index i) const { return c->hash(c->values[i.idx].first); }
+
+        template<class K2>
+        size_t operator()(const K2& key) const {
+            return c->hash(key);
+        }
+
+        const core* c;
+    };
+
+    struct index_eq {
+        using is_transparent = void;
+
+        bool operator()(dense_index a, dense_index b) const { return a.idx == b.idx; }
+
+        template<class K2>
+        bool operator()(dense_index a, const K2& key) const {
+            return c->eq(c->values[a.idx].first, key);
+        }
+
+        template<class K2>
+        bool operator()(const K2& key, dense_index a) const {
+            return c->eq(key, c->values[a.idx].first);
+        }
+
+        const core* c;
+    };
+
+    using index_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<dense_index>;
+    using index_type  = gtl::flat_hash_set<dense_index, index_hash, index_eq, index_alloc>;
+
+    // Heap allocated, so that the index functors can point to it whatever
+    // happens to the map.
+    struct core {
+        core(const hasher& h, const key_equal& e, const Alloc& alloc)
+            : hash(h)
+            , eq(e)
+            , values(alloc)
+            , index(0, index_hash{ this }, index_eq{ this }, index_alloc(alloc)) {}
+
+        GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS hasher    hash;
+        GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS key_equal eq;
+        values_type                               values;
+        index_type                                index;
+    };
+
+    static constexpr bool kPackedPair = sizeof(value_type) == sizeof(K) + sizeof(V);
+
+    core& core_ref() {
+        if (!core_)
+            core_ = std::make_unique<core>(hash_, eq_, alloc_);
+        return *core_;
+    }
+
+    static constexpr size_t npos = (size_t)-1;
+
+    // the position of `key` in `values`, or npos
+    template<class K2>
+    size_t find_index(const K2& key, size_t hashval) const {
+        if (!core_)
+            return npos;
+        auto& index = core_->index;
+        auto  it    = index.template find<K2>(key, hashval);
+        return it == index.end() ? npos : it->idx;
+    }
+
+    // the index entry pointing to values[i]
+    auto find_slot(size_t i) {
+        auto it = core_->index.template find<dense_index>(dense_index{ static_cast<uint32_t>(i) });
+        assert(it != core_->index.end());
+        return it;
+    }
+
+    void check_size() const {
+        if (size() >= max_size())
+            ThrowStdLengthError("dense_hash_map: too many elements");
+    }
+
+    // the index entry of `key` if it is present, otherwise a new entry
+    // pointing to `values[n]`, in a single probe
+    template<class K2>
+    auto find_or_add_index(const K2& key, size_t hashval, size_t n) {
+        return core_->index.template lazy_emplace_with_hash<K2>(
+            key, hashval, [&](const auto& ctor) { ctor(dense_index{ static_cast<uint32_t>(n) }); });
+    }
+
+    // removes values[i], whose index entry was already erased
+    iterator erase_value(size_t i) {
+        auto&  values = core_->values;
+        size_t last   = values.size() - 1;
+        if (i != last) {
+            const_cast<dense_index&>(*find_slot(last)).idx = static_cast<uint32_t>(i);
+            values[i]                                      = std::move(values[last]);
+        }
+        values.pop_back();
+        return begin() + i;
+    }
+
+    void rebuild_index() {
+        auto& index = core_->index;
+        index.clear();
+        index.reserve(size());
+        for (size_t i = 0; i < size(); ++i)
+            index.insert_unique_unchecked(dense_index{ static_cast<uint32_t>(i) });
+    }
+
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS hasher    hash_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS key_equal eq_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS Alloc     alloc_;
+    std::unique_ptr<core>                     core_;
+};
+
+} // namespace gtl
+
+#endif // gtl_dense_hash_map_hpp_
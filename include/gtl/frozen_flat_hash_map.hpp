@@ -0,0 +1,487 @@
+#ifndef gtl_frozen_flat_hash_map_hpp_
+#define gtl_frozen_flat_hash_map_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <gtl/phmap.hpp>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gtl {
+
+// ------------------------------------------------------------------------------
+// An immutable hash map, built once from a range or from a `flat_hash_map`,
+// for the tables which are filled at startup and then only read.
+//
+// The slots are split into groups of `Group::kWidth` slots, and every key is
+// found in a single group: a lookup matches the key's H2 against the group's
+// control bytes, compares the matching elements, and is done. The group of a
+// key is chosen at build time, hash-and-displace style: the keys are spread
+// over buckets of about 3 keys, and each bucket stores the one byte seed which
+// sends all its keys to groups with room left. The table is built about 97%
+// full, and grows until every bucket finds a seed.
+//
+// * the memory used is about `1.03 * sizeof(value_type) + 1.4` bytes per
+//   element (slots, control bytes and seeds), and there is no `growth_left`,
+//   tombstone or empty slot check on the lookup path.
+// * nothing can be inserted or erased, and the elements are only accessible
+//   through const references. Duplicate keys in the source range are dropped,
+//   keeping the first one.
+// * at most 2^32 - 1 elements can be stored.
+//
+// A moved-from frozen_flat_hash_map is left with no slots, as an empty table
+// in which every lookup fails.
+//
+//   gtl::flat_hash_map<std::string, int> m = load_config();
+//   const gtl::frozen_flat_hash_map<std::string, int> config(m);
+//   if (auto it = config.find("threads"); it != config.end()) ...
+// ------------------------------------------------------------------------------
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<std::pair<const K, V>>>
+class frozen_flat_hash_map {
+    using ctrl_t      = gtl::priv::ctrl_t;
+    using Group       = gtl::priv::Group;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    template<class T>
+    using rebind_alloc = typename AllocTraits::template rebind_alloc<T>;
+
+    static constexpr size_t kWidth      = Group::kWidth;
+    static constexpr size_t kBucketSize = 3;   // average number of keys sharing a seed
+    static constexpr size_t kMaxLoad    = 248; // in 1/256th, the initial load of the groups
+    static constexpr size_t kAttempts   = 4;   // sets of seeds tried before growing
+
+public:
+    using key_type        = K;
+    using mapped_type     = V;
+    using value_type      = std::pair<const K, V>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using allocator_type  = Alloc;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+
+    template<class T>
+    using key_arg = typename KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>::template type<T, K>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename frozen_flat_hash_map::value_type;
+        using reference         = const value_type&;
+        using pointer           = const value_type*;
+        using difference_type   = ptrdiff_t;
+
+        iterator() = default;
+
+        reference operator*() const { return *slot_; }
+        pointer   operator->() const { return slot_; }
+
+        iterator& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skip_empty_slots();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.ctrl_ == b.ctrl_; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        friend class frozen_flat_hash_map;
+
+        iterator(const ctrl_t* ctrl, const value_type* slot)
+            : ctrl_(ctrl)
+            , slot_(slot) {}
+
+        // stops at the first full slot, or at the sentinel
+        void skip_empty_slots() {
+            while (*ctrl_ == gtl::priv::kEmpty) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const ctrl_t*     ctrl_ = nullptr;
+        const value_type* slot_ = nullptr;
+    };
+
+    using const_iterator = iterator;
+
+    explicit frozen_flat_hash_map(const hasher&    hash  = hasher(),
+                                  const key_equal& eq    = key_equal(),
+                                  const Alloc&     alloc = Alloc())
+        : hash_(hash)
+        , eq_(eq)
+        , alloc_(alloc)
+        , ctrl_(alloc)
+        , seeds_(alloc) {
+        build(items_type(alloc));
+    }
+
+    template<class InputIt>
+    frozen_flat_hash_map(InputIt          first,
+                         InputIt          last,
+                         const hasher&    hash  = hasher(),
+                         const key_equal& eq    = key_equal(),
+                         const Alloc&     alloc = Alloc())
+        : hash_(hash)
+        , eq_(eq)
+        , alloc_(alloc)
+        , ctrl_(alloc)
+        , seeds_(alloc) {
+        items_type items(alloc);
+        for (; first != last; ++first)
+            items.emplace_back(*first);
+        build(std::move(items));
+    }
+
+    frozen_flat_hash_map(std::initializer_list<value_type> init, const hasher& hash = hasher(),
+                         const key_equal& eq = key_equal(), const Alloc& alloc = Alloc())
+        : frozen_flat_hash_map(init.begin(), init.end(), hash, eq, alloc) {}
+
+    template<class A2>
+    explicit frozen_flat_hash_map(const gtl::flat_hash_map<K, V, Hash, Eq, A2>& m, const Alloc& alloc = Alloc())
+        : frozen_flat_hash_map(m.begin(), m.end(), m.hash_function(), m.key_eq(), alloc) {}
+
+    frozen_flat_hash_map(const frozen_flat_hash_map& o)
+        : hash_(o.hash_)
+        , eq_(o.eq_)
+        , alloc_(AllocTraits::select_on_container_copy_construction(o.alloc_))
+        , ctrl_(o.ctrl_)
+        , seeds_(o.seeds_)
+        , seed_base_(o.seed_base_)
+        , capacity_(o.capacity_) {
+        slots_   = AllocTraits::allocate(alloc_, capacity_);
+        size_t i = 0;
+        try {
+            for (; i < capacity_; ++i)
+                if (gtl::priv::IsFull(ctrl_[i]))
+                    AllocTraits::construct(alloc_, slots_ + i, o.slots_[i]);
+        } catch (...) {
+            destroy_slots(i);
+            throw;
+        }
+        size_ = o.size_;
+    }
+
+    frozen_flat_hash_map(frozen_flat_hash_map&& o) noexcept
+        : hash_(std::move(o.hash_))
+        , eq_(std::move(o.eq_))
+        , alloc_(std::move(o.alloc_))
+        , ctrl_(std::move(o.ctrl_))
+        , seeds_(std::move(o.seeds_))
+        , seed_base_(o.seed_base_)
+        , size_(std::exchange(o.size_, 0))
+        , capacity_(std::exchange(o.capacity_, 0))
+        , slots_(std::exchange(o.slots_, nullptr)) {
+        o.ctrl_.clear();
+        o.seeds_.clear();
+    }
+
+    frozen_flat_hash_map& operator=(const frozen_flat_hash_map& o) {
+        if (this != &o)
+            *this = frozen_flat_hash_map(o);
+        return *this;
+    }
+
+    frozen_flat_hash_map& operator=(frozen_flat_hash_map&& o) noexcept {
+        frozen_flat_hash_map tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    ~frozen_flat_hash_map() { destroy_slots(capacity_); }
+
+    // ------------------------------ iterators ------------------------------
+    iterator begin() const {
+        if (!capacity_)
+            return end();
+        iterator it(ctrl_.data(), slots_);
+        it.skip_empty_slots();
+        return it;
+    }
+
+    iterator end() const { return iterator(ctrl_.data() + capacity_, slots_ + capacity_); }
+    iterator cbegin() const { return begin(); }
+    iterator cend() const { return end(); }
+
+    // ------------------------------ capacity -------------------------------
+    bool      empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return std::numeric_limits<uint32_t>::max(); }
+
+    size_t bucket_count() const { return capacity_; }
+    float  load_factor() const { return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f; }
+
+    // ------------------------------- lookups -------------------------------
+    template<class K2 = key_type>
+    iterator find(const key_arg<K2>& key) const {
+        size_t i = find_index<key_arg<K2>>(key, hash(key));
+        return i == npos ? end() : iterator(ctrl_.data() + i, slots_ + i);
+    }
+
+    template<class K2 = key_type>
+    bool contains(const key_arg<K2>& key) const {
+        return find_index<key_arg<K2>>(key, hash(key)) != npos;
+    }
+
+    template<class K2 = key_type>
+    size_type count(const key_arg<K2>& key) const {
+        return contains<K2>(key) ? 1 : 0;
+    }
+
+    template<class K2 = key_type>
+    const mapped_type& at(const key_arg<K2>& key) const {
+        size_t i = find_index<key_arg<K2>>(key, hash(key));
+        if (i == npos)
+            ThrowStdOutOfRange("frozen_flat_hash_map at(): lookup non-existent key");
+        return slots_[i].second;
+    }
+
+    void swap(frozen_flat_hash_map& o) noexcept {
+        using std::swap;
+        swap(hash_, o.hash_);
+        swap(eq_, o.eq_);
+        swap(alloc_, o.alloc_);
+        ctrl_.swap(o.ctrl_);
+        seeds_.swap(o.seeds_);
+        swap(seed_base_, o.seed_base_);
+        swap(size_, o.size_);
+        swap(capacity_, o.capacity_);
+        swap(slots_, o.slots_);
+    }
+
+    friend void swap(frozen_flat_hash_map& a, frozen_flat_hash_map& b) noexcept { a.swap(b); }
+
+    friend bool operator==(const frozen_flat_hash_map& a, const frozen_flat_hash_map& b) {
+        if (a.size() != b.size())
+            return false;
+        for (const auto& v : a) {
+            auto it = b.find(v.first);
+            if (it == b.end() || !(it->second == v.second))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const frozen_flat_hash_map& a, const frozen_flat_hash_map& b) { return !(a == b); }
+
+    // -------------------------------- misc ---------------------------------
+    template<class K2>
+    size_t hash(const K2& key) const {
+#ifdef GTL_DISABLE_MIX
+        return hash_(key);
+#else
+        return phmap_mix<sizeof(size_t)>()(static_cast<size_t>(hash_(key)));
+#endif
+    }
+
+    hasher    hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+    Alloc     get_allocator() const { return alloc_; }
+
+private:
+    using items_type = std::vector<std::pair<K, V>, rebind_alloc<std::pair<K, V>>>;
+    using index_type = std::vector<uint32_t, rebind_alloc<uint32_t>>;
+    using seeds_type = std::vector<uint8_t, rebind_alloc<uint8_t>>;
+
+    static constexpr size_t npos = (size_t)-1;
+
+    static size_t bucket_of(size_t hashval, size_t num_buckets) { return gtl::priv::FastRange(hashval, num_buckets); }
+
+    // `seed` is the seed of the key's bucket, plus the `seed_base_` of the table
+    static size_t group_of(size_t hashval, size_t seed, size_t num_groups) {
+        constexpr size_t kSeedMul = static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+        return gtl::priv::FastRange(phmap_mix<sizeof(size_t)>()(hashval + seed * kSeedMul), num_groups);
+    }
+
+    // the slot holding `key`, or npos
+    template<class K2>
+    size_t find_index(const K2& key, size_t hashval) const {
+        if (!capacity_)
+            return npos; // moved from
+        size_t seed  = seed_base_ + seeds_[bucket_of(hashval, seeds_.size())];
+        size_t first = group_of(hashval, seed, capacity_ / kWidth) * kWidth;
+        for (uint32_t i : Group{ ctrl_.data() + first }.Match(gtl::priv::H2(hashval)))
+            if (GTL_PREDICT_TRUE(eq_(slots_[first + i].first, key)))
+                return first + i;
+        return npos;
+    }
+
+    // builds the table, which is empty, from `items`
+    void build(items_type&& items) {
+        const size_t n = items.size();
+        if (n > max_size())
+            ThrowStdLengthError("frozen_flat_hash_map: too many elements");
+
+        auto                                      alloc = items.get_allocator();
+        std::vector<size_t, rebind_alloc<size_t>> hashes(n, alloc);
+        for (size_t i = 0; i < n; ++i)
+            hashes[i] = hash(items[i].first);
+
+        // the items of each bucket (a counting sort), without the duplicate keys
+        const size_t num_buckets = (std::max)(n / kBucketSize, size_t(1));
+        index_type   bucket_items(n, 0, alloc), bucket_starts(num_buckets + 1, 0, alloc);
+        for (size_t i = 0; i < n; ++i)
+            ++bucket_starts[bucket_of(hashes[i], num_buckets) + 1];
+        for (size_t b = 0; b < num_buckets; ++b)
+            bucket_starts[b + 1] += bucket_starts[b];
+        {
+            index_type pos(bucket_starts.begin(), bucket_starts.end() - 1, alloc);
+            for (size_t i = 0; i < n; ++i)
+                bucket_items[pos[bucket_of(hashes[i], num_buckets)]++] = static_cast<uint32_t>(i);
+        }
+        size_t num_keys = 0;
+        for (size_t b = 0, lo = 0; b < num_buckets; ++b) {
+            size_t hi        = bucket_starts[b + 1];
+            size_t first     = num_keys;
+            bucket_starts[b] = static_cast<uint32_t>(num_keys);
+            for (; lo < hi; ++lo) {
+                uint32_t i   = bucket_items[lo];
+                auto     dup = [&](uint32_t j) { return hashes[j] == hashes[i] && eq_(items[j].first, items[i].first); };
+                if (std::none_of(bucket_items.begin() + first, bucket_items.begin() + num_keys, dup))
+                    bucket_items[num_keys++] = i;
+            }
+        }
+        bucket_starts[num_buckets] = static_cast<uint32_t>(num_keys);
+
+        // the largest buckets are placed first, while the groups have room
+        index_type buckets(num_buckets, 0, alloc);
+        for (size_t b = 0; b < num_buckets; ++b)
+            buckets[b] = static_cast<uint32_t>(b);
+        auto bucket_size = [&](uint32_t b) { return bucket_starts[b + 1] - bucket_starts[b]; };
+        std::stable_sort(buckets.begin(), buckets.end(), [&](uint32_t a, uint32_t b) {
+            return bucket_size(a) > bucket_size(b);
+        });
+
+        index_type item_group(n, 0, alloc);
+        seeds_.assign(num_buckets, 0);
+        size_t num_groups = (std::max)((num_keys * 256 + kWidth * kMaxLoad - 1) / (kWidth * kMaxLoad), size_t(1));
+        size_t seed_base  = 0;
+        while (!place(hashes, bucket_items, bucket_starts, buckets, num_groups, seed_base, item_group)) {
+            // a single unlucky bucket can make the placement fail, so a few
+            // other sets of seeds are tried before growing the table
+            seed_base += 256;
+            if (seed_base % (256 * kAttempts) == 0) {
+                // only keys sharing their hash value, more than a group can
+                // hold, can make the placement fail at any size
+                if (num_groups > num_keys)
+                    ThrowStdLengthError("frozen_flat_hash_map: too many keys with the same hash");
+                num_groups += num_groups / 64 + 1;
+            }
+        }
+        seed_base_ = seed_base;
+
+        // move the elements to their groups, followed by a sentinel for the
+        // iterators
+        capacity_ = num_groups * kWidth;
+        ctrl_.assign(capacity_ + 1, gtl::priv::kEmpty);
+        ctrl_[capacity_] = gtl::priv::kSentinel;
+        slots_           = AllocTraits::allocate(alloc_, capacity_);
+        try {
+            for (size_t k = 0; k < num_keys; ++k) {
+                uint32_t i     = bucket_items[k];
+                size_t   first = item_group[i] * kWidth;
+                size_t   slot  = first + Group{ ctrl_.data() + first }.MatchEmpty().LowestBitSet();
+                AllocTraits::construct(alloc_, slots_ + slot, std::move(items[i].first), std::move(items[i].second));
+                ctrl_[slot] = static_cast<ctrl_t>(gtl::priv::H2(hashes[i]));
+            }
+        } catch (...) {
+            destroy_slots(capacity_);
+            throw;
+        }
+        size_ = num_keys;
+    }
+
+    // Finds a seed for each bucket such that no group receives more than
+    // kWidth keys, and the group of each item, or returns false.
+    template<class Hashes>
+    bool place(const Hashes&     hashes,
+               const index_type& bucket_items,
+               const index_type& bucket_starts,
+               const index_type& buckets,
+               size_t            num_groups,
+               size_t            seed_base,
+               index_type&       item_group) {
+        seeds_type fill(num_groups, 0, seeds_.get_allocator());
+        for (uint32_t b : buckets) {
+            size_t lo = bucket_starts[b], hi = bucket_starts[b + 1];
+            if (lo == hi)
+                break; // the remaining buckets are empty
+            bool placed = false;
+            for (size_t s = 0; s <= (std::numeric_limits<uint8_t>::max)() && !placed; ++s) {
+                size_t k = lo;
+                for (; k < hi; ++k) {
+                    uint32_t i = bucket_items[k];
+                    size_t   g = group_of(hashes[i], seed_base + s, num_groups);
+                    if (fill[g] == kWidth)
+                        break;
+                    ++fill[g];
+                    item_group[i] = static_cast<uint32_t>(g);
+                }
+                placed = (k == hi);
+                if (placed)
+                    seeds_[b] = static_cast<uint8_t>(s);
+                else
+                    while (k-- > lo)
+                        --fill[item_group[bucket_items[k]]];
+            }
+            if (!placed)
+                return false;
+        }
+        return true;
+    }
+
+    // destroys the elements of the first `n` slots, and frees the slots
+    void destroy_slots(size_t n) {
+        if (!slots_)
+            return;
+        for (size_t i = 0; i < n; ++i)
+            if (gtl::priv::IsFull(ctrl_[i]))
+                AllocTraits::destroy(alloc_, slots_ + i);
+        AllocTraits::deallocate(alloc_, slots_, capacity_);
+        slots_ = nullptr;
+    }
+
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS hasher    hash_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS key_equal eq_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS Alloc     alloc_;
+    std::vector<ctrl_t, rebind_alloc<ctrl_t>> ctrl_;  // kWidth control bytes per group, and a sentinel
+    seeds_type                                seeds_; // the seed of each bucket
+    size_t                                    seed_base_ = 0;
+    size_t                                    size_      = 0;
+    size_t                                    capacity_  = 0;
+    value_type*                               slots_     = nullptr;
+};
+
+} // namespace gtl
+
+#endif // gtl_frozen_flat_hash_map_hpp_
@@ -980,6 +980,8 @@ namespace {
 
 static inline void ThrowStdOutOfRange(const std::string& what_arg) { GTL_THROW_IMPL_MSG(std::out_of_range, what_arg); }
 static inline void ThrowStdOutOfRange(const char* what_arg) { GTL_THROW_IMPL_MSG(std::out_of_range, what_arg); }
+static inline void ThrowStdLengthError(const char* what_arg) { GTL_THROW_IMPL_MSG(std::length_error, what_arg); }
+static inline void ThrowStdInvalidArgument(const char* what_arg) { GTL_THROW_IMPL_MSG(std::invalid_argument, what_arg); }
 
 } // gtl
 
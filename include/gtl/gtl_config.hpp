@@ -322,10 +322,29 @@ constexpr bool kIsArchWasm = false;
     #endif
 #endif
 
+#ifndef GTL_HAVE_AVX2
+    #if defined(__AVX2__)
+        #define GTL_HAVE_AVX2 1
+    #else
+        #define GTL_HAVE_AVX2 0
+    #endif
+#endif
+
+// The 32-wide AVX2 control byte group is opt-in: define GTL_USE_AVX2_GROUP=1
+// (and compile with -mavx2 or /arch:AVX2) to use it in raw_hash_set.
+// ----------------------------------------------------------------------
+#ifndef GTL_USE_AVX2_GROUP
+    #define GTL_USE_AVX2_GROUP 0
+#endif
+
 #if GTL_HAVE_SSSE3 && !GTL_HAVE_SSE2
     #error "Bad configuration!"
 #endif
 
+#if GTL_USE_AVX2_GROUP && !GTL_HAVE_AVX2
+    #error "GTL_USE_AVX2_GROUP requires AVX2 support (compile with -mavx2 or /arch:AVX2)"
+#endif
+
 #if GTL_HAVE_SSE2
     #include <emmintrin.h>
 #endif
@@ -334,6 +353,10 @@ constexpr bool kIsArchWasm = false;
     #include <tmmintrin.h>
 #endif
 
+#if GTL_HAVE_AVX2
+    #include <immintrin.h>
+#endif
+
 // ----------------------------------------------------------------------
 // RESTRICT
 // ----------------------------------------------------------------------
@@ -0,0 +1,130 @@
+#ifndef gtl_mapped_file_hpp_
+#define gtl_mapped_file_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+//
+// The platform specific file mapping used by mapped_flat_hash_map.hpp. On
+// Windows, <windows.h> is included with WIN32_LEAN_AND_MEAN, which is not left
+// defined, and NOMINMAX is left to the user.
+// ---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+        #define gtl_mapped_file_lean_
+    #endif
+    #include <windows.h>
+    #ifdef gtl_mapped_file_lean_
+        #undef WIN32_LEAN_AND_MEAN
+        #undef gtl_mapped_file_lean_
+    #endif
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace gtl {
+
+namespace priv {
+
+// ------------------------------------------------------------------------------
+// A read-only mapping of a whole file, shared with the other processes mapping
+// it. The pages are read from the file when first accessed.
+// ------------------------------------------------------------------------------
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& o) noexcept
+        : data_(std::exchange(o.data_, nullptr))
+        , size_(std::exchange(o.size_, 0)) {}
+
+    mapped_file& operator=(mapped_file&& o) noexcept {
+        if (this != &o) {
+            close();
+            data_ = std::exchange(o.data_, nullptr);
+            size_ = std::exchange(o.size_, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_file() { close(); }
+
+    // returns false if the file cannot be opened or is empty
+    bool open(const char* path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER sz;
+        HANDLE        mapping = nullptr;
+        if (GetFileSizeEx(file, &sz) && sz.QuadPart > 0)
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+            return false;
+        void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!p)
+            return false;
+        size_ = static_cast<size_t>(sz.QuadPart);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        void*       p = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+            p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return false;
+        size_ = static_cast<size_t>(st.st_size);
+#endif
+        data_ = static_cast<const unsigned char*>(p);
+        return true;
+    }
+
+    void close() {
+        if (data_) {
+#ifdef _WIN32
+            UnmapViewOfFile(data_);
+#else
+            ::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const unsigned char* data() const { return data_; }
+    size_t               size() const { return size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t               size_ = 0;
+};
+
+} // namespace priv
+
+} // namespace gtl
+
+#endif // gtl_mapped_file_hpp_
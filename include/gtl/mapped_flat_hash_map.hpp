@@ -0,0 +1,315 @@
+#ifndef gtl_mapped_flat_hash_map_hpp_
+#define gtl_mapped_flat_hash_map_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gtl/phmap.hpp>
+#include <gtl/phmap_dump.hpp>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// the mappable dumps are written by phmap_dump.hpp, and probed with an unsalted H1()
+#if defined(GTL_NON_DETERMINISTIC) || defined(GTL_DISABLE_DUMP)
+    #error "mapped_flat_hash_map is not available with GTL_NON_DETERMINISTIC or GTL_DISABLE_DUMP"
+#else
+
+// last, as <windows.h> may define min and max
+#include <gtl/mapped_file.hpp>
+
+namespace gtl {
+
+// ------------------------------------------------------------------------------
+// A read-only view of a `flat_hash_map` dumped with `phmap_dump_mappable()`,
+// which serves the lookups and the iteration directly from a memory mapping of
+// the dump: opening it does not read or copy the table, the pages are read
+// from the file as they are accessed, and they are shared by all the
+// processes mapping the same file.
+//
+// The view probes the table exactly as the dumped map did, so it must use the
+// same `Hash` and `Eq`, with a key and a mapped type of the same layout. The
+// maps with tight capacities (`flat_hash_map_tight`) are supported, and
+// `open()` rejects a file written with another layout or group width. The
+// tables of a `parallel_flat_hash_map` are not, as they are dumped one after
+// the other.
+//
+//   gtl::flat_hash_map<uint64_t, uint64_t> m = ...;
+//   {
+//       gtl::BinaryOutputArchive ar("./m.dump");
+//       m.phmap_dump_mappable(ar);
+//   }
+//   gtl::mapped_flat_hash_map<uint64_t, uint64_t> view;
+//   if (view.open("./m.dump") && view.contains(42)) ...
+// ------------------------------------------------------------------------------
+template<class K,
+         class V,
+         class Hash = gtl::priv::hash_default_hash<K>,
+         class Eq   = gtl::priv::hash_default_eq<K>>
+class mapped_flat_hash_map {
+    using ctrl_t = gtl::priv::ctrl_t;
+    using Group  = gtl::priv::Group;
+    using header = gtl::priv::mapped_dump_header;
+
+public:
+    using key_type        = K;
+    using mapped_type     = V;
+    using value_type      = std::pair<const K, V>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "value_type should be trivially copyable");
+
+    template<class T>
+    using key_arg = typename KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>::template type<T, K>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename mapped_flat_hash_map::value_type;
+        using reference         = const value_type&;
+        using pointer           = const value_type*;
+        using difference_type   = ptrdiff_t;
+
+        iterator() = default;
+
+        reference operator*() const { return *slot_; }
+        pointer   operator->() const { return slot_; }
+
+        iterator& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.ctrl_ == b.ctrl_; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        friend class mapped_flat_hash_map;
+
+        iterator(const ctrl_t* ctrl, const value_type* slot)
+            : ctrl_(ctrl)
+            , slot_(slot) {}
+
+        // stops at the first full slot, or at the sentinel
+        void skip_empty_or_deleted() {
+            while (gtl::priv::IsEmptyOrDeleted(*ctrl_)) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const ctrl_t*     ctrl_ = nullptr;
+        const value_type* slot_ = nullptr;
+    };
+
+    using const_iterator = iterator;
+
+    explicit mapped_flat_hash_map(const hasher& hash = hasher(), const key_equal& eq = key_equal())
+        : hash_(hash)
+        , eq_(eq) {}
+
+    // the moved-from view is closed
+    mapped_flat_hash_map(mapped_flat_hash_map&& o) noexcept
+        : hash_(std::move(o.hash_))
+        , eq_(std::move(o.eq_))
+        , file_(std::move(o.file_))
+        , ctrl_(std::exchange(o.ctrl_, nullptr))
+        , slots_(std::exchange(o.slots_, nullptr))
+        , size_(std::exchange(o.size_, 0))
+        , capacity_(std::exchange(o.capacity_, 0))
+        , tight_(std::exchange(o.tight_, false)) {}
+
+    mapped_flat_hash_map& operator=(mapped_flat_hash_map&& o) noexcept {
+        if (this != &o) {
+            hash_     = std::move(o.hash_);
+            eq_       = std::move(o.eq_);
+            file_     = std::move(o.file_);
+            ctrl_     = std::exchange(o.ctrl_, nullptr);
+            slots_    = std::exchange(o.slots_, nullptr);
+            size_     = std::exchange(o.size_, 0);
+            capacity_ = std::exchange(o.capacity_, 0);
+            tight_    = std::exchange(o.tight_, false);
+        }
+        return *this;
+    }
+
+    // Maps the dump at `path`, and returns false (leaving the view empty) if
+    // it cannot be opened, or was not written by phmap_dump_mappable() for a
+    // table of this layout.
+    // -----------------------------------------------------------------------
+    bool open(const char* path) {
+        close();
+        if (!file_.open(path))
+            return false;
+        const unsigned char* data = file_.data();
+        const size_t         len  = file_.size();
+
+        header h;
+        if (len < sizeof(h)) {
+            close();
+            return false;
+        }
+        std::memcpy(&h, data, sizeof(h));
+        const size_t ctrl_bytes = h.capacity ? h.capacity + Group::kWidth + 1 : 0;
+        const bool   valid_capacity =
+            h.capacity == 0 || (h.tight ? gtl::priv::IsValidTightCapacity(h.capacity)
+                                        : gtl::priv::IsValidCapacity(h.capacity));
+        if (h.magic != header::kMagic || h.version != header::kVersion || h.group_width != Group::kWidth ||
+            h.slot_size != sizeof(value_type) || h.tight > 1 || !valid_capacity || h.size > h.capacity ||
+            h.ctrl_offset % gtl::priv::kMappedAlign || h.slots_offset % gtl::priv::kMappedAlign ||
+            h.ctrl_offset > len || ctrl_bytes > len - h.ctrl_offset || h.slots_offset > len ||
+            h.capacity > (len - h.slots_offset) / sizeof(value_type)) {
+            close();
+            return false;
+        }
+        // iteration stops on the sentinel byte, so a dump missing it would
+        // walk past the end of the mapping
+        if (h.capacity && reinterpret_cast<const ctrl_t*>(data + h.ctrl_offset)[h.capacity] != gtl::priv::kSentinel) {
+            close();
+            return false;
+        }
+        size_     = h.size;
+        capacity_ = h.capacity;
+        tight_    = h.tight != 0;
+        if (capacity_) {
+            ctrl_  = reinterpret_cast<const ctrl_t*>(data + h.ctrl_offset);
+            slots_ = reinterpret_cast<const value_type*>(data + h.slots_offset);
+        }
+        return true;
+    }
+
+    void close() {
+        file_.close();
+        ctrl_     = nullptr;
+        slots_    = nullptr;
+        size_     = 0;
+        capacity_ = 0;
+        tight_    = false;
+    }
+
+    bool is_open() const { return file_.data() != nullptr; }
+
+    // ------------------------------ iterators ------------------------------
+    iterator begin() const {
+        if (!capacity_)
+            return end();
+        iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+
+    iterator end() const { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+    iterator cbegin() const { return begin(); }
+    iterator cend() const { return end(); }
+
+    // ------------------------------ capacity -------------------------------
+    bool      empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_t    capacity() const noexcept { return capacity_; }
+    size_t    bucket_count() const noexcept { return capacity_ + 1; }
+    float     load_factor() const { return capacity_ ? static_cast<float>(size_) / (capacity_ + 1) : 0.0f; }
+
+    // ------------------------------- lookups -------------------------------
+    template<class K2 = key_type>
+    iterator find(const key_arg<K2>& key) const {
+        size_t i = find_index<key_arg<K2>>(key, hash(key));
+        return i == npos ? end() : iterator(ctrl_ + i, slots_ + i);
+    }
+
+    template<class K2 = key_type>
+    bool contains(const key_arg<K2>& key) const {
+        return find_index<key_arg<K2>>(key, hash(key)) != npos;
+    }
+
+    template<class K2 = key_type>
+    size_type count(const key_arg<K2>& key) const {
+        return contains<K2>(key) ? 1 : 0;
+    }
+
+    template<class K2 = key_type>
+    const mapped_type& at(const key_arg<K2>& key) const {
+        size_t i = find_index<key_arg<K2>>(key, hash(key));
+        if (i == npos)
+            ThrowStdOutOfRange("mapped_flat_hash_map at(): lookup non-existent key");
+        return slots_[i].second;
+    }
+
+    // -------------------------------- misc ---------------------------------
+    template<class K2>
+    size_t hash(const K2& key) const {
+#ifdef GTL_DISABLE_MIX
+        return hash_(key);
+#else
+        return phmap_mix<sizeof(size_t)>()(static_cast<size_t>(hash_(key)));
+#endif
+    }
+
+    hasher    hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+
+private:
+    static constexpr size_t npos = (size_t)-1;
+
+    template<class K2>
+    size_t find_index(const K2& key, size_t hashval) const {
+        if (!capacity_)
+            return npos;
+        return tight_ ? probe<true>(key, hashval) : probe<false>(key, hashval);
+    }
+
+    // the probing of raw_hash_set::find(), bounded in case of a corrupt file
+    template<bool Tight, class K2>
+    size_t probe(const K2& key, size_t hashval) const {
+        gtl::priv::probe_seq<Group::kWidth, Tight> seq(gtl::priv::H1(hashval, ctrl_), capacity_);
+        while (true) {
+            Group g{ ctrl_ + seq.offset() };
+            for (uint32_t i : g.Match(gtl::priv::H2(hashval))) {
+                size_t offset = seq.offset(i);
+                if (GTL_PREDICT_TRUE(eq_(slots_[offset].first, key)))
+                    return offset;
+            }
+            if (GTL_PREDICT_TRUE(g.MatchEmpty()) || seq.getindex() >= capacity_)
+                return npos;
+            seq.next();
+        }
+    }
+
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS hasher    hash_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS key_equal eq_;
+    gtl::priv::mapped_file                    file_;
+    const ctrl_t*                             ctrl_     = nullptr;
+    const value_type*                         slots_    = nullptr;
+    size_t                                    size_     = 0;
+    size_t                                    capacity_ = 0;
+    bool                                      tight_    = false;
+};
+
+} // namespace gtl
+
+#endif // defined(GTL_NON_DETERMINISTIC) || defined(GTL_DISABLE_DUMP)
+
+#endif // gtl_mapped_flat_hash_map_hpp_
@@ -101,13 +101,14 @@ public:
         key_type key(args...);
         if constexpr (!std::is_same_v<Mutex, gtl::NullMutex> && !recursive) {
             // because we are using a mutex, we must be in a multithreaded context,
-            // so use lazy_emplace_l to take the lock only once.
+            // so use lazy_emplace_l_shared to take the lock only once (and only
+            // a read lock when the key is present).
             // --------------------------------------------------------------------
             result_type res;
-            _cache.lazy_emplace_l(
+            _cache.lazy_emplace_l_shared(
                 key,
-                [&](typename map_type::value_type& v) {
-                    // called only when key was already present
+                [&](const typename map_type::value_type& v) {
+                    // called only when key was already present (under a read lock)
                     res = v.second;
                 },
                 [&](const typename map_type::constructor& ctor) {
@@ -109,16 +109,22 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <exception>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <mutex> // for std::lock
 #include <optional>
+#include <ranges>
+#include <span>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "gtl_config.hpp"
 #include <shared_mutex> // after "gtl_config.hpp"
@@ -659,29 +665,466 @@ public:
     using UniqueLocks     = typename Base::WriteLocks;
 };
 
+// --------------------------------------------------------------------------
+//         Spin locks, for the short critical sections of the submaps
+//         use: `gtl::spin_mutex`, `gtl::ticket_mutex` or `gtl::rw_spin_mutex`
+//         instead of `std::mutex`
+// --------------------------------------------------------------------------
+// A parallel_hash_set only holds a submap lock for one probe sequence, which
+// is much shorter than the time it takes to put a thread to sleep and wake
+// it up again. These locks are a single 32 bit word, so they share the
+// cache line of the submap header they protect (see parallel_hash_set::Inner).
+// Waiting threads spin on a plain load with an exponential backoff, and yield
+// their time slice once the lock has been held for a while, so they don't
+// starve the owner when there are more threads than cores.
+// --------------------------------------------------------------------------
+namespace priv {
+
+inline void cpu_relax() noexcept {
+#if GTL_HAVE_SSE2
+    _mm_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __yield();
+#endif
+}
+
+class spin_backoff {
+public:
+    void operator()() noexcept {
+        if (spins_ <= kMaxSpins) {
+            for (uint32_t i = 0; i < spins_; ++i)
+                cpu_relax();
+            spins_ *= 2;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    static constexpr uint32_t kMaxSpins = 64;
+    uint32_t                  spins_    = 1;
+};
+
+} // namespace priv
+
+// test-and-test-and-set lock
+// --------------------------
+class spin_mutex {
+public:
+    void lock() noexcept {
+        priv::spin_backoff backoff;
+        while (locked_.exchange(1, std::memory_order_acquire)) {
+            while (locked_.load(std::memory_order_relaxed))
+                backoff();
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(1, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept { locked_.store(0, std::memory_order_release); }
+
+private:
+    std::atomic<uint32_t> locked_{ 0 };
+};
+
+// FIFO ticket lock: fair under contention, waiters back off in proportion to
+// their distance to the head of the queue. Every release hands the lock to
+// the next waiter, so it should only be used with no more threads than cores:
+// a preempted waiter stalls all the threads queued behind it.
+// --------------------------------------------------------------------------
+class ticket_mutex {
+public:
+    void lock() noexcept {
+        uint16_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+        uint32_t spins  = 0;
+        for (;;) {
+            uint16_t ahead = (uint16_t)(ticket - serving_.load(std::memory_order_acquire));
+            if (ahead == 0)
+                return;
+            if (++spins > 32) {
+                std::this_thread::yield();
+            } else {
+                for (uint32_t i = 0; i < 16u * ahead; ++i)
+                    priv::cpu_relax();
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint16_t serving = serving_.load(std::memory_order_relaxed);
+        uint16_t next    = serving;
+        return next_.compare_exchange_strong(next, (uint16_t)(serving + 1), std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        serving_.store((uint16_t)(serving_.load(std::memory_order_relaxed) + 1), std::memory_order_release);
+    }
+
+private:
+    std::atomic<uint16_t> next_{ 0 };
+    std::atomic<uint16_t> serving_{ 0 };
+};
+
+// Reader-writer spin lock. The waiting writers are counted in the lock word,
+// and stop new readers from getting the lock, so a steady stream of lookups
+// can't starve an insertion.
+// --------------------------------------------------------------------------
+class rw_spin_mutex {
+public:
+    void lock() noexcept {
+        if (try_lock())
+            return;
+        priv::spin_backoff backoff;
+        state_.fetch_add(kWriterWaiting, std::memory_order_relaxed);
+        for (;;) {
+            uint32_t s = state_.load(std::memory_order_relaxed);
+            if ((s & (kWriter | kReaders)) == 0) {
+                // stop waiting, other writers still waiting keep their count
+                if (state_.compare_exchange_weak(
+                        s, (s - kWriterWaiting) | kWriter, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+            backoff();
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint32_t s = state_.load(std::memory_order_relaxed);
+        return (s & (kWriter | kReaders)) == 0 &&
+               state_.compare_exchange_strong(s, s | kWriter, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept { state_.fetch_and(~kWriter, std::memory_order_release); }
+
+    void lock_shared() noexcept {
+        priv::spin_backoff backoff;
+        while (!try_lock_shared())
+            backoff();
+    }
+
+    bool try_lock_shared() noexcept {
+        uint32_t s = state_.load(std::memory_order_relaxed);
+        return !(s & (kWriter | kWritersWaiting)) &&
+               state_.compare_exchange_strong(s, s + kReader, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock_shared() noexcept { state_.fetch_sub(kReader, std::memory_order_release); }
+
+private:
+    static constexpr uint32_t kWriter         = 1;
+    static constexpr uint32_t kWriterWaiting  = 2;       // unit of the waiting writers count
+    static constexpr uint32_t kWritersWaiting = 0xfffe;  // bits of the waiting writers count
+    static constexpr uint32_t kReader         = 0x10000; // unit of the readers count
+    static constexpr uint32_t kReaders        = ~(kReader - 1);
+
+    std::atomic<uint32_t> state_{ 0 };
+};
+
+template<>
+class LockableImpl<spin_mutex> : public spin_mutex {
+public:
+    using mutex_type      = spin_mutex;
+    using Base            = LockableBaseImpl<spin_mutex>;
+    using SharedLock      = typename Base::WriteLock;
+    using UniqueLock      = typename Base::WriteLock;
+    using ReadWriteLock   = typename Base::WriteLock;
+    using SharedLocks     = typename Base::WriteLocks;
+    using UniqueLocks     = typename Base::WriteLocks;
+};
+
+template<>
+class LockableImpl<ticket_mutex> : public ticket_mutex {
+public:
+    using mutex_type      = ticket_mutex;
+    using Base            = LockableBaseImpl<ticket_mutex>;
+    using SharedLock      = typename Base::WriteLock;
+    using UniqueLock      = typename Base::WriteLock;
+    using ReadWriteLock   = typename Base::WriteLock;
+    using SharedLocks     = typename Base::WriteLocks;
+    using UniqueLocks     = typename Base::WriteLocks;
+};
+
+template<>
+class LockableImpl<rw_spin_mutex> : public rw_spin_mutex {
+public:
+    using mutex_type      = rw_spin_mutex;
+    using Base            = LockableBaseImpl<rw_spin_mutex>;
+    using SharedLock      = typename Base::ReadLock;
+    using UniqueLock      = typename Base::WriteLock;
+    using ReadWriteLock   = typename Base::ReadWriteLock;
+    using SharedLocks     = typename Base::ReadLocks;
+    using UniqueLocks     = typename Base::WriteLocks;
+};
+
+// --------------------------------------------------------------------------
+//         Sequence lock, for lock-free optimistic reads
+//         use: `gtl::SeqMutex<std::mutex>` instead of `std::mutex`
+// --------------------------------------------------------------------------
+// Wraps a mutex with a sequence counter, which is odd while the mutex is
+// locked for writing. parallel_hash_set uses it to look up trivially copyable
+// values without taking any lock: the reader copies the value, and retries
+// if the counter changed meanwhile (see parallel_hash_set::if_contains()).
+// This is only enabled when the allocator keeps the memory of the submaps
+// mapped, see gtl::retaining_allocator and gtl::parallel_flat_hash_map_seqlock.
+// --------------------------------------------------------------------------
+template<class Mtx_>
+class SeqMutex {
+public:
+    static constexpr bool kShared = requires(Mtx_& m) { m.lock_shared(); };
+
+    void lock() {
+        mtx_.lock();
+        begin_write();
+    }
+
+    bool try_lock() {
+        if (!mtx_.try_lock())
+            return false;
+        begin_write();
+        return true;
+    }
+
+    void unlock() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        mtx_.unlock();
+    }
+
+    // readers holding a lock don't modify the table, so they leave the counter alone
+    void lock_shared() requires kShared { mtx_.lock_shared(); }
+    void unlock_shared() requires kShared { mtx_.unlock_shared(); }
+    bool try_lock_shared() requires kShared { return mtx_.try_lock_shared(); }
+
+    // Optimistic reads: `read_begin()` returns an odd value if a writer holds
+    // the lock, and `read_validate(seq)` whether no writer got it since.
+    uint64_t read_begin() const { return seq_.load(std::memory_order_acquire); }
+
+    bool read_validate(uint64_t seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) == seq;
+    }
+
+private:
+    void begin_write() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    Mtx_                  mtx_;
+    std::atomic<uint64_t> seq_{ 0 };
+};
+
+template<class Mtx_>
+class LockableImpl<SeqMutex<Mtx_>> : public SeqMutex<Mtx_> {
+public:
+    using mutex_type    = SeqMutex<Mtx_>;
+    using Base          = LockableBaseImpl<mutex_type>;
+    using SharedLock    = std::conditional_t<mutex_type::kShared, typename Base::ReadLock, typename Base::WriteLock>;
+    using UniqueLock    = typename Base::WriteLock;
+    using ReadWriteLock = std::conditional_t<mutex_type::kShared, typename Base::ReadWriteLock, typename Base::WriteLock>;
+    using SharedLocks   = std::conditional_t<mutex_type::kShared, typename Base::ReadLocks, typename Base::WriteLocks>;
+    using UniqueLocks   = typename Base::WriteLocks;
+
+    static constexpr bool kOptimisticReads = true;
+};
+
+// --------------------------------------------------------------------------
+//         Instrumented mutex, to measure the lock contention of each submap
+//         use: `gtl::InstrumentedMutex<std::mutex>` instead of `std::mutex`
+// --------------------------------------------------------------------------
+// Counts the lock acquisitions, how many of them had to wait because another
+// thread held the lock, and the total time spent waiting. The uncontended path
+// only adds a relaxed increment; the clock is only read when the first
+// try_lock() fails. The counters of each submap are returned by
+// parallel_hash_set::lock_stats(idx):
+//
+//   for (size_t i = 0; i < m.subcnt(); ++i) {
+//       gtl::lock_stats_t st = m.lock_stats(i);
+//       export_metric(i, st.acquisitions, st.contended, st.wait_time);
+//   }
+// --------------------------------------------------------------------------
+struct lock_stats_t {
+    uint64_t                 acquisitions = 0; // exclusive and shared
+    uint64_t                 contended    = 0; // acquisitions which had to wait
+    std::chrono::nanoseconds wait_time{ 0 };   // total time spent waiting
+
+    lock_stats_t& operator+=(const lock_stats_t& o) {
+        acquisitions += o.acquisitions;
+        contended += o.contended;
+        wait_time += o.wait_time;
+        return *this;
+    }
+};
+
+template<class Mtx_>
+class InstrumentedMutex {
+public:
+    static constexpr bool kShared = requires(Mtx_& m) { m.lock_shared(); };
+
+    void lock() {
+        if (!mtx_.try_lock())
+            wait([this]() { mtx_.lock(); });
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool try_lock() {
+        if (!mtx_.try_lock())
+            return false;
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock() { mtx_.unlock(); }
+
+    void lock_shared() requires kShared {
+        if (!mtx_.try_lock_shared())
+            wait([this]() { mtx_.lock_shared(); });
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool try_lock_shared() requires kShared {
+        if (!mtx_.try_lock_shared())
+            return false;
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock_shared() requires kShared { mtx_.unlock_shared(); }
+
+    // a snapshot of the counters, which may be taken without holding the lock
+    lock_stats_t stats() const {
+        return { acquisitions_.load(std::memory_order_relaxed),
+                 contended_.load(std::memory_order_relaxed),
+                 std::chrono::nanoseconds(wait_ns_.load(std::memory_order_relaxed)) };
+    }
+
+    void reset_stats() {
+        acquisitions_.store(0, std::memory_order_relaxed);
+        contended_.store(0, std::memory_order_relaxed);
+        wait_ns_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    template<class F>
+    void wait(F&& acquire) {
+        // counted before blocking, so a holder can observe that somebody is waiting on it
+        contended_.fetch_add(1, std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        acquire();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        wait_ns_.fetch_add((uint64_t)ns.count(), std::memory_order_relaxed);
+    }
+
+    Mtx_                  mtx_;
+    std::atomic<uint64_t> acquisitions_{ 0 };
+    std::atomic<uint64_t> contended_{ 0 };
+    std::atomic<uint64_t> wait_ns_{ 0 };
+};
+
+template<class Mtx_>
+class LockableImpl<InstrumentedMutex<Mtx_>> : public InstrumentedMutex<Mtx_> {
+public:
+    using mutex_type    = InstrumentedMutex<Mtx_>;
+    using Base          = LockableBaseImpl<mutex_type>;
+    using SharedLock    = std::conditional_t<mutex_type::kShared, typename Base::ReadLock, typename Base::WriteLock>;
+    using UniqueLock    = typename Base::WriteLock;
+    using ReadWriteLock = std::conditional_t<mutex_type::kShared, typename Base::ReadWriteLock, typename Base::WriteLock>;
+    using SharedLocks   = std::conditional_t<mutex_type::kShared, typename Base::ReadLocks, typename Base::WriteLocks>;
+    using UniqueLocks   = typename Base::WriteLocks;
+};
+
+// -----------------------------------------------------------------------------
+// Tag selecting the hash containers constructors which build the container
+// from a range of elements with distinct keys, without comparing keys (see
+// insert_unique_unchecked()).
+//
+//   gtl::flat_hash_map<int, int> m(gtl::from_unique_range, v.begin(), v.end());
+// -----------------------------------------------------------------------------
+struct from_unique_range_t {
+    explicit from_unique_range_t() = default;
+};
+inline constexpr from_unique_range_t from_unique_range{};
+
 namespace priv {
 
 // --------------------------------------------------------------------------
-template<size_t Width>
+// Maps `x`, uniformly distributed over the size_t values, to [0, n) with a
+// multiply-shift instead of a division (Lemire's "fastrange").
+// --------------------------------------------------------------------------
+inline size_t FastRange(size_t x, size_t n) {
+    if constexpr (sizeof(size_t) == 4) {
+        return static_cast<size_t>((static_cast<uint64_t>(x) * n) >> 32);
+    } else {
+#if defined(GTL_HAS_UMUL128)
+        uint64_t high;
+        umul128(x, n, &high);
+        return static_cast<size_t>(high);
+#else
+        uint64_t x_lo = x & 0xffffffff, x_hi = x >> 32;
+        uint64_t n_lo = n & 0xffffffff, n_hi = n >> 32;
+        uint64_t mid  = x_hi * n_lo + ((x_lo * n_lo) >> 32);
+        uint64_t mid2 = x_lo * n_hi + (mid & 0xffffffff);
+        return static_cast<size_t>(x_hi * n_hi + (mid >> 32) + (mid2 >> 32));
+#endif
+    }
+}
+
+// --------------------------------------------------------------------------
+// The probe sequence of a table of capacity `mask`.
+//
+// When `Tight` is false, the capacity is a power of 2 minus 1, and the
+// groups are probed quadratically (triangular numbers).
+//
+// When `Tight` is true, the capacity plus one may also be any multiple of
+// `Width` (see raw_hash_set::kTight). The first offset is found with
+// FastRange(), and the groups are probed linearly, which visits every group
+// of such a table.
+// --------------------------------------------------------------------------
+template<size_t Width, bool Tight = false>
 class probe_seq {
 public:
     probe_seq(size_t hashval, size_t mask) {
-        assert(((mask + 1) & mask) == 0 && "not a mask");
-        mask_   = mask;
-        offset_ = hashval & mask_;
+        mask_ = mask;
+        if constexpr (Tight) {
+            assert((((mask + 1) & mask) == 0 || (mask + 1) % Width == 0) && "not a tight capacity");
+            offset_ = FastRange(hashval << 7, mask + 1); // `hashval` is H1(), without the 7 bits of H2
+        } else {
+            assert(((mask + 1) & mask) == 0 && "not a mask");
+            offset_ = hashval & mask_;
+        }
     }
     size_t offset() const { return offset_; }
-    size_t offset(size_t i) const { return (offset_ + i) & mask_; }
+    size_t offset(size_t i) const { return wrap(offset_ + i); }
 
     void next() {
         index_ += Width;
-        offset_ += index_;
-        offset_ &= mask_;
+        if constexpr (Tight) {
+            offset_ = wrap(offset_ + Width);
+        } else {
+            offset_ += index_;
+            offset_ &= mask_;
+        }
     }
     // 0-based probe index. The i-th probe in the probe sequence.
     size_t getindex() const { return index_; }
 
 private:
+    // `o` modulo the capacity plus one, for `o` < capacity + Width
+    size_t wrap(size_t o) const {
+        if constexpr (Tight) {
+            // the capacity of small tables is still a power of 2 minus 1
+            if (mask_ < Width - 1)
+                return o & mask_;
+            return o > mask_ ? o - mask_ - 1 : o;
+        } else {
+            return o & mask_;
+        }
+    }
+
     size_t mask_;
     size_t offset_;
     size_t index_ = 0;
@@ -791,9 +1234,10 @@ using h2_t   = uint8_t;
 // below for details.
 // --------------------------------------------------------------------------
 enum Ctrl : ctrl_t {
-    kEmpty    = -128, // 0b10000000
-    kDeleted  = -2,   // 0b11111110
-    kSentinel = -1,   // 0b11111111
+    kEmpty      = -128, // 0b10000000
+    kDeletedOld = -6,   // 0b11111010, a kDeleted reviewed by raw_hash_set::compact()
+    kDeleted    = -2,   // 0b11111110
+    kSentinel   = -1,   // 0b11111111
 };
 
 static_assert(kEmpty & kDeleted & kSentinel & 0x80,
@@ -814,17 +1258,25 @@ static_assert(~kEmpty & ~kDeleted & kSentinel & 0x7F,
 static_assert(kDeleted == -2,
               "kDeleted must be -2 to make the implementation of "
               "ConvertSpecialToEmptyAndFullToDeleted efficient");
+static_assert((kDeletedOld & 0x83) == (kDeleted & 0x83),
+              "kDeletedOld must share the bits of kDeleted tested by the scalar "
+              "MatchEmpty() and MatchEmptyOrDeleted(), so that it is handled as "
+              "a deleted slot");
 
 // --------------------------------------------------------------------------
 // A single block of empty control bytes for tables without any slots allocated.
 // This enables removing a branch in the hot path of find().
+// It is 32 bytes long so that it covers the widest Group (GroupAvx2Impl).
 // --------------------------------------------------------------------------
 template <class std_alloc_t>
 inline ctrl_t* EmptyGroup() {
     if constexpr (std_alloc_t::value) {
-        alignas(16) static constexpr ctrl_t empty_group[] = { kSentinel, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+        alignas(32) static constexpr ctrl_t empty_group[] = { kSentinel, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+                                                              kEmpty,    kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
                                                               kEmpty,    kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
-                                                              kEmpty,    kEmpty, kEmpty, kEmpty };
+                                                              kEmpty,    kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+                                                              kEmpty,    kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+                                                              kEmpty,    kEmpty };
         return const_cast<ctrl_t*>(empty_group);
     } else {
         return nullptr;
@@ -857,7 +1309,7 @@ inline h2_t H2(size_t hashval) { return (h2_t)(ctrl_t)(hashval & 0x7F); }
 
 inline bool IsEmpty(ctrl_t c) { return c == kEmpty; }
 inline bool IsFull(ctrl_t c) { return c >= static_cast<ctrl_t>(0); }
-inline bool IsDeleted(ctrl_t c) { return c == kDeleted; }
+inline bool IsDeleted(ctrl_t c) { return c == kDeleted || c == kDeletedOld; }
 inline bool IsEmptyOrDeleted(ctrl_t c) { return c < kSentinel; }
 
 #if GTL_HAVE_SSE2
@@ -952,6 +1404,84 @@ struct GroupSse2Impl {
 
 #endif // GTL_HAVE_SSE2
 
+#if GTL_USE_AVX2_GROUP
+
+// --------------------------------------------------------------------------
+// Same -funsigned-char workaround as _mm_cmpgt_epi8_fixed, for 32 bytes.
+// --------------------------------------------------------------------------
+inline __m256i _mm256_cmpgt_epi8_fixed(__m256i a, __m256i b) {
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Woverflow"
+
+    if (std::is_unsigned_v<char>) {
+        const __m256i mask = _mm256_set1_epi8(static_cast<char>(0x80));
+        const __m256i diff = _mm256_subs_epi8(b, a);
+        return _mm256_cmpeq_epi8(_mm256_and_si256(diff, mask), mask);
+    }
+
+        #pragma GCC diagnostic pop
+    #endif
+    return _mm256_cmpgt_epi8(a, b);
+}
+
+// --------------------------------------------------------------------------
+// Opt-in 32-wide group (see GTL_USE_AVX2_GROUP in gtl_config.hpp). Each load
+// covers twice as many control bytes as GroupSse2Impl, which halves the
+// number of group loads on long probe sequences.
+// --------------------------------------------------------------------------
+struct GroupAvx2Impl {
+    enum { kWidth = 32 }; // the number of slots per group
+
+    explicit GroupAvx2Impl(const ctrl_t* pos) { ctrl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos)); }
+
+    // Returns a bitmask representing the positions of slots that match hash.
+    // ----------------------------------------------------------------------
+    BitMask<uint32_t, kWidth> Match(h2_t hash) const {
+        auto match = _mm256_set1_epi8((char)hash);
+        return BitMask<uint32_t, kWidth>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(match, ctrl))));
+    }
+
+    // Returns a bitmask representing the positions of empty slots.
+    // ------------------------------------------------------------
+    BitMask<uint32_t, kWidth> MatchEmpty() const {
+        // This only works because kEmpty is -128.
+        return BitMask<uint32_t, kWidth>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_sign_epi8(ctrl, ctrl))));
+    }
+
+    // Returns a bitmask representing the positions of empty or deleted slots.
+    // -----------------------------------------------------------------------
+    BitMask<uint32_t, kWidth> MatchEmptyOrDeleted() const {
+        auto special = _mm256_set1_epi8(static_cast<char>(kSentinel));
+        return BitMask<uint32_t, kWidth>(
+            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8_fixed(special, ctrl))));
+    }
+
+    // Returns the number of trailing empty or deleted elements in the group.
+    // The mask is widened to 64 bits so that a group with 32 empty or deleted
+    // bytes returns 32 rather than overflowing.
+    // ----------------------------------------------------------------------
+    uint32_t CountLeadingEmptyOrDeleted() const {
+        auto special = _mm256_set1_epi8(static_cast<char>(kSentinel));
+        auto mask    = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8_fixed(special, ctrl)));
+        return TrailingZeros(static_cast<uint64_t>(mask) + 1);
+    }
+
+    // ----------------------------------------------------------------------
+    void ConvertSpecialToEmptyAndFullToDeleted(ctrl_t* dst) const {
+        // _mm256_shuffle_epi8 shuffles within each 128 bit lane, which is fine
+        // since every byte of x126 is the same.
+        auto msbs = _mm256_set1_epi8(static_cast<char>(-128));
+        auto x126 = _mm256_set1_epi8(126);
+        auto res  = _mm256_or_si256(_mm256_shuffle_epi8(x126, ctrl), msbs);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), res);
+    }
+
+    __m256i ctrl;
+};
+
+#endif // GTL_USE_AVX2_GROUP
+
 // --------------------------------------------------------------------------
 // --------------------------------------------------------------------------
 struct GroupPortableImpl {
@@ -1006,7 +1536,9 @@ struct GroupPortableImpl {
     uint64_t ctrl;
 };
 
-#if GTL_HAVE_SSE2
+#if GTL_USE_AVX2_GROUP
+using Group = GroupAvx2Impl;
+#elif GTL_HAVE_SSE2
 using Group = GroupSse2Impl;
 #else
 using Group = GroupPortableImpl;
@@ -1017,14 +1549,80 @@ using Group = GroupPortableImpl;
 // -------------------------------------------------------------------------
 constexpr size_t NumClonedBytes() { return Group::kWidth - 1; }
 
+// --------------------------------------------------------------------------
+// Runs `task(i)` for i in [0, num_tasks) on `num_threads` threads. If a task
+// throws, no further task is started, and the first exception is rethrown on
+// the calling thread once all the threads are joined.
+// --------------------------------------------------------------------------
+struct thread_executor {
+    template<class Task>
+    void operator()(size_t num_tasks, Task& task) const {
+        std::atomic<size_t> next{ 0 };
+        std::exception_ptr  error;
+        std::mutex          error_mutex;
+        auto                work = [&]() {
+            try {
+                for (size_t i = next++; i < num_tasks; i = next++)
+                    task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+                next = num_tasks;
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < (std::min)(num_threads, num_tasks); ++t)
+            threads.emplace_back(work);
+        work();
+        for (auto& th : threads)
+            th.join();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    size_t num_threads;
+};
+
+// --------------------------------------------------------------------------
+// Calls `task(i)` for i in [0, num_tasks), possibly concurrently, with the
+// `exec` argument of the multi-threaded extensions (raw_hash_set::rehash,
+// parallel_hash_set::parallel_insert...), which is either:
+//   - a number of threads, started for the call
+//   - an executor hook: a callable `exec(num_tasks, task)` which must call
+//     `task(i)` once for each `i` in [0, num_tasks), possibly concurrently,
+//     and return when all the tasks have completed
+//   - a standard execution policy, e.g. std::execution::par
+// With a number of threads, an exception thrown by a task is rethrown to the
+// caller (see thread_executor). An executor hook is responsible for doing the
+// same, and a standard parallel policy calls std::terminate.
+// --------------------------------------------------------------------------
+template<class Executor, class Task>
+void run_tasks(Executor&& exec, size_t num_tasks, Task&& task) {
+    if constexpr (std::is_integral_v<std::remove_cvref_t<Executor>>) {
+        thread_executor{ static_cast<size_t>(exec) }(num_tasks, task);
+    } else if constexpr (std::is_invocable_v<Executor&, size_t, Task&>) {
+        exec(num_tasks, task);
+    } else {
+        std::vector<size_t> tasks(num_tasks);
+        for (size_t i = 0; i < num_tasks; ++i)
+            tasks[i] = i;
+        std::for_each(std::forward<Executor>(exec), tasks.begin(), tasks.end(), task);
+    }
+}
+
 template<class Policy, class Hash, class Eq, class Alloc>
 class raw_hash_set;
 
 inline bool IsValidCapacity(size_t n) { return ((n + 1) & n) == 0 && n > 0; }
 
+// The capacities of the tight tables (see raw_hash_set::kTight) can also
+// be any multiple of the group width minus 1.
+inline bool IsValidTightCapacity(size_t n) { return IsValidCapacity(n) || (n + 1) % Group::kWidth == 0; }
+
 // --------------------------------------------------------------------------
 // PRECONDITION:
-//   IsValidCapacity(capacity)
+//   IsValidTightCapacity(capacity) and !is_small()
 //   ctrl[capacity] == kSentinel
 //   ctrl[i] != kSentinel for all i < capacity
 // Applies mapping for every byte in ctrl:
@@ -1034,7 +1632,7 @@ inline bool IsValidCapacity(size_t n) { return ((n + 1) & n) == 0 && n > 0; }
 // --------------------------------------------------------------------------
 inline void ConvertDeletedToEmptyAndFullToDeleted(ctrl_t* GTL_RESTRICT ctrl, size_t capacity) {
     assert(ctrl[capacity] == kSentinel);
-    assert(IsValidCapacity(capacity));
+    assert(IsValidTightCapacity(capacity));
     for (ctrl_t* pos = ctrl; pos != ctrl + capacity + 1; pos += Group::kWidth) {
         Group{ pos }.ConvertSpecialToEmptyAndFullToDeleted(pos);
     }
@@ -1049,39 +1647,69 @@ inline void ConvertDeletedToEmptyAndFullToDeleted(ctrl_t* GTL_RESTRICT ctrl, siz
 inline size_t NormalizeCapacity(size_t n) { return n ? ~size_t{} >> LeadingZeros(n) : 1; }
 
 // --------------------------------------------------------------------------
-// We use 7/8th as maximum load factor.
-// For 16-wide groups, that gives an average of two empty slots per group.
+// Same for the tight tables: capacities of at least `Group::kWidth - 1` are
+// rounded up to the next multiple of the group width minus 1.
 // --------------------------------------------------------------------------
-inline size_t CapacityToGrowth(size_t capacity) {
-    assert(IsValidCapacity(capacity));
-    // `capacity*7/8`
-    if constexpr (Group::kWidth == 8) {
-        if (capacity == 7) {
-            // x-x/8 does not work when x==7.
-            return 6;
-        }
-    }
-    return capacity - capacity / 8;
+inline size_t NormalizeTightCapacity(size_t n) {
+    return n < Group::kWidth - 1 ? NormalizeCapacity(n) : n | (Group::kWidth - 1);
 }
 
 // --------------------------------------------------------------------------
-// From desired "growth" to a lowerbound of the necessary capacity.
-// Might not be a valid one and required NormalizeCapacity().
+// The maximum load factor is kept in 1/256ths. We use 7/8th by default.
+// For 16-wide groups, that gives an average of two empty slots per group.
+// It can be set from 1/8th, for lookups which almost always end in the first
+// group, to 15/16th, for tables which must use as little memory as possible.
 // --------------------------------------------------------------------------
-inline size_t GrowthToLowerboundCapacity(size_t growth) {
-    // `growth*8/7`
-    if constexpr (Group::kWidth == 8) {
-        if (growth == 7) {
-            // x+(x-1)/7 does not work when x==7.
-            return 8;
-        }
-    }
-    return growth + static_cast<size_t>((static_cast<int64_t>(growth) - 1) / 7);
+using max_load_t = uint8_t;
+
+inline constexpr max_load_t kDefaultMaxLoad = 224; // 7/8
+inline constexpr max_load_t kMinMaxLoad     = 32;  // 1/8
+inline constexpr max_load_t kMaxMaxLoad     = 240; // 15/16
+
+inline max_load_t ToMaxLoad(float f) {
+    float l = f * 256.0f + 0.5f;
+    if (!(l >= kMinMaxLoad)) // also catches NaN
+        return kMinMaxLoad;
+    return l >= kMaxMaxLoad ? kMaxMaxLoad : static_cast<max_load_t>(l);
 }
 
-namespace hashtable_debug_internal {
+inline float FromMaxLoad(max_load_t max_load) { return max_load / 256.0f; }
 
-// If it is a map, call get<0>().
+// --------------------------------------------------------------------------
+// `capacity*max_load/256`, keeping at least one empty slot in tables which
+// are not small.
+// --------------------------------------------------------------------------
+inline size_t CapacityToGrowth(size_t capacity, max_load_t max_load = kDefaultMaxLoad) {
+    assert(IsValidTightCapacity(capacity));
+    const size_t empty  = 256 - max_load;
+    size_t       growth = capacity - ((capacity >> 8) * empty + (((capacity & 255) * empty) >> 8));
+    if (growth == capacity && capacity >= Group::kWidth - 1) {
+        // e.g. x-x/8 when x==7 and Group::kWidth==8.
+        --growth;
+    }
+    return growth;
+}
+
+// --------------------------------------------------------------------------
+// From desired "growth" to a lowerbound of the necessary capacity.
+// Might not be a valid one and required NormalizeCapacity().
+// --------------------------------------------------------------------------
+inline size_t GrowthToLowerboundCapacity(size_t growth, max_load_t max_load = kDefaultMaxLoad) {
+    // `(growth-1)*256/max_load + 1`, the inverse of CapacityToGrowth()
+    if (growth == 0)
+        return 0;
+    const size_t empty    = 256 - max_load;
+    size_t       capacity = growth + (growth - 1) / max_load * empty + ((growth - 1) % max_load * empty) / max_load;
+    if (capacity == growth && capacity >= Group::kWidth - 1) {
+        // e.g. x+(x-1)/7 when x==7 and Group::kWidth==8.
+        ++capacity;
+    }
+    return capacity;
+}
+
+namespace hashtable_debug_internal {
+
+// If it is a map, call get<0>().
 using std::get;
 template<typename T, typename = typename T::mapped_type>
 auto GetKey(const typename T::value_type& pair, int) -> decltype(get<0>(pair)) {
@@ -1289,6 +1917,24 @@ private:
     template<class P>
     struct ConstantIteratorsImpl<P, std::void_t<typename P::constant_iterators>> : P::constant_iterators {};
 
+    template<class P = Policy, class = void>
+    struct IncrementalRehashImpl : std::false_type {};
+
+    template<class P>
+    struct IncrementalRehashImpl<P, std::void_t<typename P::incremental_rehash>> : P::incremental_rehash {};
+
+    template<class P = Policy, class = void>
+    struct CachedHashImpl : std::false_type {};
+
+    template<class P>
+    struct CachedHashImpl<P, std::void_t<typename P::cached_hash>> : P::cached_hash {};
+
+    template<class P = Policy, class = void>
+    struct TightCapacityImpl : std::false_type {};
+
+    template<class P>
+    struct TightCapacityImpl<P, std::void_t<typename P::tight_capacity>> : P::tight_capacity {};
+
 public:
     using slot_type = typename Policy::slot_type; // The actual object stored in the hash table.
 
@@ -1309,6 +1955,26 @@ public:
     // ----------------------------------------------------------------------------
     using constant_iterators = ConstantIteratorsImpl<>;
 
+    // Policies can set this variable to tell raw_hash_set to grow incrementally
+    // (see IncrementalRehashPolicy).
+    // Defaults to false if not provided by the policy.
+    // ----------------------------------------------------------------------------
+    using incremental_rehash = IncrementalRehashImpl<>;
+
+    // Policies can set this variable to tell raw_hash_set that each slot stores
+    // the full hash of its element, accessed with `stored_hash()` (see
+    // CachedHashPolicy).
+    // Defaults to false if not provided by the policy.
+    // ----------------------------------------------------------------------------
+    using cached_hash = CachedHashImpl<>;
+
+    // Policies can set this variable to tell raw_hash_set to use capacities
+    // which are not powers of 2, and to grow by a smaller factor (see
+    // TightCapacityPolicy).
+    // Defaults to false if not provided by the policy.
+    // ----------------------------------------------------------------------------
+    using tight_capacity = TightCapacityImpl<>;
+
     // PRECONDITION: `slot` is UNINITIALIZED
     // POSTCONDITION: `slot` is INITIALIZED
     // ----------------------------------------------------------------------------
@@ -1350,6 +2016,13 @@ public:
         return P::element(slot);
     }
 
+    // Returns the hash stored in `slot`, only if `cached_hash` is true.
+    // ----------------------------------------------------------------------------
+    template<class P = Policy>
+    static auto stored_hash(slot_type* slot) -> decltype(P::stored_hash(slot)) {
+        return P::stored_hash(slot);
+    }
+
     // Returns the amount of memory owned by `slot`, exclusive of `sizeof(*slot)`.
     //
     // If `slot` is nullptr, returns the constant amount of memory owned by any
@@ -1555,7 +2228,7 @@ private:
     using Layout = priv::Layout<ctrl_t, slot_type>;
 
     static Layout MakeLayout(size_t capacity) {
-        assert(IsValidCapacity(capacity));
+        assert(is_valid_capacity(capacity));
         return Layout(capacity + Group::kWidth + 1, capacity);
     }
 
@@ -1584,6 +2257,75 @@ private:
     template<class... Ts>
     using IsDecomposable = IsDecomposable<void, PolicyTraits, Hash, Eq, Ts...>;
 
+    // Hash caching: each slot stores the full hash of its element, so that
+    // resizing does not hash the keys again, and lookups only compare the keys
+    // of elements whose full hash matches, not just the 7 bits of H2. This
+    // pays off for keys which are expensive to hash or compare, like strings.
+    // -------------------------------------------------------------------------
+    static constexpr bool kCachedHash = PolicyTraits::cached_hash::value;
+
+    // Incremental rehashing: when a large table is full, instead of moving all
+    // its elements at once, a table of twice the capacity is allocated and the
+    // previous slot array is kept as a "draining" table. Every insertion then
+    // moves the elements of a bounded number of its slots to the new table,
+    // and lookups, erasures and iteration consult both tables until the
+    // draining table is empty.
+    // -------------------------------------------------------------------------
+    static constexpr bool kIncremental = PolicyTraits::incremental_rehash::value;
+
+    // Tight capacities: the capacity of a table is not always a power of 2
+    // minus 1, but can be any multiple of the group width minus 1, and a full
+    // table grows by 1.5x instead of 2x. So a table never uses more than 1.5x
+    // the memory it needs, and `reserve(n)` allocates about the memory needed
+    // for `n` elements. The first group of a probe sequence is found with a
+    // multiply-shift (FastRange) instead of a mask, and the following groups
+    // are probed linearly. Resizes are more frequent, each element being moved
+    // about 3 times instead of 2 while the table grows.
+    // -------------------------------------------------------------------------
+    static constexpr bool kTight = PolicyTraits::tight_capacity::value;
+    static_assert(!(kTight && kIncremental), "tight tables do not support incremental rehashing");
+
+    using probe_seq_t = probe_seq<Group::kWidth, kTight>;
+
+    static bool is_valid_capacity(size_t n) {
+        if constexpr (kTight)
+            return IsValidTightCapacity(n);
+        else
+            return IsValidCapacity(n);
+    }
+
+    static size_t normalize_capacity(size_t n) {
+        if constexpr (kTight)
+            return NormalizeTightCapacity(n);
+        else
+            return NormalizeCapacity(n);
+    }
+
+    // the capacity of the table when it grows
+    size_t next_capacity() const {
+        if constexpr (kTight)
+            return NormalizeTightCapacity(capacity_ + capacity_ / 2 + 1);
+        else
+            return capacity_ * 2 + 1;
+    }
+
+    struct draining_table {
+        ctrl_t*    ctrl     = nullptr;
+        slot_type* slots    = nullptr;
+        size_t     capacity = 0;
+        size_t     size     = 0; // elements not moved to the new table yet
+        size_t     pos      = 0; // next slot to move
+
+        bool owns(const ctrl_t* c) const { return c >= ctrl && c < ctrl + capacity; }
+    };
+
+    // Where an iterator continues when it reaches the end of the current slot
+    // array: the draining table, if any.
+    struct next_array {
+        ctrl_t*    ctrl  = nullptr;
+        slot_type* slots = nullptr;
+    };
+
 public:
     class iterator {
         friend class raw_hash_set;
@@ -1642,11 +2384,14 @@ public:
         friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
 
     private:
+        using next_type = std::conditional_t<kIncremental, next_array, priv::empty>;
+
         iterator(ctrl_t* ctrl)
             : ctrl_(ctrl) {} // for end()
-        iterator(ctrl_t* ctrl, slot_type* slot)
+        iterator(ctrl_t* ctrl, slot_type* slot, next_type next = {})
             : ctrl_(ctrl)
-            , slot_(slot) {}
+            , slot_(slot)
+            , next_(next) {}
 
         void skip_empty_or_deleted() {
             if constexpr (!std_alloc_t::value) {
@@ -1664,6 +2409,14 @@ public:
                 ctrl_ += shift;
                 slot_ += shift;
             }
+            if constexpr (kIncremental) {
+                // reached the sentinel of the new table: continue with the draining one
+                if (next_.ctrl && *ctrl_ == kSentinel) {
+                    ctrl_ = std::exchange(next_.ctrl, nullptr);
+                    slot_ = next_.slots;
+                    skip_empty_or_deleted();
+                }
+            }
         }
 
         ctrl_t* ctrl_ = nullptr;
@@ -1673,6 +2426,7 @@ public:
         union {
             slot_type* slot_;
         };
+        GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS next_type next_;
     };
 
     class const_iterator {
@@ -1723,7 +2477,7 @@ public:
         : ctrl_(EmptyGroup<std_alloc_t>())
         , settings_(0, hashfn, eq, alloc) {
         if (bucket_cnt) {
-            size_t new_capacity = NormalizeCapacity(bucket_cnt);
+            size_t new_capacity = normalize_capacity(bucket_cnt);
             reset_growth_left(new_capacity);
             initialize_slots(new_capacity);
             capacity_ = new_capacity;
@@ -1762,6 +2516,19 @@ public:
     raw_hash_set(InputIter first, InputIter last, const allocator_type& alloc)
         : raw_hash_set(first, last, 0, hasher(), key_equal(), alloc) {}
 
+    // PRECONDITION: the keys in [first, last) are distinct.
+    template<class InputIter>
+    raw_hash_set(from_unique_range_t,
+                 InputIter             first,
+                 InputIter             last,
+                 size_t                bucket_cnt = 0,
+                 const hasher&         hashfn     = hasher(),
+                 const key_equal&      eq         = key_equal(),
+                 const allocator_type& alloc      = allocator_type())
+        : raw_hash_set(bucket_cnt, hashfn, eq, alloc) {
+        insert_unique_unchecked(first, last);
+    }
+
     // ----------------------------------------------------------------------------
     // Instead of accepting std::initializer_list<value_type> as the first
     // argument like std::unordered_set<value_type> does, we have two overloads
@@ -1827,14 +2594,18 @@ public:
 
     raw_hash_set(const raw_hash_set& that, const allocator_type& a)
         : raw_hash_set(0, that.hash_ref(), that.eq_ref(), a) {
-        rehash(that.capacity()); // operator=() should preserve load_factor
+        // operator=() should preserve load_factor. `that` may hold more elements than
+        // its capacity allows while it is rehashing incrementally.
+        max_load_ = that.max_load_;
+        rehash((std::max)(that.capacity(), GrowthToLowerboundCapacity(that.size(), max_load_)));
         // Because the table is guaranteed to be empty, we can do something faster
         // than a full `insert`.
-        for (const auto& v : that) {
-            const size_t hashval = PolicyTraits::apply(HashElement{ hash_ref() }, v);
+        for (auto it = that.begin(); it != that.end(); ++it) {
+            const size_t hashval = that.hash_of(it.inner_.slot_);
             auto         target  = find_first_non_full(hashval);
             set_ctrl(target.offset, H2(hashval));
-            emplace_at(target.offset, v);
+            set_hash(target.offset, hashval);
+            emplace_at(target.offset, *it);
         }
         size_ = that.size();
         growth_left() -= that.size();
@@ -1852,7 +2623,9 @@ public:
         // `that` must be left valid. If Hash is std::function<Key>, moving it
         // would create a nullptr functor that cannot be called.
         // -------------------------------------------------------------------
-        settings_(std::move(that.settings_)) {
+        settings_(std::move(that.settings_))
+        , max_load_(that.max_load_)
+        , old_(std::exchange(that.old_, {})) {
         // growth_left was copied above, reset the one from `that`.
         that.growth_left() = 0;
     }
@@ -1862,13 +2635,15 @@ public:
         , slots_(nullptr)
         , size_(0)
         , capacity_(0)
-        , settings_(0, that.hash_ref(), that.eq_ref(), a) {
+        , settings_(0, that.hash_ref(), that.eq_ref(), a)
+        , max_load_(that.max_load_) {
         if (a == that.alloc_ref()) {
             std::swap(ctrl_, that.ctrl_);
             std::swap(slots_, that.slots_);
             std::swap(size_, that.size_);
             std::swap(capacity_, that.capacity_);
             std::swap(growth_left(), that.growth_left());
+            std::swap(old_, that.old_);
         } else {
             reserve(that.size());
             // Note: this will copy elements of dense_set and unordered_set instead of
@@ -1905,6 +2680,11 @@ public:
 #if 0 // GTL_BIDIRECTIONAL
         return iterator_at(capacity_);
 #else
+        if constexpr (kIncremental) {
+            // iteration visits the draining table last
+            if (old_.ctrl)
+                return { old_.ctrl + old_.capacity };
+        }
         return { ctrl_ + capacity_ };
 #endif
     }
@@ -1922,6 +2702,7 @@ public:
     GTL_ATTRIBUTE_REINITIALIZES void clear() {
         if (empty())
             return;
+        destroy_draining();
         if (capacity_) {
             if constexpr (!std::is_trivially_destructible<typename PolicyTraits::value_type>::value ||
                           std::is_same<typename Policy::is_flat, std::false_type>::value) {
@@ -1936,6 +2717,7 @@ public:
             reset_ctrl(capacity_);
             reset_growth_left(capacity_);
         }
+        reclaim(0);
         assert(empty());
     }
 
@@ -2015,11 +2797,30 @@ public:
         static constexpr bool value = std::is_same_v<decltype(test<T>(0)), yes>;
     };
 
+    // When the size of the range is known, we reserve once and then insert the
+    // elements in blocks: the hashes of a block are computed and their groups
+    // prefetched before the elements are placed, so that the cache misses of
+    // the block overlap.
+    // -------------------------------------------------------------------------
     template<class InputIt, typename std::enable_if_t<has_difference_operator<InputIt>::value, int> = 0>
     void insert(InputIt first, InputIt last) {
         this->reserve(this->size() + (last - first));
-        for (; first != last; ++first)
-            emplace(*first);
+        if constexpr (IsDecomposable<decltype(*first)>::value) {
+            size_t hashes[kLookupBatch];
+            while (first != last) {
+                size_t  cnt = (std::min)(kLookupBatch, static_cast<size_t>(last - first));
+                InputIt it  = first;
+                for (size_t j = 0; j < cnt; ++j, ++it) {
+                    hashes[j] = PolicyTraits::apply(HashElement{ hash_ref() }, *it);
+                    prefetch_hash(hashes[j]);
+                }
+                for (size_t j = 0; j < cnt; ++j, ++first)
+                    emplace_with_hash(hashes[j], *first);
+            }
+        } else {
+            for (; first != last; ++first)
+                emplace(*first);
+        }
     }
 
     template<class InputIt, typename std::enable_if_t<!has_difference_operator<InputIt>::value, int> = 0>
@@ -2041,6 +2842,7 @@ public:
         const auto& elem = PolicyTraits::element(CommonAccess::GetSlot(node));
         auto res = PolicyTraits::apply(InsertSlot<false>{ *this, std::move(*CommonAccess::GetSlot(node)) }, elem);
         if (res.second) {
+            adopt(res.first, node.get_allocator());
             CommonAccess::Reset(&node);
             return { res.first, true, node_type() };
         } else {
@@ -2055,6 +2857,7 @@ public:
         auto        res  = PolicyTraits::apply(
             InsertSlotWithHash<false>{ *this, std::move(*CommonAccess::GetSlot(node)), hashval }, elem);
         if (res.second) {
+            adopt(res.first, node.get_allocator());
             CommonAccess::Reset(&node);
             return { res.first, true, node_type() };
         } else {
@@ -2068,6 +2871,46 @@ public:
         return res.position;
     }
 
+    // Extension API: insertion of elements whose keys are known not to be in
+    // the table, for example when rebuilding a table from a deduplicated
+    // source. The element is placed in the first empty or deleted slot of its
+    // probe sequence, without any key comparison.
+    //
+    // PRECONDITION: no element with an equal key is present in the table, or
+    // earlier in the inserted range. This is checked by an assert in debug
+    // builds; in release builds a duplicate key would be inserted twice.
+    // -----------------------------------------------------------------
+    template<class T, typename std::enable_if_t<IsDecomposable<T>::value, int> = 0>
+    iterator insert_unique_unchecked(T&& value) {
+        size_t hashval = PolicyTraits::apply(HashElement{ hash_ref() }, value);
+        return iterator_at(emplace_unique_unchecked(hashval, std::forward<T>(value)));
+    }
+
+    iterator insert_unique_unchecked(init_type&& value) {
+        return insert_unique_unchecked<init_type>(std::move(value));
+    }
+
+    template<class InputIt>
+    void insert_unique_unchecked(InputIt first, InputIt last) {
+        if constexpr (has_difference_operator<InputIt>::value) {
+            this->reserve(this->size() + (last - first));
+            size_t hashes[kLookupBatch];
+            while (first != last) {
+                size_t  cnt = (std::min)(kLookupBatch, static_cast<size_t>(last - first));
+                InputIt it  = first;
+                for (size_t j = 0; j < cnt; ++j, ++it) {
+                    hashes[j] = PolicyTraits::apply(HashElement{ hash_ref() }, *it);
+                    prefetch_hash(hashes[j]);
+                }
+                for (size_t j = 0; j < cnt; ++j, ++first)
+                    emplace_unique_unchecked(hashes[j], *first);
+            }
+        } else {
+            for (; first != last; ++first)
+                insert_unique_unchecked(*first);
+        }
+    }
+
     // This overload kicks in if we can deduce the key from args. This enables us
     // to avoid constructing value_type if an entry with the same key already
     // exists.
@@ -2269,6 +3112,8 @@ public:
         assert(it != end());
         PolicyTraits::destroy(&alloc_ref(), it.slot_);
         erase_meta_only(it);
+        if (!size_)
+            reclaim(0); // no element left whose storage would move
     }
     void _erase(const_iterator cit) { _erase(cit.inner_); }
 
@@ -2296,8 +3141,10 @@ public:
     void merge(raw_hash_set<Policy, H, E, Alloc>& src) { // NOLINT
         assert(this != &src);
         for (auto it = src.begin(), e = src.end(); it != e; ++it) {
-            if (PolicyTraits::apply(InsertSlot<false>{ *this, std::move(*it.slot_) }, PolicyTraits::element(it.slot_))
-                    .second) {
+            auto res =
+                PolicyTraits::apply(InsertSlot<false>{ *this, std::move(*it.slot_) }, PolicyTraits::element(it.slot_));
+            if (res.second) {
+                adopt(res.first, src.alloc_ref());
                 src.erase_meta_only(it);
             }
         }
@@ -2308,6 +3155,42 @@ public:
         merge(src);
     }
 
+    // Called on an element moved in from a table (or a node handle) with the
+    // allocator `from`, so that the policy can copy what the element still
+    // references in that allocator to this table's (see
+    // StringFlatHashMapPolicy::adopt).
+    // ----------------------------------------------------------------------------
+    void adopt(iterator it, const allocator_type& from) {
+        if constexpr (requires(allocator_type* a, slot_type* slot) { Policy::adopt(a, *a, slot); }) {
+            if (!(alloc_ref() == from))
+                Policy::adopt(&alloc_ref(), from, it.slot_);
+        }
+    }
+
+    // Lets the policy release what the erased elements still hold in the
+    // allocator (see StringFlatHashMapPolicy::reclaimable): the allocator is
+    // renewed, and the elements copy what they reference to the new one.
+    // `visit_cost` is the work of visiting the slots, in bytes, which is 0
+    // right after a rehash or when the table is empty.
+    //
+    // As this moves what the elements reference (the long keys of a
+    // string_flat_hash_map), it only runs where the references to the
+    // elements are invalidated anyway: in clear(), rehash() and the resizes,
+    // and in compact(). erase() only calls it once no element is left.
+    // ----------------------------------------------------------------------------
+    void reclaim(size_t visit_cost) {
+        if constexpr (!kIncremental && requires(allocator_type* a, slot_type* slot) { Policy::rekey(a, slot); }) {
+            if (!Policy::reclaimable(alloc_ref(), size_, size_ ? visit_cost : 0))
+                return;
+            allocator_type old = alloc_ref(); // keeps the elements' storage alive while they are copied
+            Policy::renew(&alloc_ref());
+            for (size_t i = 0; size_ && i != capacity_; ++i) {
+                if (IsFull(ctrl_[i]))
+                    Policy::rekey(&alloc_ref(), slots_ + i);
+            }
+        }
+    }
+
     node_type extract(const_iterator position) {
         auto node = CommonAccess::Make<node_type>(alloc_ref(), position.inner_.slot_);
         erase_meta_only(position);
@@ -2330,6 +3213,8 @@ public:
         swap(size_, that.size_);
         swap(capacity_, that.capacity_);
         swap(growth_left(), that.growth_left());
+        swap(max_load_, that.max_load_);
+        swap(old_, that.old_);
         swap(hash_ref(), that.hash_ref());
         swap(eq_ref(), that.eq_ref());
         if constexpr (AllocTraits::propagate_on_container_swap::value) {
@@ -2346,6 +3231,10 @@ public:
 
     template<typename InputArchive>
     bool phmap_load(InputArchive&);
+
+    // dumps the table in the layout read in place by gtl::mapped_flat_hash_map
+    template<typename OutputArchive>
+    bool phmap_dump_mappable(OutputArchive&) const;
 #endif
 
     void rehash(size_t n) {
@@ -2355,17 +3244,160 @@ public:
             destroy_slots();
             return;
         }
-        // bitor is a faster way of doing `max` here. We will round up to the next
-        // power-of-2-minus-1, so bitor is good enough.
-        // ----------------------------------------------------------------------------
-        auto m = NormalizeCapacity((std::max)(n, size()));
+        auto m = normalize_capacity((std::max)(n, GrowthToLowerboundCapacity(size(), max_load_)));
         // n == 0 unconditionally rehashes as per the standard.
         if (n == 0 || m > capacity_) {
             resize(m);
         }
     }
 
-    void reserve(size_t n) { rehash(GrowthToLowerboundCapacity(n)); }
+    void reserve(size_t n) { rehash(GrowthToLowerboundCapacity(n, max_load_)); }
+
+    // Extension API: multi-threaded rehash/reserve.
+    //
+    // Same as rehash(n) / reserve(n), but when the table is resized, the old
+    // slot array is split into ranges which are moved into the new table
+    // concurrently. `exec` is a number of threads, an executor hook or a
+    // standard execution policy (see run_tasks).
+    //
+    // The hasher and the allocator must be safe to call concurrently. Small
+    // tables are resized on the calling thread.
+    // -------------------------------------------------------------------------
+    template<class Executor>
+    void rehash(size_t n, Executor&& exec) {
+        if (n == 0 || size() < kParallelResizeMinSize) {
+            rehash(n);
+            return;
+        }
+        auto m = normalize_capacity((std::max)(n, GrowthToLowerboundCapacity(size(), max_load_)));
+        if (m > capacity_)
+            resize(m, std::forward<Executor>(exec));
+    }
+
+    template<class Executor>
+    void reserve(size_t n, Executor&& exec) {
+        rehash(GrowthToLowerboundCapacity(n, max_load_), std::forward<Executor>(exec));
+    }
+
+    // Where a compact() pass stands between two calls. A copy starts a new
+    // pass.
+    // -------------------------------------------------------------------------
+    class compact_cursor {
+    public:
+        compact_cursor() = default;
+        compact_cursor(const compact_cursor&) {}
+        compact_cursor& operator=(const compact_cursor&) {
+            phase_ = kIdle;
+            ctrl_  = nullptr;
+            needed_.reset();
+            return *this;
+        }
+
+    private:
+        friend class raw_hash_set;
+
+        enum Phase { kIdle, kMarkDeleted, kMarkPaths, kSweep };
+
+        Phase                       phase_    = kIdle;
+        const ctrl_t*               ctrl_     = nullptr; // slot array of the current or last pass
+        size_t                      capacity_ = 0;
+        size_t                      pos_      = 0; // next slot of the current phase
+        size_t                      deleted_  = 0; // tombstones left by the last pass
+        std::unique_ptr<uint64_t[]> needed_;       // one bit per slot, see compact()
+    };
+
+    // Extension API: bounded tombstone cleanup. Turns the tombstones (deleted
+    // slots left by erasures) which no lookup goes through back into empty
+    // slots, in steps of at most `budget` groups of slots, and returns the
+    // unused part of the budget: a call returning a non-zero value has
+    // nothing left to do until the next erasures. So a table can be cleaned
+    // up a little at a time, without the pause of rehashing it in place:
+    //
+    //   typename Set::compact_cursor c;
+    //   while (s.compact(c, 16) == 0)
+    //       do_something_else();
+    //
+    // A pass has three phases, each visiting the whole slot array a group at
+    // a time: the tombstones become kDeletedOld, then the slots of the groups
+    // probed before reaching each element are recorded, then the kDeletedOld
+    // slots which were not recorded become empty, and the others kDeleted
+    // again. A kDeletedOld slot stays a tombstone until the end of the pass,
+    // so an element inserted meanwhile never probes past it, and the lookup
+    // of an element present during the whole pass goes through recorded
+    // slots only. A resize starts a new pass.
+    //
+    // The elements of the draining table of an _incremental table, if any,
+    // are moved first, which would otherwise only happen on insertions. A
+    // string_flat_hash_map first moves its long keys to a new arena, when
+    // the erased ones take enough of the current one (see reclaim()), which
+    // invalidates the string_views of the keys.
+    // -------------------------------------------------------------------------
+    size_t compact(compact_cursor& c, size_t budget) {
+        if constexpr (kIncremental) {
+            for (; budget && old_.ctrl; --budget)
+                drain_some();
+        }
+        if (budget)
+            reclaim(capacity_ * sizeof(slot_type));
+        if (c.ctrl_ != ctrl_ || c.capacity_ != capacity_) {
+            c.phase_ = compact_cursor::kIdle; // resized since the last call
+            c.needed_.reset();
+        }
+        if (c.phase_ == compact_cursor::kIdle) {
+            if (!budget || is_small() || num_deleted() <= compact_baseline(c))
+                return budget;
+            c.phase_    = compact_cursor::kMarkDeleted;
+            c.ctrl_     = ctrl_;
+            c.capacity_ = capacity_;
+            c.pos_      = 0;
+        }
+        for (; budget; --budget) {
+            const size_t first = c.pos_;
+            const size_t last  = (std::min)(first + Group::kWidth, capacity_);
+            switch (c.phase_) {
+            case compact_cursor::kMarkDeleted:
+                for (size_t i = first; i != last; ++i) {
+                    if (ctrl_[i] == kDeleted)
+                        set_ctrl(i, kDeletedOld);
+                }
+                break;
+            case compact_cursor::kMarkPaths:
+                for (size_t i = first; i != last; ++i) {
+                    if (IsFull(ctrl_[i]))
+                        mark_probe_path(i, c.needed_.get());
+                }
+                break;
+            default:
+                for (size_t i = first; i != last; ++i) {
+                    if (ctrl_[i] != kDeletedOld)
+                        continue;
+                    if (c.needed_[i / 64] & (uint64_t(1) << (i % 64))) {
+                        set_ctrl(i, kDeleted);
+                    } else {
+                        set_ctrl(i, kEmpty);
+                        ++growth_left();
+                    }
+                }
+                break;
+            }
+            c.pos_ = last;
+            if (last != capacity_)
+                continue;
+            c.pos_ = 0;
+            if (c.phase_ == compact_cursor::kMarkDeleted) {
+                c.phase_ = compact_cursor::kMarkPaths;
+                c.needed_.reset(new uint64_t[capacity_ / 64 + 1]()); // + 1 for the sentinel
+            } else if (c.phase_ == compact_cursor::kMarkPaths) {
+                c.phase_ = compact_cursor::kSweep;
+            } else {
+                c.phase_   = compact_cursor::kIdle;
+                c.deleted_ = num_deleted();
+                c.needed_.reset();
+                return budget - 1;
+            }
+        }
+        return 0;
+    }
 
     // Extension API: support for heterogeneous keys.
     //
@@ -2387,7 +3419,22 @@ public:
     // NOTE: This is a very low level operation and should not be used without
     // specific benchmarks indicating its importance.
     // -----------------------------------------------------------------------
-    void prefetch_hash(size_t) const {
+    void prefetch_hash(size_t hashval) const {
+        if constexpr (!std_alloc_t::value) {
+            // ctrl_ could be nullptr
+            if (!ctrl_)
+                return;
+        }
+        auto seq = probe(hashval);
+#if defined(_MSC_VER) && GTL_HAVE_SSE2
+        _mm_prefetch(reinterpret_cast<const char*>(ctrl_ + seq.offset()), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(slots_ + seq.offset()), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(static_cast<const void*>(ctrl_ + seq.offset()));
+        __builtin_prefetch(static_cast<const void*>(slots_ + seq.offset()));
+#else
+        (void)seq;
+#endif
     }
 
     template<class K = key_type>
@@ -2417,7 +3464,7 @@ public:
     pointer find_ptr(const key_arg<K>& key, size_t hashval) {
         size_t offset;
         if (find_impl(key, hashval, offset))
-            return &PolicyTraits::element(slots_ + offset);
+            return &PolicyTraits::element(iterator_at(offset).slot_);
         else
             return nullptr;
     }
@@ -2446,6 +3493,40 @@ public:
         return find(key, hashval) != end();
     }
 
+    // Batched lookup: `out[i]` receives `find(keys[i])`.
+    //
+    // The keys are processed in blocks of kLookupBatch: every key of a block
+    // is hashed and its group prefetched before any of them is probed, so the
+    // cache misses of the whole block overlap instead of being paid one at a
+    // time. `out` must be a random access iterator (or pointer) with room for
+    // `keys.size()` results. For heterogeneous keys, specify K explicitly:
+    //
+    //   s.find_many<std::string_view>(views, its.begin());
+    // --------------------------------------------------------------------------
+    template<class K = key_type, class OutIt>
+    void find_many(std::type_identity_t<std::span<const K>> keys, OutIt out) {
+        batch_lookup<K>(keys, [&](size_t i, size_t offset, bool found) { out[i] = found ? iterator_at(offset) : end(); });
+    }
+
+    template<class K = key_type, class OutIt>
+    void find_many(std::type_identity_t<std::span<const K>> keys, OutIt out) const {
+        const_cast<raw_hash_set*>(this)->batch_lookup<K>(
+            keys, [&](size_t i, size_t offset, bool found) { out[i] = found ? iterator_at(offset) : end(); });
+    }
+
+    // Batched version of contains(): `out[i]` receives `contains(keys[i])`.
+    // Returns the number of keys found.
+    // --------------------------------------------------------------------------
+    template<class K = key_type, class OutIt>
+    size_t contains_many(std::type_identity_t<std::span<const K>> keys, OutIt out) const {
+        size_t cnt = 0;
+        const_cast<raw_hash_set*>(this)->batch_lookup<K>(keys, [&](size_t i, size_t, bool found) {
+            out[i] = found;
+            cnt += found;
+        });
+        return cnt;
+    }
+
     template<class K = key_type>
     std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
         auto it = find(key);
@@ -2463,9 +3544,14 @@ public:
 
     size_t bucket_count() const { return capacity_; }
     float load_factor() const { return capacity_ ? static_cast<float>(static_cast<double>(size()) / capacity_) : 0.0f; }
-    float max_load_factor() const { return 1.0f; }
-    void  max_load_factor(float) {
-        // Does nothing.
+    float max_load_factor() const { return FromMaxLoad(max_load_); }
+
+    // Sets the maximum load factor, rounded to a multiple of 1/256 and clamped
+    // to [1/8, 15/16]. A table which is not empty is rehashed to match it.
+    void max_load_factor(float f) {
+        max_load_ = ToMaxLoad(f);
+        if (capacity_)
+            rehash(0);
     }
 
     hasher hash_function() const {
@@ -2500,6 +3586,71 @@ private:
     template<class Container, typename Enabler>
     friend struct hashtable_debug_internal::HashtableDebugAccess;
 
+    static constexpr size_t kLookupBatch = 16;
+
+    // Calls `f(i, offset, found)` for each key, hashing and prefetching a block
+    // of keys before probing them.
+    // --------------------------------------------------------------------------
+    template<class K, class F>
+    void batch_lookup(std::span<const K> keys, F&& f) {
+        size_t hashes[kLookupBatch];
+        for (size_t start = 0; start < keys.size(); start += kLookupBatch) {
+            size_t cnt = (std::min)(kLookupBatch, keys.size() - start);
+            for (size_t j = 0; j < cnt; ++j) {
+                const key_arg<K>& key = keys[start + j];
+                hashes[j]             = this->hash(key);
+                prefetch_hash(hashes[j]);
+            }
+            for (size_t j = 0; j < cnt; ++j) {
+                size_t offset = 0;
+                bool   found  = find_impl<K>(keys[start + j], hashes[j], offset);
+                f(start + j, offset, found);
+            }
+        }
+    }
+
+    template<class T>
+    static T racy_load(const T& field) {
+        return std::atomic_ref<T>(const_cast<T&>(field)).load(std::memory_order_relaxed);
+    }
+
+    // Looks up `key` while the table may be modified by another thread, and
+    // copies the matching element to `out`. Used by the optimistic readers of
+    // parallel_hash_set (see gtl::SeqMutex), which discard the result if the
+    // table changed. The table fields are read once and `valid()` is checked
+    // before they are used, so they are consistent; afterwards the slots may
+    // be overwritten, so the element is copied before its key is compared,
+    // and the probing is bounded. Requires a trivially copyable value_type
+    // (std::pair of trivially copyable types is fine), a key which can be
+    // compared even if torn (arithmetic or enum), and that the memory of
+    // previous tables stays mapped.
+    // --------------------------------------------------------------------------
+    template<class K, class Valid>
+    bool find_copy_racy(const key_arg<K>& key, size_t hashval, void* out, Valid&& valid) const {
+        static_assert(std::is_trivially_copy_constructible_v<value_type> && !kIncremental);
+        ctrl_t*    ctrl     = racy_load(ctrl_);
+        slot_type* slots    = racy_load(slots_);
+        size_t     capacity = racy_load(capacity_);
+        if (!valid() || !ctrl || !capacity)
+            return false;
+
+        auto seq = probe_seq_t(H1(hashval, ctrl), capacity);
+        while (true) {
+            Group g{ ctrl + seq.offset() };
+            for (uint32_t i : g.Match((h2_t)H2(hashval))) {
+                size_t offset = seq.offset((size_t)i);
+                if (!hash_matches(slots + offset, hashval))
+                    continue;
+                std::memcpy(out, &PolicyTraits::element(slots + offset), sizeof(value_type));
+                if (PolicyTraits::apply(EqualElement<K>{ key, eq_ref() }, *static_cast<const value_type*>(out)))
+                    return true;
+            }
+            if (g.MatchEmpty() || seq.getindex() >= capacity)
+                return false;
+            seq.next();
+        }
+    }
+
     template<class K = key_type>
     bool find_impl(const key_arg<K>& GTL_RESTRICT key, size_t hashval, size_t& GTL_RESTRICT offset) {
         if constexpr (!std_alloc_t::value) {
@@ -2512,13 +3663,49 @@ private:
             Group g{ ctrl_ + seq.offset() };
             for (uint32_t i : g.Match((h2_t)H2(hashval))) {
                 offset = seq.offset((size_t)i);
-                if (GTL_PREDICT_TRUE(
-                        PolicyTraits::apply(EqualElement<K>{ key, eq_ref() }, PolicyTraits::element(slots_ + offset))))
+                if (GTL_PREDICT_TRUE(hash_matches(slots_ + offset, hashval) &&
+                                     PolicyTraits::apply(EqualElement<K>{ key, eq_ref() },
+                                                         PolicyTraits::element(slots_ + offset))))
+                    return true;
+            }
+            if (GTL_PREDICT_TRUE(g.MatchEmpty()))
+                break;
+            seq.next();
+        }
+        if constexpr (kIncremental) {
+            return find_in_draining(hashval,
+                                    [&](const value_type& elem) {
+                                        return PolicyTraits::apply(EqualElement<K>{ key, eq_ref() }, elem);
+                                    },
+                                    offset);
+        }
+        return false;
+    }
+
+    // Looks for an element of the draining table matching `pred`. Its offset is
+    // returned with the kDrainingOffset bit set, which iterator_at() understands.
+    // -------------------------------------------------------------------------
+    static constexpr size_t kDrainingOffset = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+    template<class Pred>
+    bool find_in_draining(size_t hashval, Pred&& pred, size_t& offset) const {
+        if (old_.size == 0)
+            return false;
+        auto seq = probe_seq_t(H1(hashval, old_.ctrl), old_.capacity);
+        while (true) {
+            Group g{ old_.ctrl + seq.offset() };
+            for (uint32_t i : g.Match((h2_t)H2(hashval))) {
+                size_t idx = seq.offset((size_t)i);
+                if (GTL_PREDICT_TRUE(hash_matches(old_.slots + idx, hashval) &&
+                                     pred(std::as_const(PolicyTraits::element(old_.slots + idx))))) {
+                    offset = idx | kDrainingOffset;
                     return true;
+                }
             }
             if (GTL_PREDICT_TRUE(g.MatchEmpty()))
                 return false;
             seq.next();
+            assert(seq.getindex() < old_.capacity && "full table!");
         }
     }
 
@@ -2590,6 +3777,7 @@ private:
             if (res.second) {
                 PolicyTraits::transfer(&s.alloc_ref(), s.slots_ + res.first, &slot);
                 s.set_ctrl(res.first, H2(hashval));
+                s.set_hash(res.first, hashval);
             } else if (do_destroy) {
                 PolicyTraits::destroy(&s.alloc_ref(), &slot);
             }
@@ -2608,6 +3796,7 @@ private:
             if (res.second) {
                 PolicyTraits::transfer(&s.alloc_ref(), s.slots_ + res.first, &slot);
                 s.set_ctrl(res.first, H2(hashval));
+                s.set_hash(res.first, hashval);
             } else if (do_destroy) {
                 PolicyTraits::destroy(&s.alloc_ref(), &slot);
             }
@@ -2627,8 +3816,16 @@ private:
     void erase_meta_only(const_iterator it) {
         assert(IsFull(*it.inner_.ctrl_) && "erasing a dangling iterator");
         --size_;
+        if constexpr (kIncremental) {
+            if (old_.owns(it.inner_.ctrl_)) {
+                // nothing is ever inserted into the draining table, so a tombstone is fine
+                --old_.size;
+                set_draining_ctrl((size_t)(it.inner_.ctrl_ - old_.ctrl), kDeleted);
+                return;
+            }
+        }
         const size_t index        = (size_t)(it.inner_.ctrl_ - ctrl_);
-        const size_t index_before = (index - Group::kWidth) & capacity_;
+        const size_t index_before = kTight && is_small() ? index : index_diff(index, Group::kWidth);
         const auto   empty_after  = Group(it.inner_.ctrl_).MatchEmpty();
         const auto   empty_before = Group(ctrl_ + index_before).MatchEmpty();
 
@@ -2644,6 +3841,11 @@ private:
         growth_left() += was_never_full;
     }
 
+    // Number of kDeleted control bytes in the (new, if draining) slot array.
+    size_t num_deleted() const {
+        return capacity_ ? CapacityToGrowth(capacity_, max_load_) - (size_ - draining_size()) - growth_left() : 0;
+    }
+
     void initialize_slots(size_t new_capacity) {
         assert(new_capacity);
         if (std::is_same_v<SlotAlloc, std::allocator<slot_type>> && slots_ == nullptr) {}
@@ -2659,6 +3861,7 @@ private:
     void destroy_slots() {
         if (!capacity_)
             return;
+        destroy_draining();
 
         if constexpr (!std::is_trivially_destructible<typename PolicyTraits::value_type>::value ||
                       std::is_same<typename Policy::is_flat, std::false_type>::value) {
@@ -2681,7 +3884,7 @@ private:
     }
 
     void resize(size_t new_capacity) {
-        assert(IsValidCapacity(new_capacity));
+        assert(is_valid_capacity(new_capacity));
         auto*        old_ctrl     = ctrl_;
         auto*        old_slots    = slots_;
         const size_t old_capacity = capacity_;
@@ -2690,7 +3893,7 @@ private:
 
         for (size_t i = 0; i != old_capacity; ++i) {
             if (IsFull(old_ctrl[i])) {
-                size_t hashval = PolicyTraits::apply(HashElement{ hash_ref() }, PolicyTraits::element(old_slots + i));
+                size_t hashval = hash_of(old_slots + i);
                 auto   target  = find_first_non_full(hashval);
                 size_t new_i   = target.offset;
                 set_ctrl(new_i, H2(hashval));
@@ -2702,55 +3905,287 @@ private:
             auto layout = MakeLayout(old_capacity);
             Deallocate<Layout::Alignment()>(&alloc_ref(), old_ctrl, layout.AllocSize());
         }
+        absorb_draining();
+        reclaim(0);
     }
 
-    void drop_deletes_without_resize() GTL_ATTRIBUTE_NOINLINE {
-        assert(IsValidCapacity(capacity_));
-        assert(!is_small());
-        // ------------------------------------------------------------------------
-        // Algorithm:
-        // - mark all DELETED slots as EMPTY
-        // - mark all FULL slots as DELETED
-        // - for each slot marked as DELETED
-        //     hash = Hash(element)
-        //     target = find_first_non_full(hash)
-        //     if target is in the same group
-        //       mark slot as FULL
-        //     else if target is EMPTY
-        //       transfer element to target
-        //       mark slot as EMPTY
-        //       mark target as FULL
-        //     else if target is DELETED
-        //       swap current element with target element
-        //       mark target as FULL
-        //       repeat procedure for current slot with moved from element (target)
-        // ------------------------------------------------------------------------
-        ConvertDeletedToEmptyAndFullToDeleted(ctrl_, capacity_);
-        typename gtl::aligned_storage_t<sizeof(slot_type), alignof(slot_type)> raw;
-        slot_type* slot = reinterpret_cast<slot_type*>(&raw);
-        for (size_t i = 0; i != capacity_; ++i) {
-            if (!IsDeleted(ctrl_[i]))
-                continue;
-            size_t hashval = PolicyTraits::apply(HashElement{ hash_ref() }, PolicyTraits::element(slots_ + i));
-            auto   target  = find_first_non_full(hashval);
-            size_t new_i   = target.offset;
+    static constexpr size_t kParallelResizeMinSize = 16384; // below this, resize on one thread
+    static constexpr size_t kParallelResizeChunk   = 16384; // old slots moved by each task
 
-            // Verify if the old and new i fall within the same group wrt the hashval.
-            // If they do, we don't need to move the object as it falls already in the
-            // best probe we can.
-            // -----------------------------------------------------------------------
-            const auto probe_index = [&](size_t pos) {
-                return ((pos - probe(hashval).offset()) & capacity_) / Group::kWidth;
-            };
+    // Parallel version of resize(). The workers move disjoint ranges of the
+    // old slots, and claim their target slots in the new table with an atomic
+    // compare-exchange of the control byte from kEmpty to H2. The cloned
+    // control bytes are written once all the workers are done.
+    // -------------------------------------------------------------------------
+    template<class Executor>
+    void resize(size_t new_capacity, Executor&& exec) {
+        assert(is_valid_capacity(new_capacity));
+        auto*        old_ctrl     = ctrl_;
+        auto*        old_slots    = slots_;
+        const size_t old_capacity = capacity_;
+        initialize_slots(new_capacity);
+        capacity_ = new_capacity;
 
-            // Element doesn't move.
-            if (GTL_PREDICT_TRUE(probe_index(new_i) == probe_index(i))) {
-                set_ctrl(i, H2(hashval));
-                continue;
+        auto move_range = [&](size_t task) {
+            size_t first = task * kParallelResizeChunk;
+            size_t last  = (std::min)(first + kParallelResizeChunk, old_capacity);
+            for (size_t i = first; i != last; ++i) {
+                if (IsFull(old_ctrl[i])) {
+                    size_t hashval = hash_of(old_slots + i);
+                    size_t new_i   = claim_empty_slot(hashval);
+                    SanitizerUnpoisonObject(slots_ + new_i);
+                    PolicyTraits::transfer(&alloc_ref(), slots_ + new_i, old_slots + i);
+                }
             }
-            if (IsEmpty(ctrl_[new_i])) {
-                // Transfer element to the empty spot.
-                // set_ctrl poisons/unpoisons the slots so we have to call it at the
+        };
+
+        size_t num_tasks = (old_capacity + kParallelResizeChunk - 1) / kParallelResizeChunk;
+        run_tasks(std::forward<Executor>(exec), num_tasks, move_range);
+
+        std::memcpy(ctrl_ + capacity_ + 1, ctrl_, NumClonedBytes());
+
+        if (old_capacity) {
+            SanitizerUnpoisonMemoryRegion(old_slots, sizeof(slot_type) * old_capacity);
+            auto layout = MakeLayout(old_capacity);
+            Deallocate<Layout::Alignment()>(&alloc_ref(), old_ctrl, layout.AllocSize());
+        }
+        absorb_draining();
+        reclaim(0);
+    }
+
+    // ------------------------------------------------------------------------
+    // Incremental rehashing support (only used when kIncremental is true)
+    // ------------------------------------------------------------------------
+    static constexpr size_t kIncrementalMinCapacity = 1023;             // smaller tables are resized at once
+    static constexpr size_t kDrainSlotsPerInsert    = Group::kWidth;     // slots of the draining table moved per insert
+
+    size_t draining_size() const {
+        if constexpr (kIncremental)
+            return old_.size;
+        else
+            return 0;
+    }
+
+    // Starts growing to `new_capacity`: the current slot array becomes the
+    // draining table, and the new one starts empty.
+    void begin_incremental_resize(size_t new_capacity) {
+        assert(is_valid_capacity(new_capacity) && !old_.ctrl);
+        old_ = { ctrl_, slots_, capacity_, size_, 0 };
+        initialize_slots(new_capacity);
+        capacity_ = new_capacity;
+    }
+
+    // Called before each insertion: moves the elements of the next
+    // kDrainSlotsPerInsert slots of the draining table to the current one, and
+    // releases the draining table once it is empty.
+    void drain_some() {
+        size_t last = (std::min)(old_.pos + kDrainSlotsPerInsert, old_.capacity);
+        for (; old_.pos != last && old_.size; ++old_.pos) {
+            if (!IsFull(old_.ctrl[old_.pos]))
+                continue;
+            if (GTL_PREDICT_FALSE(growth_left() == 0)) {
+                // erasures left too many tombstones in the new table, give up
+                // and move everything at once.
+                rehash_and_grow_if_necessary();
+                if (!old_.ctrl)
+                    return;
+            }
+            slot_type* slot    = old_.slots + old_.pos;
+            size_t     hashval = hash_of(slot);
+            size_t     new_i   = find_first_non_full(hashval).offset;
+            growth_left() -= IsEmpty(ctrl_[new_i]);
+            set_ctrl(new_i, H2(hashval));
+            PolicyTraits::transfer(&alloc_ref(), slots_ + new_i, slot);
+            set_draining_ctrl(old_.pos, kDeleted);
+            --old_.size;
+        }
+        if (old_.size == 0)
+            free_draining();
+    }
+
+    // Moves all the remaining elements of the draining table to the current
+    // one, which must have room for them.
+    void absorb_draining() {
+        if constexpr (kIncremental) {
+            if (!old_.ctrl)
+                return;
+            for (size_t i = old_.pos; i != old_.capacity && old_.size; ++i) {
+                if (IsFull(old_.ctrl[i])) {
+                    slot_type* slot    = old_.slots + i;
+                    size_t     hashval = hash_of(slot);
+                    size_t     new_i   = find_first_non_full(hashval).offset;
+                    growth_left() -= IsEmpty(ctrl_[new_i]);
+                    set_ctrl(new_i, H2(hashval));
+                    PolicyTraits::transfer(&alloc_ref(), slots_ + new_i, slot);
+                    --old_.size;
+                }
+            }
+            assert(old_.size == 0);
+            free_draining();
+        }
+    }
+
+    void destroy_draining() {
+        if constexpr (kIncremental) {
+            if (!old_.ctrl)
+                return;
+            if constexpr (!std::is_trivially_destructible<typename PolicyTraits::value_type>::value ||
+                          std::is_same<typename Policy::is_flat, std::false_type>::value) {
+                for (size_t i = 0; i != old_.capacity; ++i) {
+                    if (IsFull(old_.ctrl[i]))
+                        PolicyTraits::destroy(&alloc_ref(), old_.slots + i);
+                }
+            }
+            size_ -= old_.size;
+            old_.size = 0;
+            free_draining();
+        }
+    }
+
+    void free_draining() {
+        SanitizerUnpoisonMemoryRegion(old_.slots, sizeof(slot_type) * old_.capacity);
+        auto layout = MakeLayout(old_.capacity);
+        Deallocate<Layout::Alignment()>(&alloc_ref(), old_.ctrl, layout.AllocSize());
+        old_ = {};
+    }
+
+    // Squashes the tombstones, without changing the capacity. When rehashing
+    // incrementally, the elements are moved to a new slot array over the next
+    // insertions rather than rehashed in place at once.
+    void drop_deletes() {
+        if (!try_begin_incremental_resize(capacity_))
+            drop_deletes_without_resize();
+    }
+
+    // Tombstones left by the last compact() pass over the current slot array,
+    // which a new pass would not clear either.
+    size_t compact_baseline(const compact_cursor& c) const {
+        return c.ctrl_ == ctrl_ && c.capacity_ == capacity_ ? c.deleted_ : 0;
+    }
+
+    // Work left for compact(): the elements of the draining table, and the
+    // tombstones if a pass is in progress or there are new ones since the
+    // last pass.
+    size_t compact_backlog(const compact_cursor& c) const {
+        size_t deleted = is_small() ? 0 : num_deleted();
+        if (c.phase_ == compact_cursor::kIdle && deleted <= compact_baseline(c))
+            deleted = 0;
+        return draining_size() + deleted;
+    }
+
+    // Records in `needed` the slots of the groups a lookup of the element in
+    // slot `i` goes through before reaching the group holding it.
+    void mark_probe_path(size_t i, uint64_t* needed) const {
+        auto seq = probe(hash_of(slots_ + i));
+        while (true) {
+            for (size_t j = 0; j != Group::kWidth; ++j) {
+                if (seq.offset(j) == i)
+                    return;
+            }
+            for (size_t j = 0; j != Group::kWidth; ++j) {
+                size_t k = seq.offset(j);
+                needed[k / 64] |= uint64_t(1) << (k % 64);
+            }
+            seq.next();
+            assert(seq.getindex() <= capacity_ && "element not found on its probe sequence");
+        }
+    }
+
+    // Starts an incremental resize if the table is large enough, and no other
+    // one is in progress.
+    bool try_begin_incremental_resize(size_t new_capacity) {
+        if constexpr (kIncremental) {
+            if (capacity_ < kIncrementalMinCapacity || old_.size)
+                return false;
+            if (old_.ctrl)
+                free_draining(); // empty, but was not released yet
+            begin_incremental_resize(new_capacity);
+            return true;
+        }
+        return false;
+    }
+
+    void set_draining_ctrl(size_t i, ctrl_t h) {
+        assert(i < old_.capacity);
+        SanitizerPoisonObject(old_.slots + i);
+        old_.ctrl[i]                                                                         = h;
+        old_.ctrl[((i - Group::kWidth) & old_.capacity) + 1 + ((Group::kWidth - 1) & old_.capacity)] = h;
+    }
+
+    // Only used by the parallel resize(), while other threads are claiming
+    // slots in the same freshly initialized table (so there are no deleted
+    // slots). The control bytes are read with relaxed atomic loads, and may
+    // be stale, but a claimed byte never becomes empty again, so a stale read
+    // can only cause a failed compare-exchange and a retry on the next
+    // candidate.
+    // -------------------------------------------------------------------------
+    size_t claim_empty_slot(size_t hashval) {
+        const ctrl_t h2  = static_cast<ctrl_t>(H2(hashval));
+        auto         seq = probe(hashval);
+        ctrl_t       bytes[Group::kWidth];
+        while (true) {
+            for (size_t j = 0; j < Group::kWidth; ++j)
+                bytes[j] = std::atomic_ref<ctrl_t>(ctrl_[seq.offset() + j]).load(std::memory_order_relaxed);
+            Group g{ bytes };
+            for (uint32_t i : g.MatchEmpty()) {
+                size_t offset   = seq.offset((size_t)i);
+                ctrl_t expected = kEmpty;
+                if (std::atomic_ref<ctrl_t>(ctrl_[offset]).compare_exchange_strong(expected, h2,
+                                                                                   std::memory_order_relaxed))
+                    return offset;
+            }
+            assert(seq.getindex() < capacity_ && "full table!");
+            seq.next();
+        }
+    }
+
+    void drop_deletes_without_resize() GTL_ATTRIBUTE_NOINLINE {
+        assert(is_valid_capacity(capacity_));
+        assert(!is_small());
+        // ------------------------------------------------------------------------
+        // Algorithm:
+        // - mark all DELETED slots as EMPTY
+        // - mark all FULL slots as DELETED
+        // - for each slot marked as DELETED
+        //     hash = Hash(element)
+        //     target = find_first_non_full(hash)
+        //     if target is in the same group
+        //       mark slot as FULL
+        //     else if target is EMPTY
+        //       transfer element to target
+        //       mark slot as EMPTY
+        //       mark target as FULL
+        //     else if target is DELETED
+        //       swap current element with target element
+        //       mark target as FULL
+        //       repeat procedure for current slot with moved from element (target)
+        // ------------------------------------------------------------------------
+        ConvertDeletedToEmptyAndFullToDeleted(ctrl_, capacity_);
+        typename gtl::aligned_storage_t<sizeof(slot_type), alignof(slot_type)> raw;
+        slot_type* slot = reinterpret_cast<slot_type*>(&raw);
+        for (size_t i = 0; i != capacity_; ++i) {
+            if (!IsDeleted(ctrl_[i]))
+                continue;
+            size_t hashval = hash_of(slots_ + i);
+            auto   target  = find_first_non_full(hashval);
+            size_t new_i   = target.offset;
+
+            // Verify if the old and new i fall within the same group wrt the hashval.
+            // If they do, we don't need to move the object as it falls already in the
+            // best probe we can.
+            // -----------------------------------------------------------------------
+            const auto probe_index = [&](size_t pos) {
+                return index_diff(pos, probe(hashval).offset()) / Group::kWidth;
+            };
+
+            // Element doesn't move.
+            if (GTL_PREDICT_TRUE(probe_index(new_i) == probe_index(i))) {
+                set_ctrl(i, H2(hashval));
+                continue;
+            }
+            if (IsEmpty(ctrl_[new_i])) {
+                // Transfer element to the empty spot.
+                // set_ctrl poisons/unpoisons the slots so we have to call it at the
                 // right time.
                 set_ctrl(new_i, H2(hashval));
                 PolicyTraits::transfer(&alloc_ref(), slots_ + new_i, slots_ + i);
@@ -2767,17 +4202,18 @@ private:
             }
         }
         reset_growth_left(capacity_);
+        reclaim(0);
     }
 
     void rehash_and_grow_if_necessary() {
         if (capacity_ == 0) {
             resize(1);
-        } else if (size() <= CapacityToGrowth(capacity()) / 2) {
+        } else if (size() - draining_size() <= CapacityToGrowth(capacity(), max_load_) / 2) {
             // Squash DELETED without growing if there is enough capacity.
-            drop_deletes_without_resize();
-        } else {
+            drop_deletes();
+        } else if (!try_begin_incremental_resize(next_capacity())) {
             // Otherwise grow the container.
-            resize(capacity_ * 2 + 1);
+            resize(next_capacity());
         }
     }
 
@@ -2791,14 +4227,20 @@ private:
         while (true) {
             Group g{ ctrl_ + seq.offset() };
             for (uint32_t i : g.Match((h2_t)H2(hashval))) {
-                if (GTL_PREDICT_TRUE(PolicyTraits::element(slots_ + seq.offset((size_t)i)) == elem))
+                size_t offset = seq.offset((size_t)i);
+                if (GTL_PREDICT_TRUE(hash_matches(slots_ + offset, hashval) &&
+                                     PolicyTraits::element(slots_ + offset) == elem))
                     return true;
             }
             if (GTL_PREDICT_TRUE(g.MatchEmpty()))
-                return false;
+                break;
             seq.next();
             assert(seq.getindex() < capacity_ && "full table!");
         }
+        if constexpr (kIncremental) {
+            size_t offset;
+            return find_in_draining(hashval, [&](const value_type& e) { return e == elem; }, offset);
+        }
         return false;
     }
 
@@ -2858,14 +4300,25 @@ protected:
         while (true) {
             Group g{ ctrl_ + seq.offset() };
             for (uint32_t i : g.Match((h2_t)H2(hashval))) {
-                if (GTL_PREDICT_TRUE(PolicyTraits::apply(EqualElement<K>{ key, eq_ref() },
-                                                         PolicyTraits::element(slots_ + seq.offset((size_t)i)))))
-                    return seq.offset((size_t)i);
+                size_t offset = seq.offset((size_t)i);
+                if (GTL_PREDICT_TRUE(hash_matches(slots_ + offset, hashval) &&
+                                     PolicyTraits::apply(EqualElement<K>{ key, eq_ref() },
+                                                         PolicyTraits::element(slots_ + offset))))
+                    return offset;
             }
             if (GTL_PREDICT_TRUE(g.MatchEmpty()))
                 break;
             seq.next();
         }
+        if constexpr (kIncremental) {
+            size_t offset;
+            if (find_in_draining(hashval,
+                                 [&](const value_type& elem) {
+                                     return PolicyTraits::apply(EqualElement<K>{ key, eq_ref() }, elem);
+                                 },
+                                 offset))
+                return offset;
+        }
         return (size_t)-1;
     }
 
@@ -2883,6 +4336,10 @@ protected:
             if (!ctrl_)
                 rehash_and_grow_if_necessary();
         }
+        if constexpr (kIncremental) {
+            if (old_.ctrl)
+                drain_some();
+        }
         auto target = find_first_non_full(hashval);
         if (GTL_PREDICT_FALSE(growth_left() == 0 && !IsDeleted(ctrl_[target.offset]))) {
             rehash_and_grow_if_necessary();
@@ -2890,6 +4347,7 @@ protected:
         }
         ++size_;
         growth_left() -= IsEmpty(ctrl_[target.offset]);
+        set_hash(target.offset, hashval);
         return target.offset;
     }
 
@@ -2913,10 +4371,57 @@ protected:
 #endif
     }
 
-    iterator       iterator_at(size_t i) { return { ctrl_ + i, slots_ + i }; }
-    const_iterator iterator_at(size_t i) const { return { ctrl_ + i, slots_ + i }; }
+    // Inserts `value`, whose key must not be present in the table, without
+    // comparing keys. Returns the offset of the new element.
+    // ---------------------------------------------------------------------
+    template<class T>
+    size_t emplace_unique_unchecked(size_t hashval, T&& value) {
+        assert(PolicyTraits::apply(FindElement{ *this }, std::as_const(value)) == end() &&
+               "insert_unique_unchecked(): key already present");
+        size_t offset = prepare_insert(hashval);
+        emplace_at(offset, std::forward<T>(value));
+        this->set_ctrl(offset, H2(hashval));
+        return offset;
+    }
+
+    iterator iterator_at(size_t i) {
+        if constexpr (kIncremental) {
+            if (i & kDrainingOffset) {
+                i &= ~kDrainingOffset;
+                return { old_.ctrl + i, old_.slots + i };
+            }
+            return { ctrl_ + i, slots_ + i, { old_.ctrl, old_.slots } };
+        }
+        return { ctrl_ + i, slots_ + i };
+    }
+    const_iterator iterator_at(size_t i) const { return const_cast<raw_hash_set*>(this)->iterator_at(i); }
 
 protected:
+    // Returns the hash of the element in `slot`, without hashing its key again
+    // when the slots store it.
+    // -------------------------------------------------------------------------
+    size_t hash_of(slot_type* slot) const {
+        if constexpr (kCachedHash)
+            return PolicyTraits::stored_hash(slot);
+        else
+            return PolicyTraits::apply(HashElement{ hash_ref() }, PolicyTraits::element(slot));
+    }
+
+    void set_hash(size_t i, size_t hashval) {
+        if constexpr (kCachedHash)
+            PolicyTraits::stored_hash(slots_ + i) = hashval;
+    }
+
+    // Checked before comparing the keys: false only if the full hash of the
+    // element in `slot`, when stored, differs from `hashval`.
+    // -------------------------------------------------------------------------
+    static bool hash_matches([[maybe_unused]] slot_type* slot, [[maybe_unused]] size_t hashval) {
+        if constexpr (kCachedHash)
+            return PolicyTraits::stored_hash(slot) == hashval;
+        else
+            return true;
+    }
+
     // Sets the control byte, and if `i < Group::kWidth`, set the cloned byte at
     // the end too.
     void set_ctrl(size_t i, ctrl_t h) {
@@ -2929,14 +4434,23 @@ protected:
         }
 
         ctrl_[i]                                                                         = h;
-        ctrl_[((i - Group::kWidth) & capacity_) + 1 + ((Group::kWidth - 1) & capacity_)] = h;
+        if constexpr (kTight)
+            ctrl_[i < Group::kWidth ? i + capacity_ + 1 : i] = h;
+        else
+            ctrl_[((i - Group::kWidth) & capacity_) + 1 + ((Group::kWidth - 1) & capacity_)] = h;
     }
 
 private:
     friend struct RawHashSetTestOnlyAccess;
 
-    probe_seq<Group::kWidth> probe(size_t hashval) const {
-        return probe_seq<Group::kWidth>(H1(hashval, ctrl_), capacity_);
+    probe_seq_t probe(size_t hashval) const { return probe_seq_t(H1(hashval, ctrl_), capacity_); }
+
+    // `(i - j) % (capacity_ + 1)`, for `i <= capacity_` and `j <= capacity_ + 1`
+    size_t index_diff(size_t i, size_t j) const {
+        if constexpr (kTight)
+            return i + (j <= i ? 0 : capacity_ + 1) - j;
+        else
+            return (i - j) & capacity_;
     }
 
     // Reset all ctrl bytes back to kEmpty, except the sentinel.
@@ -2946,7 +4460,9 @@ private:
         SanitizerPoisonMemoryRegion(slots_, sizeof(slot_type) * new_capacity);
     }
 
-    void reset_growth_left(size_t new_capacity) { growth_left() = CapacityToGrowth(new_capacity) - size_; }
+    void reset_growth_left(size_t new_capacity) {
+        growth_left() = CapacityToGrowth(new_capacity, max_load_) - (size_ - draining_size());
+    }
 
     size_t& growth_left() { return std::get<0>(settings_); }
 
@@ -3010,6 +4526,8 @@ private:
                                                                                        hasher{},
                                                                                        key_equal{},
                                                                                        allocator_type{} };
+    max_load_t max_load_ = kDefaultMaxLoad;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS std::conditional_t<kIncremental, draining_table, priv::empty> old_;
 };
 
 // --------------------------------------------------------------------------
@@ -3189,6 +4707,23 @@ inline size_t RandomSeed() {
     return value ^ static_cast<size_t>(reinterpret_cast<uintptr_t>(&counter));
 }
 
+// ----------------------------------------------------------------------------
+// The allocator given to each submap of a parallel_hash_set: a copy of `alloc`,
+// unless it provides `select_on_submap_construction()`, which is then called
+// once per submap, as `select_on_container_copy_construction()` is for a copy
+// constructed container. This lets an allocator whose copies share state
+// which is not thread-safe give each submap its own, since the submaps are
+// written concurrently under different locks. string_arena_allocator returns
+// a new allocator (with a new arena) there. See docs/phmap.md.
+// ----------------------------------------------------------------------------
+template<class Alloc>
+Alloc submap_allocator(const Alloc& alloc) {
+    if constexpr (requires { alloc.select_on_submap_construction(); })
+        return alloc.select_on_submap_construction();
+    else
+        return alloc;
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 template<size_t N,
@@ -3238,6 +4773,29 @@ public:
     template<class K>
     using key_arg = typename KeyArgImpl::template type<K, key_type>;
 
+    // With a gtl::SeqMutex, and an allocator which keeps the previous tables of
+    // the submaps mapped, lookups of trivially copyable values take no lock
+    // (see find_copy_optimistic()). The keys are compared before the read is
+    // validated, possibly on a torn copy, so they must not point to memory:
+    // only arithmetic and enum keys qualify.
+    // --------------------------------------------------------------------
+    static constexpr bool kOptimisticReads =
+        requires { requires LockableImpl<Mtx_>::kOptimisticReads; } &&
+        requires { requires allocator_type::kRetainsMemory; } &&
+        std::is_same_v<typename Policy::is_flat, std::true_type> &&
+        (std::is_arithmetic_v<key_type> || std::is_enum_v<key_type>) &&
+        std::is_trivially_copy_constructible_v<value_type> &&
+        std::is_trivially_destructible_v<value_type> &&
+        std::is_same_v<gtl::priv::empty, aux_type> && !EmbeddedSet::kIncremental;
+
+    // With a policy which stores part of the element in the allocator of its
+    // submap (StringFlatHashMapPolicy), the emplace() overloads which cannot
+    // deduce the key convert their arguments to init_type, whose key is a
+    // lookup key, instead of constructing the element before its submap is
+    // known.
+    // --------------------------------------------------------------------
+    static constexpr bool kSubmapStorage = requires(allocator_type* a, slot_type* slot) { Policy::rekey(a, slot); };
+
 protected:
     using Lockable      = LockableImpl<Mtx_>;
     using UniqueLock    = typename Lockable::UniqueLock;
@@ -3256,7 +4814,7 @@ protected:
         Inner() {}
 
         Inner(Params const& p)
-            : set_(p.bucket_cnt, p.hashfn, p.eq, p.alloc) {}
+            : set_(p.bucket_cnt, p.hashfn, p.eq, submap_allocator(p.alloc)) {}
 
         bool operator==(const Inner& o) const {
             typename Lockable::SharedLocks l(const_cast<Inner&>(*this), const_cast<Inner&>(o));
@@ -3265,6 +4823,7 @@ protected:
 
         EmbeddedSet                              set_;
         GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS aux_type aux_;
+        typename EmbeddedSet::compact_cursor     cursor_; // see compact()
     };
 
 private:
@@ -3459,6 +5018,19 @@ public:
     parallel_hash_set(InputIter first, InputIter last, const allocator_type& alloc)
         : parallel_hash_set(first, last, 0, hasher(), key_equal(), alloc) {}
 
+    // PRECONDITION: the keys in [first, last) are distinct.
+    template<class InputIter>
+    parallel_hash_set(from_unique_range_t,
+                      InputIter             first,
+                      InputIter             last,
+                      size_t                bucket_cnt = 0,
+                      const hasher&         hash_param = hasher(),
+                      const key_equal&      eq         = key_equal(),
+                      const allocator_type& alloc      = allocator_type())
+        : parallel_hash_set(bucket_cnt, hash_param, eq, alloc) {
+        insert_unique_unchecked(first, last);
+    }
+
     // Instead of accepting std::initializer_list<value_type> as the first
     // argument like std::unordered_set<value_type> does, we have two overloads
     // that accept std::initializer_list<T> and std::initializer_list<init_type>.
@@ -3527,17 +5099,22 @@ public:
     parallel_hash_set(const parallel_hash_set& that, const allocator_type& a)
         : parallel_hash_set(0, that.hash_ref(), that.eq_ref(), a) {
         for (size_t i = 0; i < num_tables; ++i)
-            sets_[i].set_ = { that.sets_[i].set_, a };
+            sets_[i].set_ = { that.sets_[i].set_, submap_allocator(a) };
     }
 
     parallel_hash_set(parallel_hash_set&& that) noexcept(std::is_nothrow_copy_constructible_v<hasher> &&
                                                          std::is_nothrow_copy_constructible_v<key_equal> &&
-                                                         std::is_nothrow_copy_constructible_v<allocator_type>)
-        : parallel_hash_set(std::move(that), that.alloc_ref()) {}
+                                                         std::is_nothrow_copy_constructible_v<allocator_type>) {
+        // each submap keeps its own allocator
+        for (size_t i = 0; i < num_tables; ++i) {
+            allocator_type a = that.sets_[i].set_.alloc_ref();
+            sets_[i].set_    = { std::move(that.sets_[i]).set_, a };
+        }
+    }
 
     parallel_hash_set(parallel_hash_set&& that, const allocator_type& a) {
         for (size_t i = 0; i < num_tables; ++i)
-            sets_[i].set_ = { std::move(that.sets_[i]).set_, a };
+            sets_[i].set_ = { std::move(that.sets_[i]).set_, submap_allocator(a) };
     }
 
     parallel_hash_set& operator=(const parallel_hash_set& that) {
@@ -3662,12 +5239,64 @@ public:
 
     iterator insert(const_iterator, init_type&& value) { return insert(std::move(value)).first; }
 
-    template<class InputIt>
+    // When the size of the range is known, we reserve once and then insert the
+    // elements in blocks. Each block is hashed and partitioned by submap, and
+    // each partition is inserted under a single lock acquisition, after
+    // prefetching the groups of all its elements.
+    // --------------------------------------------------------------------
+    template<class InputIt,
+             typename std::enable_if_t<EmbeddedSet::template has_difference_operator<InputIt>::value, int> = 0>
+    void insert(InputIt first, InputIt last) {
+        this->reserve(this->size() + (last - first));
+        if constexpr (IsDecomposable<decltype(*first)>::value) {
+            insert_blocks(first, last, [](EmbeddedSet& set, size_t hashval, auto&& value) {
+                set.emplace_with_hash(hashval, std::forward<decltype(value)>(value));
+            });
+        } else {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+    }
+
+    template<class InputIt,
+             typename std::enable_if_t<!EmbeddedSet::template has_difference_operator<InputIt>::value, int> = 0>
     void insert(InputIt first, InputIt last) {
         for (; first != last; ++first)
             insert(*first);
     }
 
+    // Extension API: insertion of elements whose keys are known not to be in
+    // the table, without key comparisons (see raw_hash_set).
+    //
+    // PRECONDITION: no element with an equal key is present in the table, or
+    // earlier in the inserted range.
+    // --------------------------------------------------------------------
+    template<class T, typename std::enable_if_t<IsDecomposable<T>::value, int> = 0>
+    iterator insert_unique_unchecked(T&& value) {
+        size_t     hashval = PolicyTraits::apply(HashElement{ hash_ref() }, value);
+        Inner&     inner   = sets_[subidx(hashval)];
+        auto&      set     = inner.set_;
+        UniqueLock m(inner);
+        return make_iterator(&inner, set.iterator_at(set.emplace_unique_unchecked(hashval, std::forward<T>(value))));
+    }
+
+    iterator insert_unique_unchecked(init_type&& value) {
+        return insert_unique_unchecked<init_type>(std::move(value));
+    }
+
+    template<class InputIt>
+    void insert_unique_unchecked(InputIt first, InputIt last) {
+        if constexpr (EmbeddedSet::template has_difference_operator<InputIt>::value) {
+            this->reserve(this->size() + (last - first));
+            insert_blocks(first, last, [](EmbeddedSet& set, size_t hashval, auto&& value) {
+                set.emplace_unique_unchecked(hashval, std::forward<decltype(value)>(value));
+            });
+        } else {
+            for (; first != last; ++first)
+                insert_unique_unchecked(*first);
+        }
+    }
+
     template<class T, RequiresInsertable<const T&> = 0>
     void insert(std::initializer_list<T> ilist) {
         insert(ilist.begin(), ilist.end());
@@ -3732,16 +5361,20 @@ public:
     // --------------------------------------------------------------------
     template<class... Args, typename std::enable_if_t<!IsDecomposable<Args...>::value, int> = 0>
     std::pair<iterator, bool> emplace_with_hash(size_t hashval, Args&&... args) {
-        typename gtl::aligned_storage_t<sizeof(slot_type), alignof(slot_type)> raw;
-        slot_type* slot = reinterpret_cast<slot_type*>(&raw);
-
-        PolicyTraits::construct(&alloc_ref(), slot, std::forward<Args>(args)...);
-        const auto&                                             elem  = PolicyTraits::element(slot);
-        Inner&                                                  inner = sets_[subidx(hashval)];
-        auto&                                                   set   = inner.set_;
-        UniqueLock                                              m(inner);
-        typename EmbeddedSet::template InsertSlotWithHash<true> f{ set, std::move(*slot), hashval };
-        return make_rv(&inner, PolicyTraits::apply(std::move(f), elem));
+        if constexpr (kSubmapStorage) {
+            return emplace_with_hash(hashval, init_type(std::forward<Args>(args)...));
+        } else {
+            typename gtl::aligned_storage_t<sizeof(slot_type), alignof(slot_type)> raw;
+            slot_type* slot = reinterpret_cast<slot_type*>(&raw);
+
+            PolicyTraits::construct(&alloc_ref(), slot, std::forward<Args>(args)...);
+            const auto&                                             elem  = PolicyTraits::element(slot);
+            Inner&                                                  inner = sets_[subidx(hashval)];
+            auto&                                                   set   = inner.set_;
+            UniqueLock                                              m(inner);
+            typename EmbeddedSet::template InsertSlotWithHash<true> f{ set, std::move(*slot), hashval };
+            return make_rv(&inner, PolicyTraits::apply(std::move(f), elem));
+        }
     }
 
     template<class... Args>
@@ -3803,17 +5436,21 @@ public:
     // --------------------------------------------------------------------
     template<class... Args, typename std::enable_if_t<!IsDecomposable<Args...>::value, int> = 0>
     std::pair<iterator, bool> emplace(Args&&... args) {
-        typename gtl::aligned_storage_t<sizeof(slot_type), alignof(slot_type)> raw;
-        slot_type* slot    = reinterpret_cast<slot_type*>(&raw);
-        PolicyTraits::construct(&alloc_ref(), slot, std::forward<Args>(args)...);
-        size_t      hashval = this->hash(PolicyTraits::key(slot));
-        const auto& elem    = PolicyTraits::element(slot);
-        Inner&      inner   = sets_[subidx(hashval)];
-        auto&       set     = inner.set_;
-        UniqueLock  m(inner);
-
-        typename EmbeddedSet::template InsertSlotWithHash<true> f{ set, std::move(*slot), hashval };
-        return make_rv(&inner, PolicyTraits::apply(std::move(f), elem));
+        if constexpr (kSubmapStorage) {
+            return emplace(init_type(std::forward<Args>(args)...));
+        } else {
+            typename gtl::aligned_storage_t<sizeof(slot_type), alignof(slot_type)> raw;
+            slot_type* slot    = reinterpret_cast<slot_type*>(&raw);
+            PolicyTraits::construct(&alloc_ref(), slot, std::forward<Args>(args)...);
+            size_t      hashval = this->hash(PolicyTraits::key(slot));
+            const auto& elem    = PolicyTraits::element(slot);
+            Inner&      inner   = sets_[subidx(hashval)];
+            auto&       set     = inner.set_;
+            UniqueLock  m(inner);
+
+            typename EmbeddedSet::template InsertSlotWithHash<true> f{ set, std::move(*slot), hashval };
+            return make_rv(&inner, PolicyTraits::apply(std::move(f), elem));
+        }
     }
 
     template<class... Args>
@@ -3870,9 +5507,19 @@ public:
 
     // if set contains key, lambda is called with the value_type (under read lock protection),
     // and if_contains returns true. This is a const API and lambda should not modify the value
+    // With a gtl::SeqMutex (see kOptimisticReads), the lambda is called on a copy of the
+    // value, read without locking.
     // -----------------------------------------------------------------------------------------
     template<class K = key_type, class F>
     bool if_contains(const key_arg<K>& key, F&& f) const {
+        if constexpr (kOptimisticReads) {
+            alignas(value_type) unsigned char buf[sizeof(value_type)];
+            if (auto found = find_copy_optimistic<K>(key, this->hash(key), buf)) {
+                if (*found)
+                    std::forward<F>(f)(*std::launder(reinterpret_cast<const value_type*>(buf)));
+                return *found;
+            }
+        }
         return const_cast<parallel_hash_set*>(this)->template modify_if_impl<K, F, SharedLock>(key, std::forward<F>(f));
     }
 
@@ -3953,8 +5600,29 @@ public:
     // ---------------------------------------------------------------------------------------
     template<class K = key_type, class FExists, class FEmplace>
     bool lazy_emplace_l(const key_arg<K>& key, FExists&& fExists, FEmplace&& fEmplace) {
+        return lazy_emplace_l_impl<K, FExists, FEmplace, UniqueLock>(
+            key, std::forward<FExists>(fExists), std::forward<FEmplace>(fEmplace));
+    }
+
+    // Same as lazy_emplace_l, except that the first lambda is passed a `const value_type&`,
+    // under a read lock, which is upgraded to a write lock only to insert the key. So several
+    // threads may call it at the same time: it must not modify any shared state without
+    // synchronizing. Without a shared mutex (or with an auxiliary container), the lookup
+    // takes the write lock, as in lazy_emplace_l.
+    // ---------------------------------------------------------------------------------------
+    template<class K = key_type, class FExists, class FEmplace>
+    bool lazy_emplace_l_shared(const key_arg<K>& key, FExists&& fExists, FEmplace&& fEmplace) {
+        using L = std::conditional_t<std::is_same_v<gtl::priv::empty, aux_type>, ReadWriteLock, UniqueLock>;
+        return lazy_emplace_l_impl<K, FExists, FEmplace, L, true>(
+            key, std::forward<FExists>(fExists), std::forward<FEmplace>(fEmplace));
+    }
+
+    template<class K, class FExists, class FEmplace, class L, bool kShared = false>
+    bool lazy_emplace_l_impl(const key_arg<K>& key, FExists&& fExists, FEmplace&& fEmplace) {
+        using arg_type = std::conditional_t<kShared, const value_type&, value_type&>;
+
         size_t        hashval = this->hash(key);
-        UniqueLock    m;
+        L             m;
         auto          res   = this->find_or_prepare_insert_with_hash(hashval, key, m);
         Inner*        inner = std::get<0>(res);
         if (std::get<2>(res)) {
@@ -3973,9 +5641,9 @@ public:
             auto it = this->iterator_at(inner, inner->set_.iterator_at(std::get<1>(res)));
 
             if constexpr (std::is_same_v<gtl::priv::empty, aux_type>)
-                std::forward<FExists>(fExists)(const_cast<value_type&>(*it));
+                std::forward<FExists>(fExists)(const_cast<arg_type>(*it));
             else
-                std::forward<FExists>(fExists)(const_cast<value_type&>(*it), inner->aux_);
+                std::forward<FExists>(fExists)(const_cast<arg_type>(*it), inner->aux_);
         }
         return std::get<2>(res);
     }
@@ -4023,6 +5691,70 @@ public:
     }
 #endif
 
+    // Extension API: parallel algorithms over all the elements, with one task
+    // per submap. `exec` is a number of threads, an executor hook or a
+    // standard execution policy (see parallel_insert()).
+    // -------------------------------------------------
+
+    // Erases the elements for which `pred(value)` returns true, and returns
+    // how many were erased. Also available as `gtl::erase_if(exec, c, pred)`.
+    template<class Executor, class Pred>
+    size_type parallel_erase_if(Executor&& exec, Pred&& pred) {
+        std::array<size_type, num_tables> erased{};
+        run_tasks(std::forward<Executor>(exec), num_tables, [&](size_t idx) {
+            Inner&     inner = sets_[idx];
+            auto&      set   = inner.set_;
+            UniqueLock m(inner);
+            for (auto it = set.begin(), last = set.end(); it != last;) {
+                if (pred(std::as_const(*it))) {
+                    set._erase(it++);
+                    ++erased[idx];
+                } else {
+                    ++it;
+                }
+            }
+        });
+        size_type res = 0;
+        for (auto e : erased)
+            res += e;
+        return res;
+    }
+
+    // Returns `init` combined with `transform(value)` for every element, using
+    // `reduce`, which must be associative and commutative since the submaps
+    // are reduced concurrently (as with std::transform_reduce).
+    //
+    //   size_t total = m.transform_reduce(8, size_t(0), std::plus<>(), [](const auto& v) { return v.second; });
+    template<class Executor, class T, class Reduce, class Transform>
+    T transform_reduce(Executor&& exec, T init, Reduce reduce, Transform transform) const {
+        std::array<std::optional<T>, num_tables> partial;
+        run_tasks(std::forward<Executor>(exec), num_tables, [&](size_t idx) {
+            const Inner&     inner = sets_[idx];
+            SharedLock       m(const_cast<Inner&>(inner));
+            std::optional<T> acc;
+            for (const auto& v : inner.set_)
+                acc = acc ? reduce(std::move(*acc), transform(v)) : T(transform(v));
+            partial[idx] = std::move(acc);
+        });
+        for (auto& p : partial)
+            if (p)
+                init = reduce(std::move(init), std::move(*p));
+        return init;
+    }
+
+    // Same as operator==, comparing the submaps concurrently.
+    template<class Executor>
+    bool equal(const parallel_hash_set& o, Executor&& exec) const {
+        if (this == &o)
+            return true;
+        std::atomic<bool> same{ true };
+        run_tasks(std::forward<Executor>(exec), num_tables, [&](size_t idx) {
+            if (same.load(std::memory_order_relaxed) && !(sets_[idx] == o.sets_[idx]))
+                same.store(false, std::memory_order_relaxed);
+        });
+        return same;
+    }
+
     // Extension API: access internal submaps by index
     // under lock protection
     // ex: m.with_submap(i, [&](const Map::EmbeddedSet& set) {
@@ -4044,6 +5776,24 @@ public:
         fCallback(set);
     }
 
+    // Extension API: lock contention counters of the submap `idx`, available
+    // when the mutex is a gtl::InstrumentedMutex. Comparing them across the
+    // submaps shows whether the keys are evenly spread by subidx(), and
+    // whether more submaps (a larger N) would reduce the contention.
+    // -------------------------------------------------
+    lock_stats_t lock_stats(size_t idx) const
+        requires requires(const Lockable& l) { l.stats(); }
+    {
+        return sets_[idx].stats();
+    }
+
+    void reset_lock_stats()
+        requires requires(Lockable& l) { l.reset_stats(); }
+    {
+        for (auto& inner : sets_)
+            inner.reset_stats();
+    }
+
     // unsafe, for internal use only
     Inner& get_inner(size_t idx) { return sets_[idx]; }
 
@@ -4125,6 +5875,27 @@ public:
         merge(src);
     }
 
+    // Extension API: same as merge(src), but the submaps are merged
+    // concurrently, submap i of `src` into submap i of `this`. `exec` is a
+    // number of threads, an executor hook or a standard execution policy (see
+    // parallel_insert()).
+    // --------------------------------------------------------------------
+    template<typename E, class Executor>
+    void merge(parallel_hash_set<N, RefSet, Mtx_, AuxCont, Policy, Hash, E, Alloc>& src, Executor&& exec) {
+        assert(this != &src);
+        if (this != &src) {
+            run_tasks(std::forward<Executor>(exec), num_tables, [&](size_t i) {
+                typename Lockable::UniqueLocks l(sets_[i], src.sets_[i]);
+                sets_[i].set_.merge(src.sets_[i].set_);
+            });
+        }
+    }
+
+    template<typename E, class Executor>
+    void merge(parallel_hash_set<N, RefSet, Mtx_, AuxCont, Policy, Hash, E, Alloc>&& src, Executor&& exec) {
+        merge(src, std::forward<Executor>(exec));
+    }
+
     node_type extract(const_iterator position) {
         return position.iter_.inner_->set_.extract(EmbeddedConstIterator(position.iter_.it_));
     }
@@ -4158,28 +5929,153 @@ public:
         }
     }
 
-    void reserve(size_t n) {
-        size_t target     = GrowthToLowerboundCapacity(n);
-        size_t normalized = num_tables * NormalizeCapacity(n / num_tables);
-        rehash(normalized > target ? normalized : target);
+    void reserve(size_t n) { rehash(reserved_capacity(n)); }
+
+    // Extension API: rehash/reserve the submaps concurrently. `exec` is a
+    // number of threads, an executor hook or a standard execution policy (see
+    // run_tasks).
+    // --------------------------------------------------------------------
+    template<class Executor>
+    void rehash(size_t n, Executor&& exec) {
+        size_t nn           = n / num_tables;
+        auto   rehash_inner = [&](size_t idx) {
+            UniqueLock m(sets_[idx]);
+            sets_[idx].set_.rehash(nn);
+        };
+        run_tasks(std::forward<Executor>(exec), num_tables, rehash_inner);
+    }
+
+    template<class Executor>
+    void reserve(size_t n, Executor&& exec) {
+        rehash(reserved_capacity(n), std::forward<Executor>(exec));
     }
 
-    // Extension API: support for heterogeneous keys.
+    // Extension API: bulk load of a random access range from several threads.
     //
-    //   std::unordered_set<std::string> s;
-    //   // Turns "abc" into std::string.
-    //   s.count("abc");
+    // The elements are hashed and partitioned by submap, then each submap is
+    // reserved once and filled by a single task, so the threads don't contend
+    // on the submap locks, nor grow the submaps while inserting. `exec` is the
+    // number of threads to run the tasks on, an executor hook or a standard
+    // execution policy (see run_tasks). With an executor, the hasher and the
+    // allocator must be safe to call concurrently.
     //
-    //   ch_set<std::string> s;
-    //   // Uses "abc" directly without copying it into std::string.
-    //   s.count("abc");
+    //   m.parallel_insert(v.begin(), v.end(), std::thread::hardware_concurrency());
     // --------------------------------------------------------------------
-    template<class K = key_type>
-    size_t count(const key_arg<K>& key) const {
-        return this->contains(key) ? 1 : 0;
-    }
+    template<class RandomIt, class Executor>
+        requires std::random_access_iterator<RandomIt>
+    void parallel_insert(RandomIt first, RandomIt last, Executor&& exec) {
+        if constexpr (std::is_integral_v<std::remove_cvref_t<Executor>>) {
+            parallel_insert(first, last, thread_executor{ static_cast<size_t>(exec) });
+        } else if constexpr (!IsDecomposable<decltype(*first)>::value) {
+            insert(first, last);
+        } else {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n < kParallelInsertChunk) {
+                insert(first, last);
+                return;
+            }
 
-    // Issues CPU prefetch instructions for the memory needed to find or insert
+            // 1. hash the elements, and count them by submap in each chunk
+            const size_t        num_chunks = (n + kParallelInsertChunk - 1) / kParallelInsertChunk;
+            std::vector<size_t> hashes(n);
+            std::vector<size_t> counts(num_chunks * num_tables); // [chunk][submap]
+            auto                chunk_range = [&](size_t c) {
+                return std::pair{ c * kParallelInsertChunk, (std::min)(n, (c + 1) * kParallelInsertChunk) };
+            };
+            run_tasks(exec, num_chunks, [&](size_t c) {
+                auto [b, e] = chunk_range(c);
+                size_t* cnt = &counts[c * num_tables];
+                for (size_t i = b; i < e; ++i) {
+                    hashes[i] = PolicyTraits::apply(HashElement{ hash_ref() }, first[i]);
+                    ++cnt[subidx(hashes[i])];
+                }
+            });
+
+            // 2. radix partition the element indices by submap, keeping the
+            //    input order within each submap
+            std::array<size_t, num_tables + 1> start{};
+            for (size_t idx = 0, pos = 0; idx < num_tables; ++idx) {
+                start[idx] = pos;
+                for (size_t c = 0; c < num_chunks; ++c) {
+                    size_t cnt                   = counts[c * num_tables + idx];
+                    counts[c * num_tables + idx] = pos;
+                    pos += cnt;
+                }
+            }
+            start[num_tables] = n;
+
+            std::vector<size_t> order(n);
+            run_tasks(exec, num_chunks, [&](size_t c) {
+                auto [b, e] = chunk_range(c);
+                size_t* pos = &counts[c * num_tables];
+                for (size_t i = b; i < e; ++i)
+                    order[pos[subidx(hashes[i])]++] = i;
+            });
+
+            // 3. each task owns a submap, which it reserves and fills
+            run_tasks(exec, num_tables, [&](size_t idx) {
+                Inner&     inner = sets_[idx];
+                auto&      set   = inner.set_;
+                UniqueLock m(inner);
+                set.reserve(set.size() + (start[idx + 1] - start[idx]));
+                for (size_t j = start[idx]; j < start[idx + 1]; ++j) {
+                    if (j + kPrefetchDistance < start[idx + 1])
+                        set.prefetch_hash(hashes[order[j + kPrefetchDistance]]);
+                    set.emplace_with_hash(hashes[order[j]], first[order[j]]);
+                }
+            });
+        }
+    }
+
+    template<class Range, class Executor>
+        requires std::ranges::random_access_range<Range>
+    void parallel_insert(Range&& r, Executor&& exec) {
+        parallel_insert(std::ranges::begin(r), std::ranges::end(r), std::forward<Executor>(exec));
+    }
+
+    // Extension API: bounded tombstone cleanup (see raw_hash_set::compact()).
+    // Does at most `budget` groups of slots worth of work, resuming the pass
+    // of each submap where the previous call left it, and returns the work
+    // left: the tombstones not reviewed yet, and for the _incremental maps the
+    // elements still in a draining table. Only the submap being cleaned up is
+    // locked, and only for `budget` groups, so a background thread can keep
+    // the probe sequences short without stopping the other threads:
+    //
+    //   while (m.compact(16))
+    //       std::this_thread::yield();
+    //
+    // With the _incremental maps, this is also what moves the elements of a
+    // draining table when there are no insertions, so that lookups stop
+    // probing two slot arrays.
+    // --------------------------------------------------------------------
+    size_t compact(size_t budget) {
+        size_t backlog = 0;
+        for (auto& inner : sets_) {
+            UniqueLock m(inner);
+            auto&      set = inner.set_;
+            if (budget)
+                budget = set.compact(inner.cursor_, budget);
+            backlog += set.compact_backlog(inner.cursor_);
+        }
+        return backlog;
+    }
+
+    // Extension API: support for heterogeneous keys.
+    //
+    //   std::unordered_set<std::string> s;
+    //   // Turns "abc" into std::string.
+    //   s.count("abc");
+    //
+    //   ch_set<std::string> s;
+    //   // Uses "abc" directly without copying it into std::string.
+    //   s.count("abc");
+    // --------------------------------------------------------------------
+    template<class K = key_type>
+    size_t count(const key_arg<K>& key) const {
+        return this->contains(key) ? 1 : 0;
+    }
+
+    // Issues CPU prefetch instructions for the memory needed to find or insert
     // a key.  Like all lookup functions, this support heterogeneous keys.
     //
     // NOTE: This is a very low level operation and should not be used without
@@ -4238,12 +6134,74 @@ public:
 
     template<class K = key_type>
     bool contains_impl(const key_arg<K>& key, size_t hashval) {
+        if constexpr (kOptimisticReads) {
+            alignas(value_type) unsigned char buf[sizeof(value_type)];
+            if (auto found = find_copy_optimistic<K>(key, hashval, buf))
+                return *found;
+        }
         Inner&     inner = sets_[subidx(hashval)];
         auto&      set   = inner.set_;
         SharedLock lock(inner);
         return set.find(key, hashval) != set.end();
     }
 
+    // Looks up `key` in its SeqMutex submap without locking, copying the
+    // matching value to `out`. Returns nullopt when a writer held the submap,
+    // or modified it during each of our attempts; the caller then locks it.
+    // --------------------------------------------------------------------
+    template<class K = key_type>
+    std::optional<bool> find_copy_optimistic(const key_arg<K>& key, size_t hashval, void* out) const {
+        static constexpr int kAttempts = 4;
+
+        const Inner& inner = sets_[subidx(hashval)];
+        for (int attempt = 0; attempt < kAttempts; ++attempt) {
+            uint64_t seq = inner.read_begin();
+            if (seq & 1)
+                break;
+            auto valid = [&]() { return inner.read_validate(seq); };
+            bool found = inner.set_.template find_copy_racy<K>(key, hashval, out, valid);
+            if (valid())
+                return found;
+        }
+        return std::nullopt;
+    }
+
+    // Batched lookup: `out[i]` receives `find(keys[i])`.
+    //
+    // The keys are hashed a block at a time and ordered by submap, so that
+    // each submap lock is acquired once per block instead of once per key.
+    // Within a submap, the groups of all its keys are prefetched before any of
+    // them is probed. `out` must be a random access iterator (or pointer) with
+    // room for `keys.size()` results.
+    // --------------------------------------------------------------------
+    template<class K = key_type, class OutIt>
+    void find_many(std::type_identity_t<std::span<const K>> keys, OutIt out) {
+        batch_lookup<K>(keys,
+                        [&](size_t i, Inner& inner, const EmbeddedIterator& it) { out[i] = make_iterator(&inner, it); });
+    }
+
+    template<class K = key_type, class OutIt>
+    void find_many(std::type_identity_t<std::span<const K>> keys, OutIt out) const {
+        auto self = const_cast<parallel_hash_set*>(this);
+        self->template batch_lookup<K>(
+            keys, [&](size_t i, Inner& inner, const EmbeddedIterator& it) { out[i] = self->make_iterator(&inner, it); });
+    }
+
+    // Batched version of contains(): `out[i]` receives `contains(keys[i])`.
+    // Returns the number of keys found.
+    // --------------------------------------------------------------------
+    template<class K = key_type, class OutIt>
+    size_t contains_many(std::type_identity_t<std::span<const K>> keys, OutIt out) const {
+        size_t cnt = 0;
+        const_cast<parallel_hash_set*>(this)->template batch_lookup<K>(
+            keys, [&](size_t i, Inner& inner, const EmbeddedIterator& it) {
+                bool found = it != inner.set_.end();
+                out[i]     = found;
+                cnt += found;
+            });
+        return cnt;
+    }
+
     template<class K = key_type>
     std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
         auto it = find(key);
@@ -4274,9 +6232,17 @@ public:
         return _capacity ? static_cast<float>(static_cast<double>(size()) / _capacity) : 0;
     }
 
-    float max_load_factor() const { return 1.0f; }
-    void  max_load_factor(float) {
-        // Does nothing.
+    float max_load_factor() const {
+        SharedLock m(const_cast<Inner&>(sets_[0]));
+        return sets_[0].set_.max_load_factor();
+    }
+
+    // Sets the maximum load factor of every submap (see raw_hash_set).
+    void max_load_factor(float f) {
+        for (auto& inner : sets_) {
+            UniqueLock m(inner);
+            inner.set_.max_load_factor(f);
+        }
     }
 
     hasher hash_function() const {
@@ -4406,14 +6372,116 @@ protected:
         return make_iterator(&inner, set.find(key, hashval));
     }
 
-    template<class K>
-    std::tuple<Inner*, size_t, bool> find_or_prepare_insert_with_hash(size_t      hashval,
-                                                                      const K&    key,
-                                                                      UniqueLock& mutexlock) {
+    static constexpr size_t kLookupBatch = 64;
+
+    static constexpr size_t kParallelInsertChunk = 16384;
+    static constexpr size_t kPrefetchDistance    = 8;
+
+    // the total capacity given to rehash() by reserve(n)
+    size_t reserved_capacity(size_t n) const {
+        const max_load_t max_load = ToMaxLoad(max_load_factor());
+        if constexpr (EmbeddedSet::kTight) {
+            // the elements are not spread exactly evenly over the submaps: leave
+            // room for 4 standard deviations, so that no submap has to grow
+            size_t per_table = n / num_tables;
+            per_table += 4 * static_cast<size_t>(std::sqrt(static_cast<double>(per_table))) + 1;
+            return num_tables * GrowthToLowerboundCapacity(per_table, max_load);
+        } else {
+            size_t target     = GrowthToLowerboundCapacity(n, max_load);
+            size_t normalized = num_tables * NormalizeCapacity(n / num_tables);
+            return normalized > target ? normalized : target;
+        }
+    }
+
+    // Calls `f(i, inner, it)` for each key, where `it` is the result of the
+    // lookup in submap `inner`, while holding that submap's SharedLock.
+    // --------------------------------------------------------------------
+    template<class K, class F>
+    void batch_lookup(std::span<const K> keys, F&& f) {
+        size_t   hashes[kLookupBatch];
+        uint32_t order[kLookupBatch]; // indices within the block, sorted by submap
+        for (size_t start = 0; start < keys.size(); start += kLookupBatch) {
+            size_t cnt = (std::min)(kLookupBatch, keys.size() - start);
+            for (size_t j = 0; j < cnt; ++j) {
+                const key_arg<K>& key = keys[start + j];
+                hashes[j]             = this->hash(key);
+                order[j]              = static_cast<uint32_t>(j);
+            }
+            for_each_submap_run(hashes, order, cnt, [&](Inner& inner, const uint32_t* b, const uint32_t* e) {
+                auto&      set = inner.set_;
+                SharedLock m(inner);
+                for (auto p = b; p != e; ++p)
+                    set.prefetch_hash(hashes[*p]);
+                for (auto p = b; p != e; ++p)
+                    f(start + *p, inner, set.template find<K>(keys[start + *p], hashes[*p]));
+            });
+        }
+    }
+
+    // Inserts [first, last) in blocks of kLookupBatch elements: the iterators of
+    // a block are saved while its hashes are computed, then each submap's share
+    // of the block is placed with `place(set, hash, *it)` under a single lock
+    // acquisition, after prefetching the groups of all its elements.
+    // --------------------------------------------------------------------
+    template<class InputIt, class F>
+    void insert_blocks(InputIt first, InputIt last, F&& place) {
+        size_t   hashes[kLookupBatch];
+        uint32_t order[kLookupBatch];
+        InputIt  its[kLookupBatch];
+        while (first != last) {
+            size_t cnt = (std::min)(kLookupBatch, static_cast<size_t>(last - first));
+            for (size_t j = 0; j < cnt; ++j, ++first) {
+                its[j]    = first;
+                hashes[j] = PolicyTraits::apply(HashElement{ hash_ref() }, *first);
+                order[j]  = static_cast<uint32_t>(j);
+            }
+            for_each_submap_run(hashes, order, cnt, [&](Inner& inner, const uint32_t* b, const uint32_t* e) {
+                auto&      set = inner.set_;
+                UniqueLock m(inner);
+                for (auto p = b; p != e; ++p)
+                    set.prefetch_hash(hashes[*p]);
+                for (auto p = b; p != e; ++p)
+                    place(set, hashes[*p], *its[*p]);
+            });
+        }
+    }
+
+    // Sorts `order` (indices within a block of `cnt` hashes) by submap, and
+    // calls `f(inner, b, e)` for each run [b, e) of indices falling into the
+    // same submap. Indices of a run stay in increasing order.
+    // --------------------------------------------------------------------
+    template<class F>
+    void for_each_submap_run(const size_t* hashes, uint32_t* order, size_t cnt, F&& f) {
+        if constexpr (num_tables > 1)
+            std::sort(order, order + cnt, [&](uint32_t a, uint32_t b) {
+                size_t ia = subidx(hashes[a]), ib = subidx(hashes[b]);
+                return ia < ib || (ia == ib && a < b);
+            });
+
+        for (size_t first = 0; first < cnt;) {
+            size_t idx  = subidx(hashes[order[first]]);
+            size_t last = first + 1;
+            while (last < cnt && subidx(hashes[order[last]]) == idx)
+                ++last;
+            f(sets_[idx], order + first, order + last);
+            first = last;
+        }
+    }
+
+    // With a ReadWriteLock, the key is looked up under a shared lock, which is
+    // only upgraded when the key must be inserted.
+    template<class K, class L>
+    std::tuple<Inner*, size_t, bool> find_or_prepare_insert_with_hash(size_t hashval, const K& key, L& mutexlock) {
         Inner& inner  = sets_[subidx(hashval)];
         auto&  set    = inner.set_;
-        mutexlock     = std::move(UniqueLock(inner));
+        mutexlock     = std::move(L(inner));
         size_t offset = set._find_key(key, hashval);
+        if constexpr (!std::is_same_v<L, UniqueLock>) {
+            if (offset == (size_t)-1 && mutexlock.switch_to_unique()) {
+                // we did an unlock/lock, the key may have been inserted meanwhile
+                offset = set._find_key(key, hashval);
+            }
+        }
         if (offset == (size_t)-1) {
             offset = set.prepare_insert(hashval);
             return std::make_tuple(&inner, offset, true);
@@ -4632,8 +6700,26 @@ public:
     // ---------------------------------------------------------------------------------------
     template<class K = key_type, class F, class... Args>
     bool try_emplace_l(K&& k, F&& f, Args&&... args) {
+        return try_emplace_l_impl<K, F, UniqueLock>(std::forward<K>(k), std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // Same as try_emplace_l, except that the lambda is passed a `const value_type&`, under a
+    // read lock, which is upgraded to a write lock only to insert the key (see
+    // lazy_emplace_l_shared).
+    // ---------------------------------------------------------------------------------------
+    template<class K = key_type, class F, class... Args>
+    bool try_emplace_l_shared(K&& k, F&& f, Args&&... args) {
+        using L = std::
+            conditional_t<std::is_same_v<gtl::priv::empty, typename Base::aux_type>, ReadWriteLock, UniqueLock>;
+        return try_emplace_l_impl<K, F, L, true>(std::forward<K>(k), std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class K, class F, class L, bool kShared = false, class... Args>
+    bool try_emplace_l_impl(K&& k, F&& f, Args&&... args) {
+        using arg_type = std::conditional_t<kShared, const value_type&, value_type&>;
+
         size_t                hashval = this->hash(k);
-        UniqueLock            m;
+        L                     m;
         auto                  res   = this->find_or_prepare_insert_with_hash(hashval, k, m);
         typename Base::Inner* inner = std::get<0>(res);
 
@@ -4646,7 +6732,7 @@ public:
         } else {
             auto it = this->iterator_at(inner, inner->set_.iterator_at(std::get<1>(res)));
             // call lambda. in case of the set, non "key" part of value_type can be changed
-            std::forward<F>(f)(const_cast<value_type&>(*it));
+            std::forward<F>(f)(const_cast<arg_type>(*it));
         }
         return std::get<2>(res);
     }
@@ -4812,6 +6898,62 @@ struct FlatHashMapPolicy {
     static const V& value(const std::pair<const K, V>* kv) { return kv->second; }
 };
 
+// --------------------------------------------------------------------------
+// Same as `Policy`, but the tables grow incrementally (see
+// raw_hash_set::kIncremental).
+// --------------------------------------------------------------------------
+template<class Policy>
+struct IncrementalRehashPolicy : Policy {
+    using incremental_rehash = std::true_type;
+};
+
+// --------------------------------------------------------------------------
+// Same as `Policy`, but the capacities of the tables are not always powers of
+// 2, and they grow by 1.5x (see raw_hash_set::kTight).
+// --------------------------------------------------------------------------
+template<class Policy>
+struct TightCapacityPolicy : Policy {
+    using tight_capacity = std::true_type;
+};
+
+// --------------------------------------------------------------------------
+// Same as `Policy`, but each slot also stores the full hash of its element
+// (see raw_hash_set::kCachedHash).
+// --------------------------------------------------------------------------
+template<class Policy>
+struct CachedHashPolicy : Policy {
+    using cached_hash = std::true_type;
+
+    struct slot_type {
+        typename Policy::slot_type slot;
+        size_t                     hashval;
+    };
+
+    template<class Allocator, class... Args>
+    static void construct(Allocator* alloc, slot_type* slot, Args&&... args) {
+        Policy::construct(alloc, &slot->slot, std::forward<Args>(args)...);
+    }
+
+    template<class Allocator>
+    static void destroy(Allocator* alloc, slot_type* slot) {
+        Policy::destroy(alloc, &slot->slot);
+    }
+
+    template<class Allocator>
+    static void transfer(Allocator* alloc, slot_type* new_slot, slot_type* old_slot) {
+        Policy::transfer(alloc, &new_slot->slot, &old_slot->slot);
+        new_slot->hashval = old_slot->hashval;
+    }
+
+    static size_t space_used(const slot_type* slot) { return Policy::space_used(slot ? &slot->slot : nullptr); }
+
+    static auto element(slot_type* slot) -> decltype(Policy::element(&slot->slot)) {
+        return Policy::element(&slot->slot);
+    }
+
+    static size_t& stored_hash(slot_type* slot) { return slot->hashval; }
+};
+
 template<class Reference, class Policy>
 struct node_hash_policy {
     static_assert(std::is_lvalue_reference_v<Reference>, "");
@@ -4929,144 +7071,551 @@ public:
 };
 
 // --------------------------------------------------------------------------
-//  hash_default
+// String keys for string_flat_hash_map: keys of up to 15 bytes are stored
+// inline, longer ones in an append-only arena owned by the table (through
+// its allocator). The arena counts the bytes of the erased keys, and the
+// table moves its keys to a new arena once these take more space than the
+// live ones (see StringFlatHashMapPolicy::reclaimable).
 // --------------------------------------------------------------------------
+class string_arena {
+public:
+    string_arena() = default;
+
+    string_arena(const string_arena&)            = delete;
+    string_arena& operator=(const string_arena&) = delete;
+
+    // Returns a copy of `s` which stays valid until the arena is destroyed.
+    const char* store(std::string_view s) {
+        if (s.size() > kBlockSize / 4) {
+            // large strings get their own block, so the current one is kept
+            blocks_.emplace_back(new char[s.size()]);
+            used_ += s.size();
+            return static_cast<const char*>(std::memcpy(blocks_.back().get(), s.data(), s.size()));
+        }
+        if (s.size() > avail_) {
+            blocks_.emplace_back(new char[kBlockSize]);
+            cur_   = blocks_.back().get();
+            avail_ = kBlockSize;
+        }
+        char* res = cur_;
+        std::memcpy(res, s.data(), s.size());
+        cur_ += s.size();
+        avail_ -= s.size();
+        used_ += s.size();
+        return res;
+    }
 
-// Supports heterogeneous lookup for basic_string<T>-like elements.
-// support char16_t wchar_t ....
-template<class CharT>
-struct StringHashEqT {
-    struct Hash {
-        using is_transparent = void;
+    // Records that `n` bytes returned by store() are no longer referenced.
+    void release(size_t n) {
+        assert(n <= used_ - erased_);
+        erased_ += n;
+    }
 
-        size_t operator()(std::basic_string_view<CharT> v) const {
-            std::string_view bv{ reinterpret_cast<const char*>(v.data()), v.size() * sizeof(CharT) };
-            return std::hash<std::string_view>()(bv);
-        }
-    };
+    // Number of bytes stored, including those of the erased keys.
+    size_t bytes_used() const { return used_; }
 
-    struct Eq {
-        using is_transparent = void;
+    // Number of bytes of the erased keys.
+    size_t bytes_erased() const { return erased_; }
 
-        bool operator()(std::basic_string_view<CharT> lhs, std::basic_string_view<CharT> rhs) const {
-            return lhs == rhs;
-        }
-    };
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char*                                cur_    = nullptr;
+    size_t                               avail_  = 0;
+    size_t                               used_   = 0;
+    size_t                               erased_ = 0;
 };
 
-template<>
-struct HashEq<std::string> : StringHashEqT<char> {};
+// --------------------------------------------------------------------------
+// A 16 byte string key. The last byte is the size of a short key, whose bytes
+// are stored inline (zero padded), or kLongTag for a long key, which is stored
+// as a pointer into the arena, a 32 bit size and its first 3 bytes.
+//
+// The copy constructor is not trivial, so that phmap_dump does not write the
+// arena pointers to disk.
+// --------------------------------------------------------------------------
+class string_key {
+public:
+    static constexpr size_t kInlineCapacity = 15;
 
-template<>
-struct HashEq<std::string_view> : StringHashEqT<char> {};
+    string_key(string_arena& arena, std::string_view s) {
+        if (s.size() <= kInlineCapacity) {
+            std::memset(rep_, 0, sizeof(rep_));
+            std::memcpy(rep_, s.data(), s.size());
+            rep_[15] = static_cast<char>(s.size());
+        } else {
+            assert(s.size() <= (std::numeric_limits<uint32_t>::max)());
+            const char* p    = arena.store(s);
+            auto        size = static_cast<uint32_t>(s.size());
+            std::memcpy(rep_, &p, sizeof(p));
+            std::memcpy(rep_ + 8, &size, sizeof(size));
+            std::memcpy(rep_ + 12, s.data(), 3);
+            rep_[15] = static_cast<char>(kLongTag);
+        }
+    }
 
-// char16_t
-template<>
-struct HashEq<std::u16string> : StringHashEqT<char16_t> {};
+    string_key(const string_key& o) noexcept { std::memcpy(rep_, o.rep_, sizeof(rep_)); }
 
-template<>
-struct HashEq<std::u16string_view> : StringHashEqT<char16_t> {};
+    string_key& operator=(const string_key& o) noexcept {
+        std::memcpy(rep_, o.rep_, sizeof(rep_));
+        return *this;
+    }
 
-// wchar_t
-template<>
-struct HashEq<std::wstring> : StringHashEqT<wchar_t> {};
+    bool is_long() const { return static_cast<uint8_t>(rep_[15]) == kLongTag; }
 
-template<>
-struct HashEq<std::wstring_view> : StringHashEqT<wchar_t> {};
+    size_t size() const {
+        if (!is_long())
+            return static_cast<size_t>(rep_[15]);
+        uint32_t size;
+        std::memcpy(&size, rep_ + 8, sizeof(size));
+        return size;
+    }
 
-// Supports heterogeneous lookup for pointers and smart pointers.
-// -------------------------------------------------------------
-template<class T>
-struct HashEq<T*> {
-    struct Hash {
-        using is_transparent = void;
-        template<class U>
-        size_t operator()(const U& ptr) const {
-            // we want phmap::Hash<T*> and not phmap::Hash<const T*>
-            // so "struct std::hash<T*> " override works
-            return gtl::Hash<T*>{}((T*)(uintptr_t)HashEq::ToPtr(ptr));
-        }
-    };
+    const char* data() const {
+        if (!is_long())
+            return rep_;
+        const char* p;
+        std::memcpy(&p, rep_, sizeof(p));
+        return p;
+    }
 
-    struct Eq {
-        using is_transparent = void;
-        template<class A, class B>
-        bool operator()(const A& a, const B& b) const {
-            return HashEq::ToPtr(a) == HashEq::ToPtr(b);
-        }
-    };
+    std::string_view view() const { return { data(), size() }; }
 
-private:
-    static const T* ToPtr(const T* ptr) { return ptr; }
+    operator std::string_view() const { return view(); }
 
-    template<class U, class D>
-    static const T* ToPtr(const std::unique_ptr<U, D>& ptr) {
-        return ptr.get();
+    // The sizes (and first bytes of long keys) are compared before the bytes
+    // stored in the arena.
+    bool operator==(const string_key& o) const {
+        if (std::memcmp(rep_ + 8, o.rep_ + 8, 8) != 0)
+            return false;
+        if (!is_long())
+            return std::memcmp(rep_, o.rep_, 8) == 0;
+        return std::memcmp(data(), o.data(), size()) == 0;
     }
 
-    template<class U>
-    static const T* ToPtr(const std::shared_ptr<U>& ptr) {
-        return ptr.get();
+    bool operator==(std::string_view v) const {
+        if (v.size() != size())
+            return false;
+        if (!is_long())
+            return std::memcmp(rep_, v.data(), v.size()) == 0;
+        return std::memcmp(rep_ + 12, v.data(), 3) == 0 && std::memcmp(data(), v.data(), v.size()) == 0;
     }
-};
-
-template<class T, class D>
-struct HashEq<std::unique_ptr<T, D>> : HashEq<T*> {};
 
-template<class T>
-struct HashEq<std::shared_ptr<T>> : HashEq<T*> {};
+private:
+    static constexpr uint8_t kLongTag = 0xFF;
 
-namespace hashtable_debug_internal {
+    alignas(8) char rep_[16];
+};
 
 // --------------------------------------------------------------------------
+// The allocator of the string_flat_hash_map tables. Every default constructed
+// allocator creates an arena for the long keys, which its copies share, and
+// which is its identity: two allocators are equal when they share an arena.
+// Like the memory resource of a std::pmr container, the arena is not
+// thread-safe, so tables given copies of one allocator must not be modified
+// concurrently. A copy constructed table gets a new arena, and so does every
+// submap of a parallel table (through select_on_submap_construction()), even
+// when the parallel table is given an allocator which already owns one. A
+// moved-from table shares the arena of the table it was moved to.
+//
+// A table replaces its arena with a new one when it has no elements left, or,
+// in clear(), rehash() and compact(), once the long keys erased from it take
+// more space than the others (which are then copied to the new arena). The allocators copied from the table
+// before keep the previous arena alive, and no longer compare equal to the
+// table's.
+//
+// The long keys of the elements moved in by merge() or a node handle from a
+// table with another arena are copied to the arena of the destination table.
 // --------------------------------------------------------------------------
+template<class T>
+class string_arena_allocator {
+public:
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
 
-template<typename, typename = void>
-struct has_member_type_raw_hash_set : std::false_type {};
-template<typename T>
-struct has_member_type_raw_hash_set<T, std::void_t<typename T::raw_hash_set>> : std::true_type {};
+    string_arena_allocator()
+        : arena_(std::make_shared<string_arena>()) {}
 
-template<typename Set>
-struct HashtableDebugAccess<Set, std::enable_if_t<has_member_type_raw_hash_set<Set>::value>> {
-    using Traits = typename Set::PolicyTraits;
-    using Slot   = typename Traits::slot_type;
+    // no move constructor: a moved-from allocator must still equal its copy
+    string_arena_allocator(const string_arena_allocator&) noexcept            = default;
+    string_arena_allocator& operator=(const string_arena_allocator&) noexcept = default;
 
-    static size_t GetNumProbes(const Set& set, const typename Set::key_type& key) {
-        if (!set.ctrl_)
-            return 0;
-        size_t num_probes = 0;
-        size_t hashval    = set.hash(key);
-        auto   seq        = set.probe(hashval);
-        while (true) {
-            priv::Group g{ set.ctrl_ + seq.offset() };
-            for (uint32_t i : g.Match(priv::H2(hashval))) {
-                if (Traits::apply(typename Set::template EqualElement<typename Set::key_type>{ key, set.eq_ref() },
-                                  Traits::element(set.slots_ + seq.offset((size_t)i))))
-                    return num_probes;
-                ++num_probes;
-            }
-            if (g.MatchEmpty())
-                return num_probes;
-            seq.next();
-            ++num_probes;
-        }
-    }
+    template<class U>
+    string_arena_allocator(const string_arena_allocator<U>& o) noexcept
+        : arena_(o.arena_) {}
 
-    static size_t AllocatedByteSize(const Set& c) {
-        size_t capacity = c.capacity_;
-        if (capacity == 0)
-            return 0;
-        auto   layout = Set::MakeLayout(capacity);
-        size_t m      = layout.AllocSize();
+    T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
 
-        size_t per_slot = Traits::space_used(static_cast<const Slot*>(nullptr));
-        if (per_slot != ~size_t{}) {
-            m += per_slot * c.size();
-        } else {
-            for (size_t i = 0; i != capacity; ++i) {
-                if (priv::IsFull(c.ctrl_[i])) {
-                    m += Traits::space_used(c.slots_ + i);
-                }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    string_arena_allocator select_on_container_copy_construction() const { return {}; }
+    string_arena_allocator select_on_submap_construction() const { return {}; }
+
+    // The arena is shared by the copies of the allocator, not owned by one.
+    string_arena& arena() const { return *arena_; }
+
+    // Gives this allocator (but not its copies) a new arena.
+    void renew_arena() { arena_ = std::make_shared<string_arena>(); }
+
+    size_t arena_bytes_used() const { return arena_->bytes_used(); }
+
+    template<class U>
+    bool operator==(const string_arena_allocator<U>& o) const {
+        return arena_ == o.arena_;
+    }
+
+private:
+    template<class U>
+    friend class string_arena_allocator;
+
+    std::shared_ptr<string_arena> arena_;
+};
+
+// --------------------------------------------------------------------------
+// Like FlatHashMapPolicy, but the keys are stored as string_key, copied from
+// any argument convertible to std::string_view.
+// --------------------------------------------------------------------------
+template<class V>
+struct StringFlatHashMapPolicy {
+    using slot_policy = priv::map_slot_policy<string_key, V>;
+    using slot_type   = typename slot_policy::slot_type;
+    using key_type    = string_key;
+    using mapped_type = V;
+    using init_type   = std::pair<std::string_view, mapped_type>;
+    using is_flat     = std::true_type;
+
+    template<class Allocator, class... Args>
+    static void construct(Allocator* alloc, slot_type* slot, Args&&... args) {
+        auto       args_pair = gtl::priv::PairArgs(std::forward<Args>(args)...);
+        string_key key(alloc->arena(), std::string_view(std::get<0>(args_pair.first)));
+        slot_policy::construct(
+            alloc, slot, std::piecewise_construct, std::forward_as_tuple(key), std::move(args_pair.second));
+    }
+
+    template<class Allocator>
+    static void destroy(Allocator* alloc, slot_type* slot) {
+        if (slot->value.first.is_long())
+            alloc->arena().release(slot->value.first.size());
+        slot_policy::destroy(alloc, slot);
+    }
+
+    template<class Allocator>
+    static void transfer(Allocator* alloc, slot_type* new_slot, slot_type* old_slot) {
+        slot_policy::transfer(alloc, new_slot, old_slot);
+    }
+
+    // Copies the long key of an element moved in from a table with the
+    // allocator `from` (by merge() or a node handle) to the arena of `alloc`.
+    template<class Allocator>
+    static void adopt(Allocator* alloc, const Allocator& from, slot_type* slot) {
+        if (!slot->value.first.is_long())
+            return;
+        from.arena().release(slot->value.first.size());
+        rekey(alloc, slot);
+    }
+
+    // Tells raw_hash_set::reclaim() whether to give `alloc` a new arena: when
+    // the table has no elements left (clear() does not destroy them one by
+    // one), or when the erased keys take more space in the current arena than
+    // the live keys, and than `visit_cost`, the bytes worth of work it takes
+    // to find these.
+    template<class Allocator>
+    static bool reclaimable(const Allocator& alloc, size_t size, size_t visit_cost) {
+        const string_arena& arena  = alloc.arena();
+        const size_t        erased = arena.bytes_erased();
+        if (!size)
+            return arena.bytes_used() != 0;
+        return erased && erased >= arena.bytes_used() - erased && erased >= visit_cost;
+    }
+
+    template<class Allocator>
+    static void renew(Allocator* alloc) {
+        alloc->renew_arena();
+    }
+
+    // Copies the long key of an element to the arena of `alloc`, and rebuilds
+    // the element around it. The new key is stored before the element is
+    // destroyed, and the value moved back cannot throw, so the slot always
+    // holds an element.
+    template<class Allocator>
+    static void rekey(Allocator* alloc, slot_type* slot) {
+        static_assert(std::is_nothrow_move_constructible_v<V>,
+                      "the mapped type of a string_flat_hash_map must be nothrow move constructible");
+        if (!slot->value.first.is_long())
+            return;
+        string_key key(alloc->arena(), slot->value.first.view());
+        V          value(std::move(slot->value.second));
+        slot_policy::destroy(alloc, slot);
+        slot_policy::construct(
+            alloc, slot, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::move(value)));
+    }
+
+    template<class F, class... Args>
+    static decltype(gtl::priv::DecomposePair(std::declval<F>(), std::declval<Args>()...)) apply(F&& f, Args&&... args) {
+        return gtl::priv::DecomposePair(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    static size_t space_used(const slot_type*) { return 0; }
+
+    static std::pair<const string_key, V>& element(slot_type* slot) { return slot->value; }
+
+    static V&       value(std::pair<const string_key, V>* kv) { return kv->second; }
+    static const V& value(const std::pair<const string_key, V>* kv) { return kv->second; }
+};
+
+// --------------------------------------------------------------------------
+// An allocator which keeps the blocks it is given back, and reuses them for
+// later allocations of the same size, instead of returning them to the
+// system. The blocks are freed when the last copy of the allocator is
+// destroyed (i.e. with the map), so the memory held is bounded by the peak
+// usage of each block size. As tables grow by doubling, the previous tables
+// of a growing map are seldom reused: expect up to twice the memory of the
+// largest tables, until the map is destroyed. The copies share one mutex,
+// only taken when a table is allocated or freed, and one free list per
+// distinct block size.
+//
+// With gtl::SeqMutex, the optimistic readers of a parallel_hash_set may still
+// be probing a submap's previous table after a resize; this guarantees that
+// its memory is still mapped (see gtl::parallel_flat_hash_map_seqlock).
+// --------------------------------------------------------------------------
+class retained_blocks {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    retained_blocks() = default;
+    retained_blocks(const retained_blocks&) = delete;
+    retained_blocks& operator=(const retained_blocks&) = delete;
+
+    ~retained_blocks() {
+        for (auto& [bytes, blocks] : free_)
+            for (void* p : blocks)
+                ::operator delete(p, bytes, std::align_val_t(kAlignment));
+    }
+
+    void* allocate(size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& [sz, blocks] : free_) {
+                if (sz == bytes && !blocks.empty()) {
+                    void* p = blocks.back();
+                    blocks.pop_back();
+                    return p;
+                }
+            }
+        }
+        return ::operator new(bytes, std::align_val_t(kAlignment));
+    }
+
+    void deallocate(void* p, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [sz, blocks] : free_) {
+            if (sz == bytes) {
+                blocks.push_back(p);
+                return;
+            }
+        }
+        free_.emplace_back(bytes, std::vector<void*>{ p });
+    }
+
+private:
+    std::mutex                                        mutex_;
+    std::vector<std::pair<size_t, std::vector<void*>>> free_; // few distinct sizes
+};
+
+template<class T>
+class retaining_allocator {
+public:
+    static_assert(alignof(T) <= retained_blocks::kAlignment);
+
+    using value_type      = T;
+    using is_always_equal = std::false_type;
+
+    static constexpr bool kRetainsMemory = true;
+
+    retaining_allocator()
+        : blocks_(std::make_shared<retained_blocks>()) {}
+
+    template<class U>
+    retaining_allocator(const retaining_allocator<U>& o) noexcept
+        : blocks_(o.blocks_) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(blocks_->allocate(n * sizeof(T))); }
+
+    void deallocate(T* p, size_t n) { blocks_->deallocate(p, n * sizeof(T)); }
+
+    template<class U>
+    bool operator==(const retaining_allocator<U>& o) const {
+        return blocks_ == o.blocks_;
+    }
+
+private:
+    template<class U>
+    friend class retaining_allocator;
+
+    std::shared_ptr<retained_blocks> blocks_;
+};
+
+// --------------------------------------------------------------------------
+//  hash_default
+// --------------------------------------------------------------------------
+
+// Supports heterogeneous lookup for basic_string<T>-like elements.
+// support char16_t wchar_t ....
+template<class CharT>
+struct StringHashEqT {
+    struct Hash {
+        using is_transparent = void;
+
+        size_t operator()(std::basic_string_view<CharT> v) const {
+            return fold_if_needed<sizeof(size_t)>()(gtl::hash_bytes(v.data(), v.size() * sizeof(CharT)));
+        }
+    };
+
+    struct Eq {
+        using is_transparent = void;
+
+        bool operator()(std::basic_string_view<CharT> lhs, std::basic_string_view<CharT> rhs) const {
+            return lhs == rhs;
+        }
+    };
+};
+
+template<>
+struct HashEq<std::string> : StringHashEqT<char> {};
+
+template<>
+struct HashEq<std::string_view> : StringHashEqT<char> {};
+
+// char16_t
+template<>
+struct HashEq<std::u16string> : StringHashEqT<char16_t> {};
+
+template<>
+struct HashEq<std::u16string_view> : StringHashEqT<char16_t> {};
+
+// wchar_t
+template<>
+struct HashEq<std::wstring> : StringHashEqT<wchar_t> {};
+
+template<>
+struct HashEq<std::wstring_view> : StringHashEqT<wchar_t> {};
+
+// string_key (see string_flat_hash_map), with heterogeneous lookup by
+// std::string_view
+struct string_key_hash : StringHashEqT<char>::Hash {};
+
+struct string_key_eq {
+    using is_transparent = void;
+
+    bool operator()(const string_key& lhs, const string_key& rhs) const { return lhs == rhs; }
+    bool operator()(const string_key& lhs, std::string_view rhs) const { return lhs == rhs; }
+    bool operator()(std::string_view lhs, const string_key& rhs) const { return rhs == lhs; }
+    bool operator()(std::string_view lhs, std::string_view rhs) const { return lhs == rhs; }
+};
+
+template<>
+struct HashEq<string_key> {
+    using Hash = string_key_hash;
+    using Eq   = string_key_eq;
+};
+
+// Supports heterogeneous lookup for pointers and smart pointers.
+// -------------------------------------------------------------
+template<class T>
+struct HashEq<T*> {
+    struct Hash {
+        using is_transparent = void;
+        template<class U>
+        size_t operator()(const U& ptr) const {
+            // we want phmap::Hash<T*> and not phmap::Hash<const T*>
+            // so "struct std::hash<T*> " override works
+            return gtl::Hash<T*>{}((T*)(uintptr_t)HashEq::ToPtr(ptr));
+        }
+    };
+
+    struct Eq {
+        using is_transparent = void;
+        template<class A, class B>
+        bool operator()(const A& a, const B& b) const {
+            return HashEq::ToPtr(a) == HashEq::ToPtr(b);
+        }
+    };
+
+private:
+    static const T* ToPtr(const T* ptr) { return ptr; }
+
+    template<class U, class D>
+    static const T* ToPtr(const std::unique_ptr<U, D>& ptr) {
+        return ptr.get();
+    }
+
+    template<class U>
+    static const T* ToPtr(const std::shared_ptr<U>& ptr) {
+        return ptr.get();
+    }
+};
+
+template<class T, class D>
+struct HashEq<std::unique_ptr<T, D>> : HashEq<T*> {};
+
+template<class T>
+struct HashEq<std::shared_ptr<T>> : HashEq<T*> {};
+
+namespace hashtable_debug_internal {
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+template<typename, typename = void>
+struct has_member_type_raw_hash_set : std::false_type {};
+template<typename T>
+struct has_member_type_raw_hash_set<T, std::void_t<typename T::raw_hash_set>> : std::true_type {};
+
+template<typename Set>
+struct HashtableDebugAccess<Set, std::enable_if_t<has_member_type_raw_hash_set<Set>::value>> {
+    using Traits = typename Set::PolicyTraits;
+    using Slot   = typename Traits::slot_type;
+
+    static size_t GetNumProbes(const Set& set, const typename Set::key_type& key) {
+        if (!set.ctrl_)
+            return 0;
+        size_t num_probes = 0;
+        size_t hashval    = set.hash(key);
+        auto   seq        = set.probe(hashval);
+        while (true) {
+            priv::Group g{ set.ctrl_ + seq.offset() };
+            for (uint32_t i : g.Match(priv::H2(hashval))) {
+                if (Traits::apply(typename Set::template EqualElement<typename Set::key_type>{ key, set.eq_ref() },
+                                  Traits::element(set.slots_ + seq.offset((size_t)i))))
+                    return num_probes;
+                ++num_probes;
+            }
+            if (g.MatchEmpty())
+                return num_probes;
+            seq.next();
+            ++num_probes;
+        }
+    }
+
+    static size_t AllocatedByteSize(const Set& c) {
+        size_t capacity = c.capacity_;
+        if (capacity == 0)
+            return 0;
+        auto   layout = Set::MakeLayout(capacity);
+        size_t m      = layout.AllocSize();
+
+        size_t per_slot = Traits::space_used(static_cast<const Slot*>(nullptr));
+        if (per_slot != ~size_t{}) {
+            m += per_slot * c.size();
+        } else {
+            for (size_t i = 0; i != capacity; ++i) {
+                if (priv::IsFull(c.ctrl_[i])) {
+                    m += Traits::space_used(c.slots_ + i);
+                }
             }
         }
         return m;
@@ -5076,7 +7625,7 @@ struct HashtableDebugAccess<Set, std::enable_if_t<has_member_type_raw_hash_set<S
         size_t capacity = GrowthToLowerboundCapacity(size);
         if (capacity == 0)
             return 0;
-        auto   layout   = Set::MakeLayout(NormalizeCapacity(capacity));
+        auto   layout   = Set::MakeLayout(Set::normalize_capacity(capacity));
         size_t m        = layout.AllocSize();
         size_t per_slot = Traits::space_used(static_cast<const Slot*>(nullptr));
         if (per_slot != ~size_t{}) {
@@ -5108,6 +7657,14 @@ struct HashtableDebugAccess<Set, std::enable_if_t<has_member_type_EmbeddedSet<Se
 } // namespace hashtable_debug_internal
 } // namespace priv
 
+using string_key = priv::string_key;
+
+template<class T>
+using string_arena_allocator = priv::string_arena_allocator<T>;
+
+template<class T>
+using retaining_allocator = priv::retaining_allocator<T>;
+
 // -----------------------------------------------------------------------------
 // gtl::flat_hash_set
 // -----------------------------------------------------------------------------
@@ -5143,6 +7700,7 @@ public:
     using Base::cend;
     using Base::clear; // may shrink - To avoid shrinking `erase(begin(), end())`
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
@@ -5152,10 +7710,12 @@ public:
     using Base::erase;
     using Base::extract;
     using Base::find;
+    using Base::find_many;
     using Base::get_allocator;
     using Base::hash;
     using Base::hash_function;
     using Base::insert;
+    using Base::insert_unique_unchecked;
     using Base::key_eq;
     using Base::load_factor;
     using Base::max_load_factor;
@@ -5194,7 +7754,531 @@ class flat_hash_map : public gtl::priv::raw_hash_map<gtl::priv::FlatHashMapPolic
 public:
     flat_hash_map() {}
 #ifdef __INTEL_COMPILER
-    using Base::raw_hash_map;
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::at;
+    using Base::begin;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    using Base::try_emplace;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+};
+
+// -----------------------------------------------------------------------------
+// gtl::flat_hash_map_incremental
+// -----------------------------------------------------------------------------
+// A `gtl::flat_hash_map` which grows incrementally: when the table is full, the
+// elements are not all moved to the larger table at once. Instead, every
+// following insertion moves the elements of a few groups, and lookups check
+// both tables until the old one is empty. This removes the latency spike of
+// the insertion which triggers the resize, at the cost of slightly slower
+// lookups while the old table is being drained.
+//
+// * Insertions invalidate iterators, references and pointers to elements,
+//   even when no resize was triggered.
+// -----------------------------------------------------------------------------
+template<class K, class V, class Hash, class Eq, class Alloc> // default values in
+                                                              // phmap_fwd_decl.hpp
+class flat_hash_map_incremental
+    : public gtl::priv::raw_hash_map<gtl::priv::IncrementalRehashPolicy<gtl::priv::FlatHashMapPolicy<K, V>>,
+                                     Hash,
+                                     Eq,
+                                     Alloc> {
+
+    using Base = typename flat_hash_map_incremental::raw_hash_map;
+
+public:
+    flat_hash_map_incremental() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::at;
+    using Base::begin;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    using Base::try_emplace;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+};
+
+// -----------------------------------------------------------------------------
+// gtl::flat_hash_map_tight
+// -----------------------------------------------------------------------------
+// A `gtl::flat_hash_map` whose capacity is not always a power of 2 minus 1:
+// it is a multiple of the group width minus 1, and the table grows by 1.5x
+// instead of 2x when full. Right after a resize, the table uses at most 1.5x
+// the memory it needs instead of 2x, and `reserve(n)` allocates about the
+// memory needed for `n` elements. This matters for very large tables.
+//
+// * Tables grow more often, so inserting many elements without a `reserve()`
+//   is slower.
+// * The lookups are a little slower: the first group of a probe sequence is
+//   found with a multiply-shift instead of a mask.
+// -----------------------------------------------------------------------------
+template<class K, class V, class Hash, class Eq, class Alloc> // default values in
+                                                              // phmap_fwd_decl.hpp
+class flat_hash_map_tight
+    : public gtl::priv::raw_hash_map<gtl::priv::TightCapacityPolicy<gtl::priv::FlatHashMapPolicy<K, V>>,
+                                     Hash,
+                                     Eq,
+                                     Alloc> {
+
+    using Base = typename flat_hash_map_tight::raw_hash_map;
+
+public:
+    flat_hash_map_tight() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::at;
+    using Base::begin;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    using Base::try_emplace;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+};
+
+// -----------------------------------------------------------------------------
+// gtl::flat_hash_map_cached_hash
+// -----------------------------------------------------------------------------
+// A `gtl::flat_hash_map` which stores the full hash of each element next to it,
+// for keys which are expensive to hash or to compare, like strings or tuples:
+// resizing the table does not hash the keys again, and lookups only compare
+// the keys of the elements whose full hash matches. Each slot is
+// `sizeof(size_t)` bytes larger (plus padding) than in a `flat_hash_map`.
+// -----------------------------------------------------------------------------
+template<class K, class V, class Hash, class Eq, class Alloc> // default values in
+                                                              // phmap_fwd_decl.hpp
+class flat_hash_map_cached_hash
+    : public gtl::priv::raw_hash_map<gtl::priv::CachedHashPolicy<gtl::priv::FlatHashMapPolicy<K, V>>,
+                                     Hash,
+                                     Eq,
+                                     Alloc> {
+
+    using Base = typename flat_hash_map_cached_hash::raw_hash_map;
+
+public:
+    flat_hash_map_cached_hash() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::at;
+    using Base::begin;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    using Base::try_emplace;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+};
+
+// -----------------------------------------------------------------------------
+// gtl::string_flat_hash_map
+// -----------------------------------------------------------------------------
+// A flat hash map from strings to `V`, more compact than a
+// `gtl::flat_hash_map<std::string, V>`: the keys are stored as 16 byte
+// `gtl::string_key`, which hold keys of up to 15 bytes inline. Longer keys are
+// copied to an append-only arena owned by the map, instead of one heap
+// allocation each. Lookups accept any type convertible to `std::string_view`.
+//
+// * The space of the erased long keys is released when the map becomes empty,
+//   or once it exceeds that of the remaining long keys, which are then copied
+//   to a new arena by clear(), rehash() (or a resize on insertion) and
+//   compact(). These calls invalidate the `std::string_view` of the keys, as
+//   they invalidate iterators; erase() only invalidates the erased key.
+// * The mapped type must be nothrow move constructible.
+// * The keys are `gtl::string_key`, convertible to `std::string_view`.
+// -----------------------------------------------------------------------------
+template<class V, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.hpp
+class string_flat_hash_map
+    : public gtl::priv::raw_hash_map<gtl::priv::StringFlatHashMapPolicy<V>, Hash, Eq, Alloc> {
+
+    using Base = typename string_flat_hash_map::raw_hash_map;
+
+public:
+    string_flat_hash_map() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::at;
+    using Base::begin;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::compact;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    using Base::try_emplace;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+};
+
+// -----------------------------------------------------------------------------
+// gtl::node_hash_set
+// -----------------------------------------------------------------------------
+// An `gtl::node_hash_set<T>` is an unordered associative container which
+// has been optimized for both speed and memory footprint in most common use
+// cases. Its interface is similar to that of `std::unordered_set<T>` with the
+// following notable differences:
+//
+// * Supports heterogeneous lookup, through `find()`, `operator[]()` and
+//   `insert()`, provided that the map is provided a compatible heterogeneous
+//   hashing function and equality operator.
+// * Contains a `capacity()` member function indicating the number of element
+//   slots (open, deleted, and empty) within the hash set.
+// * Returns `void` from the `_erase(iterator)` overload.
+// -----------------------------------------------------------------------------
+template<class T, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.hpp
+class node_hash_set : public gtl::priv::raw_hash_set<gtl::priv::NodeHashSetPolicy<T>, Hash, Eq, Alloc> {
+    using Base = typename node_hash_set::raw_hash_set;
+
+public:
+    node_hash_set() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_set;
+#else
+    using Base::Base;
+#endif
+    using Base::begin;
+    using Base::bucket_count;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::emplace_hint_with_hash;
+    using Base::emplace_with_hash;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    typename Base::hasher hash_funct() { return this->hash_function(); }
+    void                  resize(typename Base::size_type hint) { this->rehash(hint); }
+};
+
+// -----------------------------------------------------------------------------
+// gtl::node_hash_map
+// -----------------------------------------------------------------------------
+//
+// An `gtl::node_hash_map<K, V>` is an unordered associative container which
+// has been optimized for both speed and memory footprint in most common use
+// cases. Its interface is similar to that of `std::unordered_map<K, V>` with
+// the following notable differences:
+//
+// * Supports heterogeneous lookup, through `find()`, `operator[]()` and
+//   `insert()`, provided that the map is provided a compatible heterogeneous
+//   hashing function and equality operator.
+// * Contains a `capacity()` member function indicating the number of element
+//   slots (open, deleted, and empty) within the hash map.
+// * Returns `void` from the `_erase(iterator)` overload.
+// -----------------------------------------------------------------------------
+template<class Key, class Value, class Hash, class Eq, class Alloc> // default values in
+                                                                    // phmap_fwd_decl.hpp
+class node_hash_map : public gtl::priv::raw_hash_map<gtl::priv::NodeHashMapPolicy<Key, Value>, Hash, Eq, Alloc> {
+    using Base = typename node_hash_map::raw_hash_map;
+
+public:
+    node_hash_map() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::at;
+    using Base::begin;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::swap;
+    using Base::try_emplace;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    typename Base::hasher hash_funct() { return this->hash_function(); }
+    void                  resize(typename Base::size_type hint) { this->rehash(hint); }
+};
+
+// -----------------------------------------------------------------------------
+// gtl::parallel_flat_hash_set
+// -----------------------------------------------------------------------------
+template<class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
+// default values in phmap_fwd_decl.hpp
+class parallel_flat_hash_set
+    : public gtl::priv::parallel_hash_set<N,
+                                          gtl::priv::raw_hash_set,
+                                          Mtx_,
+                                          AuxCont,
+                                          gtl::priv::FlatHashSetPolicy<T>,
+                                          Hash,
+                                          Eq,
+                                          Alloc> {
+    using Base = typename parallel_flat_hash_set::parallel_hash_set;
+
+public:
+    parallel_flat_hash_set() {}
+#ifdef __INTEL_COMPILER
+    using Base::parallel_hash_set;
+#else
+    using Base::Base;
+#endif
+    using Base::begin;
+    using Base::bucket_count;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::compact;
+    using Base::contains;
+    using Base::contains_many;
+    using Base::count;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::emplace_hint_with_hash;
+    using Base::emplace_with_hash;
+    using Base::empty;
+    using Base::end;
+    using Base::equal_range;
+    using Base::erase;
+    using Base::extract;
+    using Base::find;
+    using Base::find_many;
+    using Base::get_allocator;
+    using Base::hash;
+    using Base::hash_function;
+    using Base::insert;
+    using Base::insert_unique_unchecked;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::max_size;
+    using Base::merge;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+    using Base::subcnt;
+    using Base::subidx;
+    using Base::swap;
+};
+
+// -----------------------------------------------------------------------------
+// gtl::parallel_flat_hash_map - default values in phmap_fwd_decl.hpp
+// -----------------------------------------------------------------------------
+template<class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
+class parallel_flat_hash_map
+    : public gtl::priv::parallel_hash_map<N,
+                                          gtl::priv::raw_hash_set,
+                                          Mtx_,
+                                          AuxCont,
+                                          gtl::priv::FlatHashMapPolicy<K, V>,
+                                          Hash,
+                                          Eq,
+                                          Alloc> {
+    using Base = typename parallel_flat_hash_map::parallel_hash_map;
+
+public:
+    parallel_flat_hash_map() {}
+#ifdef __INTEL_COMPILER
+    using Base::parallel_hash_map;
 #else
     using Base::Base;
 #endif
@@ -5204,29 +8288,38 @@ public:
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
+    using Base::emplace_hint_with_hash;
+    using Base::emplace_with_hash;
     using Base::empty;
     using Base::end;
     using Base::equal_range;
     using Base::erase;
     using Base::extract;
     using Base::find;
+    using Base::find_many;
+    using Base::hash;
     using Base::insert;
+    using Base::insert_unique_unchecked;
     using Base::insert_or_assign;
     using Base::max_size;
     using Base::merge;
     using Base::rehash;
     using Base::reserve;
     using Base::size;
+    using Base::subcnt;
+    using Base::subidx;
     using Base::swap;
     using Base::try_emplace;
+    using Base::try_emplace_with_hash;
     using Base::operator[];
     using Base::bucket_count;
     using Base::get_allocator;
-    using Base::hash;
     using Base::hash_function;
     using Base::key_eq;
     using Base::load_factor;
@@ -5234,38 +8327,39 @@ public:
 };
 
 // -----------------------------------------------------------------------------
-// gtl::node_hash_set
+// gtl::parallel_flat_hash_map_incremental - default values in phmap_fwd_decl.hpp
 // -----------------------------------------------------------------------------
-// An `gtl::node_hash_set<T>` is an unordered associative container which
-// has been optimized for both speed and memory footprint in most common use
-// cases. Its interface is similar to that of `std::unordered_set<T>` with the
-// following notable differences:
-//
-// * Supports heterogeneous lookup, through `find()`, `operator[]()` and
-//   `insert()`, provided that the map is provided a compatible heterogeneous
-//   hashing function and equality operator.
-// * Contains a `capacity()` member function indicating the number of element
-//   slots (open, deleted, and empty) within the hash set.
-// * Returns `void` from the `_erase(iterator)` overload.
+// A `gtl::parallel_flat_hash_map` whose submaps grow incrementally, like
+// `gtl::flat_hash_map_incremental`.
 // -----------------------------------------------------------------------------
-template<class T, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.hpp
-class node_hash_set : public gtl::priv::raw_hash_set<gtl::priv::NodeHashSetPolicy<T>, Hash, Eq, Alloc> {
-    using Base = typename node_hash_set::raw_hash_set;
+template<class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
+class parallel_flat_hash_map_incremental
+    : public gtl::priv::parallel_hash_map<N,
+                                          gtl::priv::raw_hash_set,
+                                          Mtx_,
+                                          AuxCont,
+                                          gtl::priv::IncrementalRehashPolicy<gtl::priv::FlatHashMapPolicy<K, V>>,
+                                          Hash,
+                                          Eq,
+                                          Alloc> {
+    using Base = typename parallel_flat_hash_map_incremental::parallel_hash_map;
 
 public:
-    node_hash_set() {}
+    parallel_flat_hash_map_incremental() {}
 #ifdef __INTEL_COMPILER
-    using Base::raw_hash_set;
+    using Base::parallel_hash_map;
 #else
     using Base::Base;
 #endif
+    using Base::at;
     using Base::begin;
-    using Base::bucket_count;
     using Base::capacity;
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
@@ -5277,48 +8371,52 @@ public:
     using Base::erase;
     using Base::extract;
     using Base::find;
-    using Base::get_allocator;
+    using Base::find_many;
     using Base::hash;
-    using Base::hash_function;
     using Base::insert;
-    using Base::key_eq;
-    using Base::load_factor;
-    using Base::max_load_factor;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
     using Base::max_size;
     using Base::merge;
     using Base::rehash;
     using Base::reserve;
     using Base::size;
+    using Base::subcnt;
+    using Base::subidx;
     using Base::swap;
-    typename Base::hasher hash_funct() { return this->hash_function(); }
-    void                  resize(typename Base::size_type hint) { this->rehash(hint); }
+    using Base::try_emplace;
+    using Base::try_emplace_with_hash;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
 };
 
 // -----------------------------------------------------------------------------
-// gtl::node_hash_map
+// gtl::parallel_flat_hash_map_tight - default values in phmap_fwd_decl.hpp
 // -----------------------------------------------------------------------------
-//
-// An `gtl::node_hash_map<K, V>` is an unordered associative container which
-// has been optimized for both speed and memory footprint in most common use
-// cases. Its interface is similar to that of `std::unordered_map<K, V>` with
-// the following notable differences:
-//
-// * Supports heterogeneous lookup, through `find()`, `operator[]()` and
-//   `insert()`, provided that the map is provided a compatible heterogeneous
-//   hashing function and equality operator.
-// * Contains a `capacity()` member function indicating the number of element
-//   slots (open, deleted, and empty) within the hash map.
-// * Returns `void` from the `_erase(iterator)` overload.
+// A `gtl::parallel_flat_hash_map` whose submaps have tight capacities, like
+// `gtl::flat_hash_map_tight`.
 // -----------------------------------------------------------------------------
-template<class Key, class Value, class Hash, class Eq, class Alloc> // default values in
-                                                                    // phmap_fwd_decl.hpp
-class node_hash_map : public gtl::priv::raw_hash_map<gtl::priv::NodeHashMapPolicy<Key, Value>, Hash, Eq, Alloc> {
-    using Base = typename node_hash_map::raw_hash_map;
+template<class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
+class parallel_flat_hash_map_tight
+    : public gtl::priv::parallel_hash_map<N,
+                                          gtl::priv::raw_hash_set,
+                                          Mtx_,
+                                          AuxCont,
+                                          gtl::priv::TightCapacityPolicy<gtl::priv::FlatHashMapPolicy<K, V>>,
+                                          Hash,
+                                          Eq,
+                                          Alloc> {
+    using Base = typename parallel_flat_hash_map_tight::parallel_hash_map;
 
 public:
-    node_hash_map() {}
+    parallel_flat_hash_map_tight() {}
 #ifdef __INTEL_COMPILER
-    using Base::raw_hash_map;
+    using Base::parallel_hash_map;
 #else
     using Base::Base;
 #endif
@@ -5328,67 +8426,84 @@ public:
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
+    using Base::emplace_hint_with_hash;
+    using Base::emplace_with_hash;
     using Base::empty;
     using Base::end;
     using Base::equal_range;
     using Base::erase;
     using Base::extract;
     using Base::find;
+    using Base::find_many;
+    using Base::hash;
     using Base::insert;
+    using Base::insert_unique_unchecked;
     using Base::insert_or_assign;
     using Base::max_size;
     using Base::merge;
     using Base::rehash;
     using Base::reserve;
     using Base::size;
+    using Base::subcnt;
+    using Base::subidx;
     using Base::swap;
     using Base::try_emplace;
+    using Base::try_emplace_with_hash;
     using Base::operator[];
     using Base::bucket_count;
     using Base::get_allocator;
-    using Base::hash;
     using Base::hash_function;
     using Base::key_eq;
     using Base::load_factor;
     using Base::max_load_factor;
-    typename Base::hasher hash_funct() { return this->hash_function(); }
-    void                  resize(typename Base::size_type hint) { this->rehash(hint); }
 };
 
 // -----------------------------------------------------------------------------
-// gtl::parallel_flat_hash_set
+// gtl::parallel_flat_hash_map_seqlock - default values in phmap_fwd_decl.hpp
 // -----------------------------------------------------------------------------
-template<class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
-// default values in phmap_fwd_decl.hpp
-class parallel_flat_hash_set
-    : public gtl::priv::parallel_hash_set<N,
+// A `gtl::parallel_flat_hash_map` for read-mostly workloads: the submaps are
+// protected by a `gtl::SeqMutex`, and their memory is kept by a
+// `gtl::retaining_allocator`, so that `if_contains()`, `contains()` and
+// `count()` don't take any lock when the keys are arithmetic or enums and the
+// values are trivially copyable. Writers still lock the submaps as usual.
+// The price is memory: the tables left behind when the submaps grow are only
+// released with the map, so a map which grew to its size can hold up to
+// twice the memory of a `gtl::parallel_flat_hash_map`.
+// -----------------------------------------------------------------------------
+template<class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+class parallel_flat_hash_map_seqlock
+    : public gtl::priv::parallel_hash_map<N,
                                           gtl::priv::raw_hash_set,
                                           Mtx_,
-                                          AuxCont,
-                                          gtl::priv::FlatHashSetPolicy<T>,
+                                          gtl::priv::empty,
+                                          gtl::priv::FlatHashMapPolicy<K, V>,
                                           Hash,
                                           Eq,
                                           Alloc> {
-    using Base = typename parallel_flat_hash_set::parallel_hash_set;
+    using Base = typename parallel_flat_hash_map_seqlock::parallel_hash_map;
 
 public:
-    parallel_flat_hash_set() {}
+    parallel_flat_hash_map_seqlock() {}
 #ifdef __INTEL_COMPILER
-    using Base::parallel_hash_set;
+    using Base::parallel_hash_map;
 #else
     using Base::Base;
 #endif
+    using Base::at;
     using Base::begin;
-    using Base::bucket_count;
     using Base::capacity;
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
@@ -5400,13 +8515,11 @@ public:
     using Base::erase;
     using Base::extract;
     using Base::find;
-    using Base::get_allocator;
+    using Base::find_many;
     using Base::hash;
-    using Base::hash_function;
     using Base::insert;
-    using Base::key_eq;
-    using Base::load_factor;
-    using Base::max_load_factor;
+    using Base::insert_unique_unchecked;
+    using Base::insert_or_assign;
     using Base::max_size;
     using Base::merge;
     using Base::rehash;
@@ -5415,25 +8528,37 @@ public:
     using Base::subcnt;
     using Base::subidx;
     using Base::swap;
+    using Base::try_emplace;
+    using Base::try_emplace_with_hash;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
 };
 
 // -----------------------------------------------------------------------------
-// gtl::parallel_flat_hash_map - default values in phmap_fwd_decl.hpp
+// gtl::parallel_string_flat_hash_map - default values in phmap_fwd_decl.hpp
 // -----------------------------------------------------------------------------
-template<class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
-class parallel_flat_hash_map
+// A `gtl::parallel_flat_hash_map` with the key storage of
+// `gtl::string_flat_hash_map`. Each submap has its own arena for long keys.
+// -----------------------------------------------------------------------------
+template<class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class AuxCont>
+class parallel_string_flat_hash_map
     : public gtl::priv::parallel_hash_map<N,
                                           gtl::priv::raw_hash_set,
                                           Mtx_,
                                           AuxCont,
-                                          gtl::priv::FlatHashMapPolicy<K, V>,
+                                          gtl::priv::StringFlatHashMapPolicy<V>,
                                           Hash,
                                           Eq,
                                           Alloc> {
-    using Base = typename parallel_flat_hash_map::parallel_hash_map;
+    using Base = typename parallel_string_flat_hash_map::parallel_hash_map;
 
 public:
-    parallel_flat_hash_map() {}
+    parallel_string_flat_hash_map() {}
 #ifdef __INTEL_COMPILER
     using Base::parallel_hash_map;
 #else
@@ -5445,7 +8570,9 @@ public:
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
@@ -5457,8 +8584,10 @@ public:
     using Base::erase;
     using Base::extract;
     using Base::find;
+    using Base::find_many;
     using Base::hash;
     using Base::insert;
+    using Base::insert_unique_unchecked;
     using Base::insert_or_assign;
     using Base::max_size;
     using Base::merge;
@@ -5507,7 +8636,9 @@ public:
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
@@ -5519,10 +8650,12 @@ public:
     using Base::erase;
     using Base::extract;
     using Base::find;
+    using Base::find_many;
     using Base::get_allocator;
     using Base::hash;
     using Base::hash_function;
     using Base::insert;
+    using Base::insert_unique_unchecked;
     using Base::key_eq;
     using Base::load_factor;
     using Base::max_load_factor;
@@ -5566,7 +8699,9 @@ public:
     using Base::cbegin;
     using Base::cend;
     using Base::clear;
+    using Base::compact;
     using Base::contains;
+    using Base::contains_many;
     using Base::count;
     using Base::emplace;
     using Base::emplace_hint;
@@ -5578,8 +8713,10 @@ public:
     using Base::erase;
     using Base::extract;
     using Base::find;
+    using Base::find_many;
     using Base::hash;
     using Base::insert;
+    using Base::insert_unique_unchecked;
     using Base::insert_or_assign;
     using Base::max_size;
     using Base::merge;
@@ -5602,6 +8739,362 @@ public:
     void                  resize(typename Base::size_type hint) { this->rehash(hint); }
 };
 
+// -----------------------------------------------------------------------------
+// gtl::parallel_flat_hash_map_reshardable - default values in phmap_fwd_decl.hpp
+// -----------------------------------------------------------------------------
+// A concurrent hash map, like `gtl::parallel_flat_hash_map` with an internal
+// mutex, but whose number of submaps (shards) is chosen at construction time,
+// and can be increased with `reshard(n)` while other threads use the map.
+//
+// The shard of a key is selected by the top bits of its hash (the submaps
+// probe with the low bits), through a directory of 2^depth shard pointers.
+// Each shard covers the keys whose top `shard depth` bits match its prefix:
+// splitting a shard moves the keys whose next hash bit is set to a new shard,
+// while holding only that shard's lock. Threads which looked up the shard
+// before the split see it no longer covers their key, and look it up again.
+// Shards and directories are only freed when the map is destroyed.
+//
+// As elements may move to another shard at any time, there are no iterators:
+// elements are accessed through callbacks called under the shard's lock, as
+// with the `_l` functions of the parallel maps.
+//
+//   gtl::parallel_flat_hash_map_reshardable<int, int> m(std::thread::hardware_concurrency());
+//   m.try_emplace_l(1, [](auto& v) { ++v.second; }, 1);
+//   m.reshard(4 * m.subcnt());  // if the shards turn out to be contended
+// -----------------------------------------------------------------------------
+template<class K, class V, class Hash, class Eq, class Alloc, class Mtx_>
+class parallel_flat_hash_map_reshardable {
+public:
+    using EmbeddedMap = gtl::flat_hash_map<K, V, Hash, Eq, Alloc>;
+    using key_type    = K;
+    using mapped_type = V;
+    using value_type  = typename EmbeddedMap::value_type;
+    using size_type   = size_t;
+    using hasher      = Hash;
+    using key_equal   = Eq;
+    using constructor = typename EmbeddedMap::constructor;
+
+    template<class T>
+    using key_arg = typename KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>::template type<T, K>;
+
+    static constexpr size_t kMaxDepth = 16; // at most 65536 shards
+
+    explicit parallel_flat_hash_map_reshardable(size_t num_shards = 16,
+                                                const hasher&    hash  = hasher(),
+                                                const key_equal& eq    = key_equal(),
+                                                const Alloc&     alloc = Alloc()) {
+        root_ = new_shard(0, 0, EmbeddedMap(0, hash, eq, alloc));
+        auto dir = std::make_unique<Directory>(0);
+        dir->slots[0].store(root_, std::memory_order_relaxed);
+        dir_.store(dir.get(), std::memory_order_release);
+        dirs_.push_back(std::move(dir));
+        reshard(num_shards);
+    }
+
+    parallel_flat_hash_map_reshardable(const parallel_flat_hash_map_reshardable&)            = delete;
+    parallel_flat_hash_map_reshardable& operator=(const parallel_flat_hash_map_reshardable&) = delete;
+
+    // Splits the shards until there are at least `num_shards` of them (rounded
+    // up to a power of 2). Can be called while other threads use the map:
+    // only the shard being split is locked.
+    // -------------------------------------------------------------------------
+    void reshard(size_t num_shards) {
+        size_t depth = 0;
+        while (depth < kMaxDepth && (size_t(1) << depth) < num_shards)
+            ++depth;
+
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            // new shards are appended, and split in turn if needed
+            while (shards_[i]->depth < depth)
+                split(*shards_[i]);
+        }
+    }
+
+    size_t subcnt() const {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        return shards_.size();
+    }
+
+    // ------------------------------ lookups --------------------------------
+    template<class K2 = key_type, class F>
+    bool if_contains(const key_arg<K2>& key, F&& f) const {
+        return const_cast<parallel_flat_hash_map_reshardable*>(this)->template with_shard<SharedLock>(
+            hash(key), [&](EmbeddedMap& set, size_t hashval) {
+                auto it = set.find(key, hashval);
+                if (it == set.end())
+                    return false;
+                std::forward<F>(f)(std::as_const(*it));
+                return true;
+            });
+    }
+
+    template<class K2 = key_type>
+    bool contains(const key_arg<K2>& key) const {
+        return if_contains(key, [](const value_type&) {});
+    }
+
+    template<class K2 = key_type>
+    size_type count(const key_arg<K2>& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    template<class K2 = key_type, class F>
+    bool modify_if(const key_arg<K2>& key, F&& f) {
+        return with_shard<UniqueLock>(hash(key), [&](EmbeddedMap& set, size_t hashval) {
+            auto it = set.find(key, hashval);
+            if (it == set.end())
+                return false;
+            std::forward<F>(f)(*it);
+            return true;
+        });
+    }
+
+    // ----------------------------- insertions ------------------------------
+    // return true if the element was inserted
+    template<class K2 = key_type, class... Args>
+    bool try_emplace(K2&& key, Args&&... args) {
+        return try_emplace_l(std::forward<K2>(key), [](value_type&) {}, std::forward<Args>(args)...);
+    }
+
+    template<class K2 = key_type, class F, class... Args>
+    bool try_emplace_l(K2&& key, F&& f, Args&&... args) {
+        return with_shard<UniqueLock>(hash(key), [&](EmbeddedMap& set, size_t hashval) {
+            auto it = set.find(key, hashval);
+            if (it != set.end()) {
+                std::forward<F>(f)(*it);
+                return false;
+            }
+            set.emplace_with_hash(hashval,
+                                  std::piecewise_construct,
+                                  std::forward_as_tuple(std::forward<K2>(key)),
+                                  std::forward_as_tuple(std::forward<Args>(args)...));
+            return true;
+        });
+    }
+
+    template<class K2 = key_type, class FExists, class FEmplace>
+    bool lazy_emplace_l(const key_arg<K2>& key, FExists&& fExists, FEmplace&& fEmplace) {
+        return with_shard<UniqueLock>(hash(key), [&](EmbeddedMap& set, size_t hashval) {
+            auto it = set.find(key, hashval);
+            if (it != set.end()) {
+                std::forward<FExists>(fExists)(*it);
+                return false;
+            }
+            set.lazy_emplace_with_hash(key, hashval, std::forward<FEmplace>(fEmplace));
+            return true;
+        });
+    }
+
+    bool insert(const value_type& v) { return try_emplace(v.first, v.second); }
+
+    template<class K2 = key_type, class... Args>
+    bool emplace(K2&& key, Args&&... args) {
+        return try_emplace(std::forward<K2>(key), std::forward<Args>(args)...);
+    }
+
+    template<class K2 = key_type, class V2>
+    bool insert_or_assign(K2&& key, V2&& v) {
+        return with_shard<UniqueLock>(hash(key), [&](EmbeddedMap& set, size_t hashval) {
+            auto it = set.find(key, hashval);
+            if (it != set.end()) {
+                it->second = std::forward<V2>(v);
+                return false;
+            }
+            set.emplace_with_hash(hashval, std::forward<K2>(key), std::forward<V2>(v));
+            return true;
+        });
+    }
+
+    // ------------------------------ erasure --------------------------------
+    template<class K2 = key_type>
+    size_type erase(const key_arg<K2>& key) {
+        return erase_if(key, [](const value_type&) { return true; }) ? 1 : 0;
+    }
+
+    // erases the element if `f(value)` returns true
+    template<class K2 = key_type, class F>
+    bool erase_if(const key_arg<K2>& key, F&& f) {
+        return with_shard<UniqueLock>(hash(key), [&](EmbeddedMap& set, size_t hashval) {
+            auto it = set.find(key, hashval);
+            if (it == set.end() || !std::forward<F>(f)(std::as_const(*it)))
+                return false;
+            set.erase(it);
+            return true;
+        });
+    }
+
+    // --------------------------- whole map access --------------------------
+    // These lock the shards one at a time, and prevent resharding meanwhile.
+    // The callbacks of for_each/for_each_m are called with the locks held, so
+    // they must not call any other member function of the map (deadlock).
+    template<class F>
+    void for_each(F&& f) const {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        for (auto& s : shards_) {
+            SharedLock m(*s);
+            for (const auto& v : s->set)
+                f(v);
+        }
+    }
+
+    template<class F>
+    void for_each_m(F&& f) {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        for (auto& s : shards_) {
+            UniqueLock m(*s);
+            for (auto& v : s->set)
+                f(v);
+        }
+    }
+
+    size_type size() const {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        size_type sz = 0;
+        for (auto& s : shards_) {
+            SharedLock m(*s);
+            sz += s->set.size();
+        }
+        return sz;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        for (auto& s : shards_) {
+            UniqueLock m(*s);
+            s->set.clear();
+        }
+    }
+
+    // reserves room for `n` elements, assuming they are evenly spread
+    void reserve(size_type n) {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        for (auto& s : shards_) {
+            UniqueLock m(*s);
+            s->set.reserve(n >> s->depth);
+        }
+    }
+
+    float max_load_factor() const {
+        SharedLock m(*root_);
+        return root_->set.max_load_factor();
+    }
+
+    // sets the maximum load factor of every shard, and of the shards created
+    // by later splits
+    void max_load_factor(float f) {
+        std::lock_guard<std::mutex> l(reshard_mutex_);
+        for (auto& s : shards_) {
+            UniqueLock m(*s);
+            s->set.max_load_factor(f);
+        }
+    }
+
+    template<class K2>
+    size_t hash(const K2& key) const {
+        return root_->set.hash(key);
+    }
+
+    hasher    hash_function() const { return root_->set.hash_function(); }
+    key_equal key_eq() const { return root_->set.key_eq(); }
+    Alloc     get_allocator() const { return root_->set.get_allocator(); }
+
+private:
+    using Lockable   = LockableImpl<Mtx_>;
+    using UniqueLock = typename Lockable::UniqueLock;
+    using SharedLock = typename Lockable::SharedLock;
+
+    static constexpr size_t kHashBits = sizeof(size_t) * 8;
+
+    // the top `depth` bits of `hashval`
+    static size_t prefix(size_t hashval, size_t depth) { return depth ? hashval >> (kHashBits - depth) : 0; }
+
+    struct alignas(gtl::hardware_destructive_interference_size) Shard : public Lockable {
+        Shard(size_t d, size_t p, EmbeddedMap&& s)
+            : depth(d)
+            , prefix(p)
+            , set(std::move(s)) {}
+
+        // depth and prefix only change while the shard is locked for writing
+        bool covers(size_t hashval) const { return parallel_flat_hash_map_reshardable::prefix(hashval, depth) == prefix; }
+
+        size_t      depth;
+        size_t      prefix;
+        EmbeddedMap set;
+    };
+
+    struct Directory {
+        explicit Directory(size_t d)
+            : depth(d)
+            , slots(new std::atomic<Shard*>[size_t(1) << d]) {}
+
+        size_t                                depth;
+        std::unique_ptr<std::atomic<Shard*>[]> slots;
+    };
+
+    template<class L, class F>
+    auto with_shard(size_t hashval, F&& f) {
+        for (;;) {
+            Directory* dir   = dir_.load(std::memory_order_acquire);
+            Shard*     shard = dir->slots[prefix(hashval, dir->depth)].load(std::memory_order_acquire);
+            L          m(*shard);
+            if (shard->covers(hashval))
+                return f(shard->set, hashval);
+            // the shard was split after we found it, look it up again
+        }
+    }
+
+    Shard* new_shard(size_t depth, size_t pfx, EmbeddedMap&& set) {
+        shards_.push_back(std::make_unique<Shard>(depth, pfx, std::move(set)));
+        return shards_.back().get();
+    }
+
+    // called with reshard_mutex_ locked
+    void split(Shard& s) {
+        Directory* dir = dir_.load(std::memory_order_relaxed);
+        if (s.depth == dir->depth) {
+            // double the directory, each shard is referenced by two slots
+            auto bigger = std::make_unique<Directory>(dir->depth + 1);
+            for (size_t i = 0; i < (size_t(1) << bigger->depth); ++i)
+                bigger->slots[i].store(dir->slots[i >> 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            dir = bigger.get();
+            dirs_.push_back(std::move(bigger));
+            dir_.store(dir, std::memory_order_release);
+        }
+
+        UniqueLock m(s);
+        const size_t depth = s.depth + 1;
+        Shard*       sibling =
+            new_shard(depth, (s.prefix << 1) | 1, EmbeddedMap(0, s.set.hash_function(), s.set.key_eq(), s.set.get_allocator()));
+        s.depth  = depth;
+        s.prefix = s.prefix << 1;
+
+        // move the elements whose next hash bit is set to the sibling
+        sibling->set.max_load_factor(s.set.max_load_factor());
+        sibling->set.reserve(s.set.size() / 2);
+        for (auto it = s.set.begin(), last = s.set.end(); it != last;) {
+            auto   cur     = it++;
+            size_t hashval = s.set.hash(cur->first);
+            if (!s.covers(hashval))
+                sibling->set.insert(s.set.extract(cur), hashval);
+        }
+        s.set.rehash(0); // squash the tombstones, keeping room for growth
+
+        // point the directory slots of the upper half to the sibling
+        const size_t shift = dir->depth - depth;
+        for (size_t i = sibling->prefix << shift, e = (sibling->prefix + 1) << shift; i < e; ++i)
+            dir->slots[i].store(sibling, std::memory_order_release);
+    }
+
+    Shard*                                  root_; // shards_[0], never moves
+    std::vector<std::unique_ptr<Shard>>     shards_;
+    std::vector<std::unique_ptr<Directory>> dirs_;
+    std::atomic<Directory*>                 dir_;
+    mutable std::mutex                      reshard_mutex_;
+};
+
 } // namespace gtl
 
 namespace gtl {
@@ -5663,6 +9156,30 @@ std::size_t erase_if(gtl::parallel_node_hash_map<K, V, Hash, Eq, Alloc, N, Mtx_>
     return gtl::priv::erase_if(c, std::move(pred));
 }
 
+// ======== parallel erase_if for the parallel containers ====================
+// Erases the elements matching `pred`, processing the submaps concurrently.
+// `exec` is a number of threads, an executor hook or an execution policy.
+// ---------------------------------------------------------------------------
+template<class Executor, class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(Executor&& exec, gtl::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return c.parallel_erase_if(std::forward<Executor>(exec), std::move(pred));
+}
+
+template<class Executor, class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(Executor&& exec, gtl::parallel_node_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return c.parallel_erase_if(std::forward<Executor>(exec), std::move(pred));
+}
+
+template<class Executor, class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(Executor&& exec, gtl::parallel_flat_hash_map<K, V, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return c.parallel_erase_if(std::forward<Executor>(exec), std::move(pred));
+}
+
+template<class Executor, class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(Executor&& exec, gtl::parallel_node_hash_map<K, V, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return c.parallel_erase_if(std::forward<Executor>(exec), std::move(pred));
+}
+
 } // gtl
 
 #ifdef _MSC_VER
@@ -58,6 +58,11 @@ bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_dump(OutputArchive& ar) const
     static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
                   "value_type should be trivially copyable");
 
+    if constexpr (kIncremental) {
+        // the copy holds all the elements in a single slot array
+        if (old_.ctrl)
+            return raw_hash_set(*this).phmap_dump(ar);
+    }
     ar.saveBinary(&s_version, sizeof(size_t));
     ar.saveBinary(&size_, sizeof(size_t));
     ar.saveBinary(&capacity_, sizeof(size_t));
@@ -74,7 +79,9 @@ template<typename InputArchive>
 bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_load(InputArchive& ar) {
     static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
                   "value_type should be trivially copyable");
+    const max_load_t max_load = max_load_;
     raw_hash_set<Policy, Hash, Eq, Alloc>().swap(*this); // clear any existing content
+    max_load_      = max_load;
     size_t version = 0;
     ar.loadBinary(&version, sizeof(size_t));
     if (version <= s_version_base) {
@@ -102,6 +109,79 @@ bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_load(InputArchive& ar) {
     ar.loadBinary(slots_, sizeof(slot_type) * capacity_);
     if (version == 0) {
         drop_deletes_without_resize(); // because we didn't load `&growth_left()`
+    } else {
+        // the stored growth_left is for the maximum load factor of the dumped
+        // table, which may differ from the one of this table
+        size_t deleted = 0;
+        for (size_t i = 0; i != capacity_; ++i) {
+            if (IsDeleted(ctrl_[i])) {
+                ++deleted;
+                set_ctrl(i, kDeleted); // may be a kDeletedOld from a compact() pass
+            }
+        }
+        const size_t growth = CapacityToGrowth(capacity_, max_load_);
+        growth_left()       = growth > size_ + deleted ? growth - size_ - deleted : 0;
+        if (size_ > growth)
+            rehash(0);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------
+// The header of a mappable dump. The control bytes and the slots follow at
+// offsets aligned on kMappedAlign bytes, so that a memory mapping of the file
+// can be used in place (see gtl::mapped_flat_hash_map).
+// ------------------------------------------------------------------------
+struct mapped_dump_header {
+    static constexpr uint64_t kMagic   = 0x3150414D4D4C5447ULL; // "GTLMMAP1"
+    static constexpr uint64_t kVersion = 1;
+
+    uint64_t magic;
+    uint64_t version;
+    uint64_t group_width; // Group::kWidth of the writer, on which the probing depends
+    uint64_t slot_size;
+    uint64_t tight; // 1 for the tables with tight capacities
+    uint64_t size;
+    uint64_t capacity;
+    uint64_t ctrl_offset;
+    uint64_t slots_offset;
+};
+
+inline constexpr size_t kMappedAlign = 64;
+
+template<class Policy, class Hash, class Eq, class Alloc>
+template<typename OutputArchive>
+bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_dump_mappable(OutputArchive& ar) const {
+    static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
+                  "value_type should be trivially copyable");
+    static_assert(alignof(slot_type) <= kMappedAlign, "slot_type is over-aligned");
+
+    if constexpr (kIncremental) {
+        // the copy holds all the elements in a single slot array
+        if (old_.ctrl)
+            return raw_hash_set(*this).phmap_dump_mappable(ar);
+    }
+    auto align = [](size_t n) { return (n + kMappedAlign - 1) & ~(kMappedAlign - 1); };
+
+    const size_t       ctrl_bytes = capacity_ ? capacity_ + Group::kWidth + 1 : 0;
+    mapped_dump_header h{};
+    h.magic        = mapped_dump_header::kMagic;
+    h.version      = mapped_dump_header::kVersion;
+    h.group_width  = Group::kWidth;
+    h.slot_size    = sizeof(slot_type);
+    h.tight        = kTight;
+    h.size         = size_;
+    h.capacity     = capacity_;
+    h.ctrl_offset  = align(sizeof(h));
+    h.slots_offset = align(h.ctrl_offset + ctrl_bytes);
+
+    static constexpr char padding[kMappedAlign] = {};
+    ar.saveBinary(&h, sizeof(h));
+    ar.saveBinary(padding, h.ctrl_offset - sizeof(h));
+    if (capacity_) {
+        ar.saveBinary(ctrl_, ctrl_bytes);
+        ar.saveBinary(padding, h.slots_offset - h.ctrl_offset - ctrl_bytes);
+        ar.saveBinary(slots_, sizeof(slot_type) * capacity_);
     }
     return true;
 }
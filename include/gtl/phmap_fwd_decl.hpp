@@ -50,6 +50,9 @@ using Pair = typename std::pair<T1, T2>;
 
 class NullMutex;
 
+template<class Mtx_>
+class SeqMutex;
+
 namespace priv {
 
 // The hash of an object of type T is computed by using gtl::Hash.
@@ -75,6 +78,16 @@ using Pair = typename gtl::Pair<T1, T2>;
 
 struct empty {};
 
+class string_key;
+struct string_key_hash;
+struct string_key_eq;
+
+template<class T>
+class string_arena_allocator;
+
+template<class T>
+class retaining_allocator;
+
 } // namespace priv
 
 // ------------- forward declarations for hash containers ----------------------------------
@@ -91,6 +104,33 @@ template<class K,
          class Alloc = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>> // alias for std::allocator
 class flat_hash_map;
 
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>> // alias for std::allocator
+class flat_hash_map_incremental;
+
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>> // alias for std::allocator
+class flat_hash_map_tight;
+
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>> // alias for std::allocator
+class flat_hash_map_cached_hash;
+
+template<class V,
+         class Hash  = gtl::priv::string_key_hash,
+         class Eq    = gtl::priv::string_key_eq,
+         class Alloc = gtl::priv::string_arena_allocator<gtl::priv::Pair<const gtl::priv::string_key, V>>>
+class string_flat_hash_map;
+
 template<class T,
          class Hash  = gtl::priv::hash_default_hash<T>,
          class Eq    = gtl::priv::hash_default_eq<T>,
@@ -123,6 +163,44 @@ template<class K,
          class AuxCont = gtl::priv::empty>
 class parallel_flat_hash_map;
 
+template<class K,
+         class V,
+         class Hash    = gtl::priv::hash_default_hash<K>,
+         class Eq      = gtl::priv::hash_default_eq<K>,
+         class Alloc   = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>, // alias for std::allocator
+         size_t N      = 4,                                                 // 2**N submaps
+         class Mutex   = gtl::NullMutex,                                    // use std::mutex to enable internal locks
+         class AuxCont = gtl::priv::empty>
+class parallel_flat_hash_map_incremental;
+
+template<class K,
+         class V,
+         class Hash    = gtl::priv::hash_default_hash<K>,
+         class Eq      = gtl::priv::hash_default_eq<K>,
+         class Alloc   = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>, // alias for std::allocator
+         size_t N      = 4,                                                 // 2**N submaps
+         class Mutex   = gtl::NullMutex,                                    // use std::mutex to enable internal locks
+         class AuxCont = gtl::priv::empty>
+class parallel_flat_hash_map_tight;
+
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::retaining_allocator<gtl::priv::Pair<const K, V>>,
+         size_t N    = 4,                          // 2**N submaps
+         class Mutex = gtl::SeqMutex<std::mutex>> // lookups don't lock, see gtl::SeqMutex
+class parallel_flat_hash_map_seqlock;
+
+template<class V,
+         class Hash    = gtl::priv::string_key_hash,
+         class Eq      = gtl::priv::string_key_eq,
+         class Alloc   = gtl::priv::string_arena_allocator<gtl::priv::Pair<const gtl::priv::string_key, V>>,
+         size_t N      = 4,              // 2**N submaps
+         class Mutex   = gtl::NullMutex, // use std::mutex to enable internal locks
+         class AuxCont = gtl::priv::empty>
+class parallel_string_flat_hash_map;
+
 template<class T,
          class Hash    = gtl::priv::hash_default_hash<T>,
          class Eq      = gtl::priv::hash_default_eq<T>,
@@ -142,6 +220,15 @@ template<class Key,
          class AuxCont = gtl::priv::empty>
 class parallel_node_hash_map;
 
+// the shard count is set at runtime
+template<class K,
+         class V,
+         class Hash  = gtl::priv::hash_default_hash<K>,
+         class Eq    = gtl::priv::hash_default_eq<K>,
+         class Alloc = gtl::priv::Allocator<gtl::priv::Pair<const K, V>>, // alias for std::allocator
+         class Mtx_  = std::mutex>
+class parallel_flat_hash_map_reshardable;
+
 // -----------------------------------------------------------------------------
 // phmap::parallel_*_hash_* using std::mutex by default
 // -----------------------------------------------------------------------------
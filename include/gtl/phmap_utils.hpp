@@ -31,6 +31,8 @@
 #include "bits.hpp"
 #include <cstdint>
 #include <cstring>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <typeindex> // <typeindex> is guaranteed to provide std::hash and is much cheaper to include than <functional>.
 
@@ -99,14 +101,108 @@ struct fold_if_needed {
 
 template<>
 struct fold_if_needed<4> {
-    inline size_t operator()(uint64_t a) const { return static_cast<size_t>(a ^ (a >> 32)); }
+    constexpr size_t operator()(uint64_t a) const { return static_cast<size_t>(a ^ (a >> 32)); }
 };
 
 template<>
 struct fold_if_needed<8> {
-    inline size_t operator()(uint64_t a) const { return static_cast<size_t>(a); }
+    constexpr size_t operator()(uint64_t a) const { return static_cast<size_t>(a); }
 };
 
+// ---------------------------------------------------------------
+//               gtl::hash_bytes
+// ---------------------------------------------------------------
+// Fast 64 bit hash of a contiguous range of bytes, in the style of
+// wyhash/rapidhash: the input is folded 16 bytes at a time with
+// 64x64->128 bit multiplies. Inputs longer than 48 bytes are consumed
+// by three independent lanes, so that the multiplies of consecutive
+// blocks overlap. Used by gtl::Hash for std::string and std::string_view.
+// ---------------------------------------------------------------
+namespace hash_internal {
+
+inline constexpr uint64_t kSecret[3] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL };
+
+// full 128 bit product of a and b, low half in a and high half in b
+inline void mum(uint64_t& a, uint64_t& b) {
+#if defined(GTL_HAS_UMUL128)
+    a = umul128(a, b, &b);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    mum(a, b);
+    return a ^ b;
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace hash_internal
+
+inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed = 0) noexcept {
+    using namespace hash_internal;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t       a, b;
+
+    seed ^= mix(seed ^ kSecret[0], kSecret[1]) ^ len;
+    if (len <= 16) {
+        if (len >= 4) {
+            // two (possibly overlapping) pairs of 4 byte reads cover the input
+            const uint8_t* plast = p + len - 4;
+            const size_t   delta = (len & 24) >> (len >> 3);
+            a                    = (read32(p) << 32) | read32(plast);
+            b                    = (read32(p + delta) << 32) | read32(plast - delta);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 56) | ((uint64_t)p[len >> 1] << 32) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read64(p) ^ kSecret[0], read64(p + 8) ^ seed);
+                see1 = mix(read64(p + 16) ^ kSecret[1], read64(p + 24) ^ see1);
+                see2 = mix(read64(p + 32) ^ kSecret[2], read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        if (i > 16) {
+            seed = mix(read64(p) ^ kSecret[2], read64(p + 8) ^ seed);
+            if (i > 32)
+                seed = mix(read64(p + 16) ^ kSecret[2], read64(p + 24) ^ seed);
+        }
+        // the last 16 bytes, which may overlap the ones already hashed
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= kSecret[1];
+    b ^= seed;
+    mum(a, b);
+    return mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+}
+
 // ---------------------------------------------------------------
 // see if class T has a hash_value() friend method
 // ---------------------------------------------------------------
@@ -156,61 +252,61 @@ struct gtl_unary_function {
 
 template<>
 struct Hash<bool> : public gtl_unary_function<bool, size_t> {
-    inline size_t operator()(bool val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(bool val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<char> : public gtl_unary_function<char, size_t> {
-    inline size_t operator()(char val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(char val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<signed char> : public gtl_unary_function<signed char, size_t> {
-    inline size_t operator()(signed char val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(signed char val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<unsigned char> : public gtl_unary_function<unsigned char, size_t> {
-    inline size_t operator()(unsigned char val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(unsigned char val) const noexcept { return static_cast<size_t>(val); }
 };
 
     #ifdef GTL_HAS_NATIVE_WCHAR_T
 template<>
 struct Hash<wchar_t> : public gtl_unary_function<wchar_t, size_t> {
-    inline size_t operator()(wchar_t val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(wchar_t val) const noexcept { return static_cast<size_t>(val); }
 };
     #endif
 
 template<>
 struct Hash<int16_t> : public gtl_unary_function<int16_t, size_t> {
-    inline size_t operator()(int16_t val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(int16_t val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<uint16_t> : public gtl_unary_function<uint16_t, size_t> {
-    inline size_t operator()(uint16_t val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(uint16_t val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<int32_t> : public gtl_unary_function<int32_t, size_t> {
-    inline size_t operator()(int32_t val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(int32_t val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<uint32_t> : public gtl_unary_function<uint32_t, size_t> {
-    inline size_t operator()(uint32_t val) const noexcept { return static_cast<size_t>(val); }
+    constexpr size_t operator()(uint32_t val) const noexcept { return static_cast<size_t>(val); }
 };
 
 template<>
 struct Hash<int64_t> : public gtl_unary_function<int64_t, size_t> {
-    inline size_t operator()(int64_t val) const noexcept {
+    constexpr size_t operator()(int64_t val) const noexcept {
         return fold_if_needed<sizeof(size_t)>()(static_cast<uint64_t>(val));
     }
 };
 
 template<>
 struct Hash<uint64_t> : public gtl_unary_function<uint64_t, size_t> {
-    inline size_t operator()(uint64_t val) const noexcept { return fold_if_needed<sizeof(size_t)>()(val); }
+    constexpr size_t operator()(uint64_t val) const noexcept { return fold_if_needed<sizeof(size_t)>()(val); }
 };
 
 template<>
@@ -314,6 +410,22 @@ using HashState = HashStateBase<size_t>;
 
 #if !defined(GTL_USE_ABSL_HASH)
 
+// define Hash for std::basic_string and std::basic_string_view
+// ------------------------------------------------------------
+template<class CharT, class Traits, class Alloc>
+struct Hash<std::basic_string<CharT, Traits, Alloc>> {
+    size_t operator()(std::basic_string<CharT, Traits, Alloc> const& s) const noexcept {
+        return fold_if_needed<sizeof(size_t)>()(gtl::hash_bytes(s.data(), s.size() * sizeof(CharT)));
+    }
+};
+
+template<class CharT, class Traits>
+struct Hash<std::basic_string_view<CharT, Traits>> {
+    size_t operator()(std::basic_string_view<CharT, Traits> s) const noexcept {
+        return fold_if_needed<sizeof(size_t)>()(gtl::hash_bytes(s.data(), s.size() * sizeof(CharT)));
+    }
+};
+
 // define Hash for std::pair
 // -------------------------
 template<class T1, class T2>
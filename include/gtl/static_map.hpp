@@ -0,0 +1,384 @@
+#ifndef gtl_static_map_hpp_
+#define gtl_static_map_hpp_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2026, Gregory Popovitch - greg7mdp@gmail.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+// ---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <gtl/gtl_base.hpp>
+#include <gtl/phmap_utils.hpp>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace gtl {
+
+// ------------------------------------------------------------------------------
+// constexpr hash of the keys of a static_map or static_set. The integral and
+// enum keys use gtl::Hash, the strings a constexpr hash of their bytes. The
+// result does not need to be well mixed, as the table mixes it again.
+//
+// Specialize it for other key types, with a constexpr operator().
+// ------------------------------------------------------------------------------
+template<class K, class = void>
+struct static_hash;
+
+template<class K>
+struct static_hash<K, std::enable_if_t<std::is_integral_v<K> || std::is_enum_v<K>>> {
+    constexpr size_t operator()(K key) const noexcept {
+        uint64_t v;
+        if constexpr (std::is_enum_v<K>)
+            v = static_cast<uint64_t>(static_cast<std::underlying_type_t<K>>(key));
+        else
+            v = static_cast<uint64_t>(key);
+#if defined(GTL_USE_ABSL_HASH)
+        return static_cast<size_t>(v ^ (v >> 32)); // absl::Hash is not constexpr
+#else
+        return gtl::Hash<uint64_t>()(v);
+#endif
+    }
+};
+
+template<class CharT, class Traits>
+struct static_hash<std::basic_string_view<CharT, Traits>> {
+    using is_transparent = void;
+
+    // the characters are read 8 bytes at a time, which the compiler turns into
+    // a single load at run time
+    constexpr size_t operator()(std::basic_string_view<CharT, Traits> s) const noexcept {
+        constexpr uint64_t kMul  = 0x9E3779B97F4A7C15ULL;
+        constexpr size_t   kBits = 8 * sizeof(CharT);
+        constexpr size_t   kStep = sizeof(uint64_t) / sizeof(CharT);
+
+        uint64_t h = s.size() * kMul;
+        size_t   i = 0;
+        for (; i + kStep <= s.size(); i += kStep) {
+            uint64_t w = 0;
+            for (size_t j = 0; j < kStep; ++j)
+                w |= static_cast<uint64_t>(static_cast<std::make_unsigned_t<CharT>>(s[i + j])) << (kBits * j);
+            h = std::rotl((h ^ w) * kMul, 29);
+        }
+        if (i < s.size()) {
+            uint64_t w = 0;
+            for (size_t j = 0; i + j < s.size(); ++j)
+                w |= static_cast<uint64_t>(static_cast<std::make_unsigned_t<CharT>>(s[i + j])) << (kBits * j);
+            h = std::rotl((h ^ w) * kMul, 29);
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+template<class CharT, class Traits, class Alloc>
+struct static_hash<std::basic_string<CharT, Traits, Alloc>> : static_hash<std::basic_string_view<CharT, Traits>> {};
+
+namespace priv {
+
+// murmur3's 64 bit finalizer
+constexpr uint64_t static_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// ------------------------------------------------------------------------------
+// The table of a static_map or static_set: a minimal-ish perfect hash of the
+// `N` keys, found when the table is constructed, at compile time for a
+// constexpr table.
+//
+// The keys are spread over about N/2 buckets, and each bucket stores the one
+// byte pilot which sends all its keys to free slots (PTHash style). A lookup
+// hashes the key, reads its bucket's pilot, and compares the key with the one
+// slot it maps to: the empty slots hold a copy of a key stored elsewhere, so
+// that they never compare equal to a key which maps to them.
+// ------------------------------------------------------------------------------
+template<class K, class Value, size_t N, class Hash, class Eq>
+class static_table {
+    static_assert(N > 0, "a static table needs at least one key");
+
+protected:
+    static constexpr size_t kSlots   = std::bit_ceil(N + N / 4);
+    static constexpr size_t kBuckets = (N + 1) / 2;
+    static constexpr size_t kPilots  = 256;
+
+    static constexpr const K& key_of(const Value& v) {
+        if constexpr (std::is_same_v<K, Value>)
+            return v;
+        else
+            return v.first;
+    }
+
+public:
+    using key_type        = K;
+    using value_type      = Value;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Value;
+        using reference         = const value_type&;
+        using pointer           = const value_type*;
+        using difference_type   = ptrdiff_t;
+
+        constexpr iterator() = default;
+
+        constexpr reference operator*() const { return t_->slots_[i_]; }
+        constexpr pointer   operator->() const { return &t_->slots_[i_]; }
+
+        constexpr iterator& operator++() {
+            ++i_;
+            skip_empty_slots();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& a, const iterator& b) { return a.i_ == b.i_; }
+        friend constexpr bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        friend class static_table;
+
+        constexpr iterator(const static_table* t, size_t i)
+            : t_(t)
+            , i_(i) {}
+
+        constexpr void skip_empty_slots() {
+            while (i_ < kSlots && !t_->full_[i_])
+                ++i_;
+        }
+
+        const static_table* t_ = nullptr;
+        size_t              i_ = 0;
+    };
+
+    using const_iterator = iterator;
+
+    constexpr explicit static_table(const std::array<Value, N>& values, const hasher& hash = hasher(),
+                                    const key_equal& eq = key_equal())
+        : hash_(hash)
+        , eq_(eq) {
+        build(values);
+    }
+
+    // ------------------------------ iterators ------------------------------
+    constexpr iterator begin() const {
+        iterator it(this, 0);
+        it.skip_empty_slots();
+        return it;
+    }
+
+    constexpr iterator end() const { return iterator(this, kSlots); }
+    constexpr iterator cbegin() const { return begin(); }
+    constexpr iterator cend() const { return end(); }
+
+    // ------------------------------ capacity -------------------------------
+    constexpr bool      empty() const noexcept { return false; }
+    constexpr size_type size() const noexcept { return N; }
+    constexpr size_type max_size() const noexcept { return N; }
+    constexpr size_t    bucket_count() const noexcept { return kSlots; }
+
+    // ------------------------------- lookups -------------------------------
+    template<class K2 = key_type>
+    constexpr iterator find(const K2& key) const {
+        size_t i = slot_of(hash(key));
+        return eq_(key_of(slots_[i]), key) ? iterator(this, i) : end();
+    }
+
+    template<class K2 = key_type>
+    constexpr bool contains(const K2& key) const {
+        return eq_(key_of(slots_[slot_of(hash(key))]), key);
+    }
+
+    template<class K2 = key_type>
+    constexpr size_type count(const K2& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // -------------------------------- misc ---------------------------------
+    template<class K2>
+    constexpr uint64_t hash(const K2& key) const {
+        return static_mix(static_cast<uint64_t>(hash_(key)));
+    }
+
+    constexpr hasher    hash_function() const { return hash_; }
+    constexpr key_equal key_eq() const { return eq_; }
+
+protected:
+    static constexpr size_t bucket_of(uint64_t hashval) { return static_cast<size_t>(((hashval >> 32) * kBuckets) >> 32); }
+
+    static constexpr size_t slot_of(uint64_t hashval, uint8_t pilot) {
+        return static_cast<size_t>(static_mix(hashval ^ (pilot * 0x9E3779B97F4A7C15ULL))) & (kSlots - 1);
+    }
+
+    constexpr size_t slot_of(uint64_t hashval) const { return slot_of(hashval, pilots_[bucket_of(hashval)]); }
+
+    constexpr void build(const std::array<Value, N>& values) {
+        std::array<uint64_t, N> hashes{};
+        for (size_t i = 0; i < N; ++i)
+            hashes[i] = hash(key_of(values[i]));
+
+        // the keys of each bucket (a counting sort)
+        std::array<size_t, kBuckets + 1> starts{};
+        std::array<size_t, N>            keys{};
+        for (size_t i = 0; i < N; ++i)
+            ++starts[bucket_of(hashes[i]) + 1];
+        for (size_t b = 0; b < kBuckets; ++b)
+            starts[b + 1] += starts[b];
+        {
+            std::array<size_t, kBuckets> pos{};
+            for (size_t b = 0; b < kBuckets; ++b)
+                pos[b] = starts[b];
+            for (size_t i = 0; i < N; ++i)
+                keys[pos[bucket_of(hashes[i])]++] = i;
+        }
+
+        // the largest buckets are placed first, while most slots are free
+        std::array<size_t, kBuckets> buckets{};
+        for (size_t b = 0; b < kBuckets; ++b)
+            buckets[b] = b;
+        std::sort(buckets.begin(), buckets.end(), [&](size_t a, size_t b) {
+            size_t size_a = starts[a + 1] - starts[a], size_b = starts[b + 1] - starts[b];
+            return size_a != size_b ? size_a > size_b : a < b;
+        });
+
+        std::array<size_t, N> slot{};
+        for (size_t b : buckets) {
+            const size_t lo = starts[b], hi = starts[b + 1];
+            bool         placed = (lo == hi);
+            for (size_t p = 0; p < kPilots && !placed; ++p) {
+                placed = true;
+                for (size_t k = lo; k < hi && placed; ++k) {
+                    size_t i = keys[k];
+                    slot[i]  = slot_of(hashes[i], static_cast<uint8_t>(p));
+                    placed   = !full_[slot[i]];
+                    for (size_t k2 = lo; k2 < k && placed; ++k2) {
+                        size_t i2 = keys[k2];
+                        if (slot[i2] == slot[i]) {
+                            // keys with the same hash map to the same slot
+                            // with every pilot
+                            if (hashes[i2] == hashes[i])
+                                ThrowStdInvalidArgument(eq_(key_of(values[i2]), key_of(values[i]))
+                                                            ? "static table: duplicate key"
+                                                            : "static table: keys with the same hash");
+                            placed = false;
+                        }
+                    }
+                }
+                if (placed) {
+                    pilots_[b] = static_cast<uint8_t>(p);
+                    for (size_t k = lo; k < hi; ++k)
+                        full_[slot[keys[k]]] = true;
+                }
+            }
+            if (!placed)
+                ThrowStdLengthError("static table: no perfect hash found");
+        }
+
+        // an empty slot holds the first key, which is stored in another slot
+        for (size_t i = 0; i < N; ++i)
+            slots_[slot[i]] = values[i];
+        for (size_t s = 0; s < kSlots; ++s)
+            if (!full_[s])
+                slots_[s] = values[0];
+    }
+
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS hasher    hash_;
+    GTL_ATTRIBUTE_NO_UNIQUE_ADDRESS key_equal eq_;
+    std::array<Value, kSlots>                 slots_{};
+    std::array<uint8_t, kBuckets>             pilots_{};
+    std::array<bool, kSlots>                  full_{};
+};
+
+} // namespace priv
+
+// ------------------------------------------------------------------------------
+// A constant map over a fixed list of keys, such as enum names, protocol
+// opcodes or configuration keys, built at compile time when it is constexpr:
+// there is no startup cost, and the table can be placed in read-only data.
+//
+// A lookup is one hash, the load of a one byte pilot, and a single key
+// comparison. The keys must be literal types hashed by a constexpr hasher:
+// `gtl::static_hash` supports the integral and enum types, and
+// `std::string_view`. A duplicate key fails the compilation of a constexpr
+// map, and throws `std::invalid_argument` otherwise.
+//
+//   enum class op { add, sub, mul };
+//   constexpr auto ops = gtl::make_static_map<std::string_view, op>({
+//       { "add", op::add }, { "sub", op::sub }, { "mul", op::mul } });
+//   static_assert(ops.at("sub") == op::sub);
+// ------------------------------------------------------------------------------
+template<class K, class V, size_t N, class Hash = gtl::static_hash<K>, class Eq = std::equal_to<>>
+class static_map : public priv::static_table<K, std::pair<K, V>, N, Hash, Eq> {
+    using Base = priv::static_table<K, std::pair<K, V>, N, Hash, Eq>;
+
+public:
+    using mapped_type = V;
+    using Base::Base;
+
+    template<class K2 = K>
+    constexpr const V& at(const K2& key) const {
+        auto it = this->find(key);
+        if (it == this->end())
+            ThrowStdOutOfRange("static_map at(): lookup non-existent key");
+        return it->second;
+    }
+
+    template<class K2 = K>
+    constexpr const V& operator[](const K2& key) const {
+        return at(key);
+    }
+};
+
+// ------------------------------------------------------------------------------
+// The set version of `static_map`.
+//
+//   constexpr auto keywords = gtl::make_static_set<std::string_view>({ "if", "else", "while" });
+//   static_assert(keywords.contains("else"));
+// ------------------------------------------------------------------------------
+template<class K, size_t N, class Hash = gtl::static_hash<K>, class Eq = std::equal_to<>>
+class static_set : public priv::static_table<K, K, N, Hash, Eq> {
+    using Base = priv::static_table<K, K, N, Hash, Eq>;
+
+public:
+    using Base::Base;
+};
+
+template<class K, class V, class Hash = gtl::static_hash<K>, class Eq = std::equal_to<>, size_t N>
+constexpr auto make_static_map(const std::pair<K, V> (&values)[N], const Hash& hash = Hash(), const Eq& eq = Eq()) {
+    return static_map<K, V, N, Hash, Eq>(std::to_array(values), hash, eq);
+}
+
+template<class K, class Hash = gtl::static_hash<K>, class Eq = std::equal_to<>, size_t N>
+constexpr auto make_static_set(const K (&keys)[N], const Hash& hash = Hash(), const Eq& eq = Eq()) {
+    return static_set<K, N, Hash, Eq>(std::to_array(keys), hash, eq);
+}
+
+} // namespace gtl
+
+#endif // gtl_static_map_hpp_
@@ -0,0 +1,108 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/combining_map.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(CombiningMap, Counters) {
+    using Map = gtl::parallel_flat_hash_map_m<int, size_t>;
+    static constexpr int THREADS  = 4;
+    static constexpr int NUM_KEYS = 5000;
+
+    Map                      counts;
+    gtl::combining_map       combiner(counts, 256);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&combiner]() {
+            auto buf = combiner.local();
+            for (int round = 0; round < 3; ++round) {
+                for (int i = 0; i < NUM_KEYS; ++i) {
+                    buf.update(i, 1);
+                    if (i % 10 == 0)
+                        buf.update(-1, 2); // a hot key
+                }
+                EXPECT_LT(buf.size(), 256u);
+            }
+            // the destructor flushes the rest
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(counts.size(), (size_t)NUM_KEYS + 1);
+    for (int i = 0; i < NUM_KEYS; ++i)
+        ASSERT_EQ(counts[i], 3u * THREADS);
+    EXPECT_EQ(counts[-1], 2u * 3 * THREADS * (NUM_KEYS / 10));
+}
+
+TEST(CombiningMap, FlushAndMerge) {
+    using Map = gtl::parallel_flat_hash_map_m<std::string, std::vector<int>>;
+    auto append = [](std::vector<int>& dst, std::vector<int>&& src) { dst.insert(dst.end(), src.begin(), src.end()); };
+
+    Map                m;
+    gtl::combining_map combiner(m, 100, append);
+    EXPECT_EQ(combiner.capacity(), 100u);
+    {
+        auto buf = combiner.local();
+        buf.update("a", std::vector<int>{ 1 });
+        buf.update(std::string("a"), std::vector<int>{ 2, 3 });
+        buf.update("b", std::vector<int>{ 4 });
+        EXPECT_EQ(buf.size(), 2u);
+        EXPECT_TRUE(m.empty()); // nothing visible before the flush
+
+        buf.flush();
+        EXPECT_EQ(buf.size(), 0u);
+        EXPECT_EQ(m["a"], (std::vector<int>{ 1, 2, 3 }));
+        EXPECT_EQ(m["b"], (std::vector<int>{ 4 }));
+
+        buf.update("a", std::vector<int>{ 5 });
+    }
+    EXPECT_EQ(m["a"], (std::vector<int>{ 1, 2, 3, 5 }));
+    EXPECT_EQ(&combiner.map(), &m);
+}
+
+TEST(CombiningMap, ThrowingMerge) {
+    using Map = gtl::parallel_flat_hash_map_m<int, int>;
+    bool fail = true;
+    auto add  = [&fail](int& dst, int src) {
+        if (fail && src == 100)
+            throw std::runtime_error("merge");
+        dst += src;
+    };
+
+    Map m;
+    for (int i = 0; i < 50; ++i)
+        m[i] = 0;
+    gtl::combining_map combiner(m, 100, add);
+    {
+        auto buf = combiner.local();
+        for (int i = 0; i < 50; ++i)
+            buf.update(i, i == 7 ? 100 : 1);
+        EXPECT_THROW(buf.flush(), std::runtime_error);
+        EXPECT_GT(buf.size(), 0u); // what was not merged is kept
+        EXPECT_LE(buf.size(), 50u);
+
+        // the values merged before the exception are not merged again
+        fail = false;
+        buf.flush();
+        EXPECT_EQ(buf.size(), 0u);
+        for (int i = 0; i < 50; ++i)
+            ASSERT_EQ(m[i], i == 7 ? 100 : 1);
+
+        // the destructor's flush doesn't throw
+        fail = true;
+        buf.update(7, 100);
+    }
+    EXPECT_EQ(m[7], 100);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/concurrent_flat_hash_set.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(ConcurrentFlatHashSet, Basic) {
+    gtl::concurrent_flat_hash_set<uint64_t> s(1000);
+    EXPECT_GE(s.capacity() * 7, 1000u * 8);
+    EXPECT_TRUE(s.empty());
+
+    for (uint64_t i = 0; i < 1000; ++i)
+        EXPECT_TRUE(s.insert(i * 3));
+    for (uint64_t i = 0; i < 1000; ++i)
+        EXPECT_FALSE(s.insert(i * 3));
+    EXPECT_EQ(s.size(), 1000u);
+
+    for (uint64_t i = 0; i < 3000; ++i)
+        ASSERT_EQ(s.contains(i), i % 3 == 0);
+    EXPECT_EQ(s.count(3), 1u);
+    EXPECT_EQ(s.count(4), 0u);
+
+    std::unordered_set<uint64_t> seen;
+    s.for_each([&](uint64_t k) { EXPECT_TRUE(seen.insert(k).second); });
+    EXPECT_EQ(seen.size(), 1000u);
+
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_FALSE(s.contains(3));
+}
+
+TEST(ConcurrentFlatHashSet, Full) {
+    gtl::concurrent_flat_hash_set<int> s(10);
+    size_t                             cap = s.capacity();
+    for (size_t i = 0; i < cap; ++i)
+        EXPECT_TRUE(s.insert((int)i));
+    EXPECT_EQ(s.size(), cap);
+    EXPECT_FALSE(s.insert(0));
+    EXPECT_THROW(s.insert(-1), std::length_error);
+    EXPECT_FALSE(s.contains(-1));
+}
+
+TEST(ConcurrentFlatHashSet, ConcurrentDedup) {
+    static constexpr int      THREADS = 4;
+    static constexpr uint64_t NUM     = 200000;
+
+    // every thread inserts every key, only one insertion of each succeeds
+    gtl::concurrent_flat_hash_set<uint64_t> s(NUM);
+    std::atomic<uint64_t>                   inserted{ 0 };
+    std::vector<std::thread>                threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            uint64_t cnt = 0;
+            for (uint64_t i = 0; i < NUM; ++i) {
+                uint64_t k = (i * 7 + t * 1013) % NUM;
+                cnt += s.insert(k);
+                ASSERT_TRUE(s.contains(k));
+            }
+            inserted += cnt;
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(inserted, NUM);
+    EXPECT_EQ(s.size(), NUM);
+    for (uint64_t i = 0; i < NUM; ++i)
+        ASSERT_TRUE(s.contains(i));
+}
+
+TEST(ConcurrentFlatHashSet, ConcurrentSameOrder) {
+    static constexpr int      THREADS = 8;
+    static constexpr uint64_t NUM     = 20000;
+
+    // every thread inserts the same keys in the same order, so that most
+    // insertions race for the same key at the same time
+    for (int round = 0; round < 10; ++round) {
+        gtl::concurrent_flat_hash_set<uint64_t> s(NUM);
+        std::atomic<uint64_t>                   inserted{ 0 };
+        std::vector<std::thread>                threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&]() {
+                uint64_t cnt = 0;
+                for (uint64_t i = 0; i < NUM; ++i) {
+                    cnt += s.insert(i);
+                    ASSERT_TRUE(s.contains(i));
+                }
+                inserted += cnt;
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+
+        ASSERT_EQ(inserted, NUM);
+        ASSERT_EQ(s.size(), NUM);
+    }
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/dense_hash_map.hpp"
+#include "gtl/phmap_dump.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(DenseHashMap, Basic) {
+    gtl::dense_hash_map<std::string, int> m;
+    EXPECT_TRUE(m.empty());
+
+    EXPECT_TRUE(m.try_emplace("a", 1).second);
+    EXPECT_FALSE(m.try_emplace("a", 2).second);
+    EXPECT_TRUE(m.insert({ "b", 2 }).second);
+    EXPECT_TRUE(m.emplace("c", 3).second);
+    EXPECT_FALSE(m.emplace("c", 4).second);
+    EXPECT_FALSE(m.insert_or_assign("c", 5).second);
+    m["d"] = 4;
+    EXPECT_EQ(m.size(), 4u);
+
+    // heterogeneous lookups
+    EXPECT_EQ(m.at(std::string_view("a")), 1);
+    EXPECT_EQ(m.find("c")->second, 5);
+    EXPECT_TRUE(m.contains("d"));
+    EXPECT_EQ(m.count("e"), 0u);
+    EXPECT_EQ(m.find("e"), m.end());
+
+    // insertion order
+    std::vector<std::string> keys;
+    for (auto& [k, v] : m.values())
+        keys.push_back(k);
+    EXPECT_EQ(keys, (std::vector<std::string>{ "a", "b", "c", "d" }));
+
+    // the last element takes the place of the erased one
+    EXPECT_EQ(m.erase("a"), 1u);
+    EXPECT_EQ(m.erase("a"), 0u);
+    EXPECT_EQ(m.begin()->first, "d");
+    EXPECT_EQ(m.at("d"), 4);
+    EXPECT_EQ(m.size(), 3u);
+
+    auto it = m.erase(m.find("c"));
+    EXPECT_EQ(it, m.end());
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_EQ(m.at("b"), 2);
+    EXPECT_EQ(m.at("d"), 4);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains("b"));
+}
+
+TEST(DenseHashMap, CompareToUnorderedMap) {
+    gtl::dense_hash_map<uint64_t, uint64_t> m;
+    std::unordered_map<uint64_t, uint64_t>  ref;
+    std::mt19937_64                         rng(42);
+
+    for (int i = 0; i < 200000; ++i) {
+        uint64_t k = rng() % 5000;
+        switch (rng() % 3) {
+            case 0:
+                EXPECT_EQ(m.try_emplace(k, i).second, ref.try_emplace(k, i).second);
+                break;
+            case 1:
+                EXPECT_EQ(m.erase(k), ref.erase(k));
+                break;
+            default:
+                EXPECT_EQ(m.contains(k), ref.count(k) == 1);
+                break;
+        }
+    }
+    EXPECT_EQ(m.size(), ref.size());
+    for (auto& [k, v] : ref)
+        ASSERT_EQ(m.at(k), v);
+
+    size_t erased = erase_if(m, [](const auto& v) { return v.first % 2; });
+    EXPECT_EQ(erased, std::erase_if(ref, [](const auto& v) { return v.first % 2; }));
+    EXPECT_EQ(m.size(), ref.size());
+    for (auto& [k, v] : m)
+        ASSERT_EQ(ref.at(k), v);
+}
+
+TEST(DenseHashMap, CopyMoveSwap) {
+    gtl::dense_hash_map<int, int> m;
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(i, i * 2);
+
+    auto copy = m;
+    EXPECT_EQ(copy, m);
+    copy.erase(5);
+    EXPECT_NE(copy, m);
+
+    auto moved = std::move(copy);
+    EXPECT_EQ(moved.size(), 999u);
+    EXPECT_FALSE(moved.contains(5));
+    EXPECT_EQ(moved.at(7), 14);
+
+    swap(moved, m);
+    EXPECT_EQ(m.size(), 999u);
+    EXPECT_EQ(moved.size(), 1000u);
+    m = moved;
+    EXPECT_EQ(m, moved);
+    EXPECT_EQ(m.at(5), 10);
+}
+
+TEST(DenseHashMap, MovedFrom) {
+    gtl::dense_hash_map<std::string, int> m = {
+        { "a", 1 },
+        { "b", 2 }
+    };
+    auto m2 = std::move(m);
+    EXPECT_EQ(m2.size(), 2u);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0u);
+    EXPECT_EQ(m.begin(), m.end());
+    EXPECT_FALSE(m.contains("a"));
+    EXPECT_TRUE(m.find("b") == m.end());
+    m.clear();
+    m.try_emplace("c", 3);
+    EXPECT_EQ(m.at("c"), 3);
+
+    gtl::dense_hash_map<std::string, int> m3;
+    m3 = std::move(m2);
+    EXPECT_EQ(m3.size(), 2u);
+    EXPECT_TRUE(m2.empty());
+    EXPECT_FALSE(m2.contains("a"));
+    m2.try_emplace("d", 4);
+    EXPECT_EQ(m2.size(), 1u);
+    EXPECT_EQ(m3.at("b"), 2);
+}
+
+// a hasher whose copy may throw
+struct ThrowingCopyHash : std::hash<int> {
+    ThrowingCopyHash() = default;
+    ThrowingCopyHash(const ThrowingCopyHash&) noexcept(false) {}
+    ThrowingCopyHash& operator=(const ThrowingCopyHash&) noexcept(false) { return *this; }
+};
+
+TEST(DenseHashMap, NothrowMove) {
+    static_assert(std::is_nothrow_move_constructible_v<gtl::dense_hash_map<std::string, int>>);
+    static_assert(std::is_nothrow_move_assignable_v<gtl::dense_hash_map<std::string, int>>);
+    static_assert(!std::is_nothrow_move_constructible_v<gtl::dense_hash_map<int, int, ThrowingCopyHash>>);
+    static_assert(!std::is_nothrow_move_assignable_v<gtl::dense_hash_map<int, int, ThrowingCopyHash>>);
+    std::vector<gtl::dense_hash_map<int, int>> v(1);
+    v[0].try_emplace(1, 2);
+    const auto* values = v[0].values().data();
+    v.resize(100); // moves the maps, rather than copying them
+    EXPECT_EQ(v[0].values().data(), values);
+    EXPECT_EQ(v[0].at(1), 2);
+}
+
+struct ThrowOnCtor {
+    explicit ThrowOnCtor(int x)
+        : v(x) {
+        if (x < 0)
+            throw std::runtime_error("ThrowOnCtor");
+    }
+    int v;
+};
+
+TEST(DenseHashMap, ThrowingInsert) {
+    gtl::dense_hash_map<int, ThrowOnCtor> m;
+    for (int i = 0; i < 100; ++i) {
+        m.try_emplace(i, i);
+        EXPECT_THROW(m.try_emplace(1000 + i, -1), std::runtime_error);
+        EXPECT_THROW(m.emplace(std::piecewise_construct, std::forward_as_tuple(2000 + i), std::forward_as_tuple(-1)),
+                     std::runtime_error);
+        EXPECT_FALSE(m.contains(1000 + i));
+    }
+    EXPECT_EQ(m.size(), 100u);
+    for (auto& [k, v] : m)
+        ASSERT_EQ(m.find(k)->second.v, k);
+}
+
+TEST(DenseHashMap, DumpLoad) {
+    gtl::dense_hash_map<int, double> m;
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(i, i * 0.5);
+    m.erase(10);
+
+    {
+        gtl::BinaryOutputArchive ar_out("./dense_dump.data");
+        EXPECT_TRUE(m.phmap_dump(ar_out));
+    }
+    gtl::dense_hash_map<int, double> m2;
+    {
+        gtl::BinaryInputArchive ar_in("./dense_dump.data");
+        EXPECT_TRUE(m2.phmap_load(ar_in));
+    }
+    EXPECT_EQ(m2, m);
+    EXPECT_FALSE(m2.contains(10));
+    EXPECT_TRUE(std::equal(m.begin(), m.end(), m2.begin(), m2.end()));
+
+    // without padding, the elements are written with a single write
+    gtl::dense_hash_map<int, int> p;
+    for (int i = 0; i < 1000; ++i)
+        p.try_emplace(i, -i);
+    {
+        gtl::BinaryOutputArchive ar_out("./dense_dump.data");
+        EXPECT_TRUE(p.phmap_dump(ar_out));
+    }
+    gtl::dense_hash_map<int, int> p2;
+    {
+        gtl::BinaryInputArchive ar_in("./dense_dump.data");
+        EXPECT_TRUE(p2.phmap_load(ar_in));
+    }
+    EXPECT_EQ(p2, p);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
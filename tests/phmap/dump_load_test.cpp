@@ -45,6 +45,56 @@ TEST(DumpLoad, FlatHashMap_uint64_uint32) {
     EXPECT_TRUE(mp1 == mp2);
 }
 
+TEST(DumpLoad, FlatHashMapIncremental_uint64_uint32) {
+    // stop right after a resize: the table is still moving elements from the previous slot array
+    gtl::flat_hash_map_incremental<uint64_t, uint32_t> mp1;
+    for (uint32_t i = 0, cap = 0; cap < 1023 || mp1.capacity() == cap; ++i) {
+        cap          = (uint32_t)mp1.capacity();
+        mp1[i * 7] = i;
+    }
+
+    {
+        gtl::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+
+    gtl::flat_hash_map_incremental<uint64_t, uint32_t> mp2;
+    {
+        gtl::BinaryInputArchive ar_in("./dump.data");
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+
+    EXPECT_TRUE(mp1 == mp2);
+}
+
+TEST(DumpLoad, FlatHashMapMaxLoadFactor) {
+    // a table loaded with a lower maximum load factor than the dumped one keeps its own
+    gtl::flat_hash_map<uint64_t, uint32_t> mp1;
+    mp1.max_load_factor(0.9375f);
+    for (uint32_t i = 0; i < 1900; ++i)
+        mp1[i * 7] = i;
+    EXPECT_EQ(mp1.capacity(), 2047u);
+
+    {
+        gtl::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+
+    gtl::flat_hash_map<uint64_t, uint32_t> mp2;
+    mp2.max_load_factor(0.5f);
+    {
+        gtl::BinaryInputArchive ar_in("./dump.data");
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+
+    EXPECT_EQ(mp2.max_load_factor(), 0.5f);
+    EXPECT_LE(mp2.size() * 2, mp2.capacity() + 1);
+    EXPECT_TRUE(mp1 == mp2);
+    for (uint32_t i = 1900; i < 3800; ++i)
+        mp2[i * 7] = i;
+    EXPECT_LE(mp2.size() * 2, mp2.capacity() + 1);
+}
+
 TEST(DumpLoad, ParallelFlatHashMap_uint64_uint32) {
     gtl::parallel_flat_hash_map<uint64_t, uint32_t> mp1 = {
         {99,   299 },
@@ -1,3 +1,6 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -66,6 +69,45 @@ TEST(EraseIf, ParallelFlatHashMap_uint64_uint32) {
     EXPECT_TRUE(st1 == st2);
 }
 
+TEST(EraseIf, ParallelFlatHashSet_parallel) {
+    gtl::parallel_flat_hash_set<uint32_t> st1;
+    for (uint32_t i = 0; i < 1000; ++i)
+        st1.insert(i);
+    auto num_erased = gtl::erase_if(4, st1, [](const uint32_t& v) { return v % 3 != 0; });
+    EXPECT_TRUE(num_erased == 666);
+
+    gtl::parallel_flat_hash_set<uint32_t> st2;
+    for (uint32_t i = 0; i < 1000; i += 3)
+        st2.insert(i);
+    EXPECT_TRUE(st1 == st2);
+}
+
+TEST(EraseIf, ParallelFlatHashSet_throwing) {
+    // an exception thrown on a worker thread is rethrown to the caller, once
+    // all the threads are joined
+    gtl::parallel_flat_hash_set<uint32_t> st1;
+    for (uint32_t i = 0; i < 1000; ++i)
+        st1.insert(i);
+
+    const auto        caller = std::this_thread::get_id();
+    std::atomic<bool> thrown{ false };
+    auto              pred   = [&](const uint32_t&) -> bool {
+        if (std::this_thread::get_id() != caller) {
+            thrown = true;
+            throw std::runtime_error("predicate");
+        }
+        while (!thrown) // keeps the calling thread busy until a worker throws
+            std::this_thread::yield();
+        return false;
+    };
+    EXPECT_THROW(gtl::erase_if(4, st1, pred), std::runtime_error);
+    EXPECT_EQ(st1.size(), 1000u);
+
+    // the map can still be used
+    auto num_erased = gtl::erase_if(4, st1, [](const uint32_t& v) { return v % 2 != 0; });
+    EXPECT_EQ(num_erased, 500u);
+}
+
 }
 }
 }
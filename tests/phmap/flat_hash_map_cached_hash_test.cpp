@@ -0,0 +1,84 @@
+#define THIS_HASH_MAP flat_hash_map_cached_hash
+#define THIS_TEST_NAME FlatHashMapCachedHash
+
+#include "flat_hash_map_test.cpp"
+
+#include <string>
+
+namespace gtl {
+namespace priv {
+namespace {
+
+struct CountingHash {
+    size_t operator()(const std::string& s) const {
+        ++*calls;
+        return std::hash<std::string>()(s);
+    }
+    size_t* calls;
+};
+
+struct CountingEq {
+    bool operator()(const std::string& a, const std::string& b) const {
+        ++*calls;
+        return a == b;
+    }
+    size_t* calls;
+};
+
+TEST(THIS_TEST_NAME, HashNotRecomputedOnResize) {
+    size_t hash_calls = 0, eq_calls = 0;
+
+    ThisMap<std::string, int, CountingHash, CountingEq> m(0, CountingHash{ &hash_calls }, CountingEq{ &eq_calls });
+    for (int i = 0; i < 10000; ++i)
+        m.emplace(std::to_string(i), i);
+    EXPECT_GT(m.capacity(), 10000u);
+    EXPECT_EQ(hash_calls, 10000u); // once per insertion, never when resizing
+    EXPECT_EQ(eq_calls, 0u);       // no duplicates, so no key comparison
+
+    auto copy = m;
+    EXPECT_EQ(hash_calls, 10000u);
+    m.rehash(0);
+    EXPECT_EQ(hash_calls, 10000u);
+
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_EQ(copy.at(std::to_string(i)), i);
+    EXPECT_EQ(hash_calls, 20000u);
+    EXPECT_EQ(eq_calls, 10000u); // only the matching key is compared
+}
+
+TEST(THIS_TEST_NAME, FullHashComparedBeforeKeys) {
+    size_t hash_calls = 0, eq_calls = 0;
+
+    ThisMap<std::string, int, CountingHash, CountingEq> m(0, CountingHash{ &hash_calls }, CountingEq{ &eq_calls });
+    for (int i = 0; i < 10000; ++i)
+        m.emplace(std::to_string(i), i);
+
+    // with 7 bits of H2, one missing key in 128 would be compared to each
+    // element of its probe sequence.
+    for (int i = 10000; i < 100000; ++i)
+        ASSERT_FALSE(m.contains(std::to_string(i)));
+    EXPECT_EQ(eq_calls, 0u);
+}
+
+TEST(THIS_TEST_NAME, EraseAndReinsert) {
+    ThisMap<std::string, int> m;
+    for (int i = 0; i < 5000; ++i)
+        m[std::to_string(i)] = i;
+    for (int i = 0; i < 5000; i += 2)
+        m.erase(std::to_string(i));
+    for (int i = 5000; i < 10000; ++i)
+        m.insert({ std::to_string(i), i });
+    for (int i = 0; i < 10000; ++i) {
+        auto it = m.find(std::to_string(i));
+        if (i < 5000 && i % 2 == 0) {
+            ASSERT_TRUE(it == m.end());
+        } else {
+            ASSERT_TRUE(it != m.end());
+            ASSERT_EQ(it->second, i);
+        }
+    }
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,152 @@
+#define THIS_HASH_MAP flat_hash_map_incremental
+#define THIS_TEST_NAME FlatHashMapIncremental
+
+#include "flat_hash_map_test.cpp"
+
+#include <string>
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(THIS_TEST_NAME, IncrementalGrowth) {
+    ThisMap<int, std::string> m;
+    size_t                    num_resizes = 0;
+    for (int i = 0; i < 100000; ++i) {
+        size_t cap = m.capacity();
+        m.emplace(i, std::to_string(i));
+        num_resizes += (m.capacity() != cap);
+
+        // elements are found whether they were moved to the new table or not
+        if (i % 97 == 0) {
+            for (int j = 0; j <= i; j += 101) {
+                auto it = m.find(j);
+                ASSERT_TRUE(it != m.end());
+                ASSERT_EQ(it->second, std::to_string(j));
+            }
+            ASSERT_FALSE(m.contains(i + 1));
+        }
+    }
+    EXPECT_GT(num_resizes, 5u);
+    EXPECT_EQ(m.size(), 100000u);
+
+    size_t cnt = 0;
+    for (const auto& [k, v] : m) {
+        EXPECT_EQ(v, std::to_string(k));
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, m.size());
+}
+
+TEST(THIS_TEST_NAME, IncrementalGrowthIterateAndErase) {
+    // stop inserting shortly after a resize, so that iteration, erasure and
+    // copy see a table which is still moving elements from the previous one.
+    for (int extra : { 0, 1, 10, 40 }) {
+        ThisMap<int, int> m;
+        int               n = 0;
+        for (size_t resizes = 0; resizes < 3; ++n) {
+            size_t cap = m.capacity();
+            m[n]       = n;
+            resizes += (cap >= 1023 && m.capacity() != cap);
+        }
+        for (int i = 0; i < extra; ++i, ++n)
+            m[n] = n;
+        ASSERT_EQ(m.size(), (size_t)n);
+
+        std::vector<bool> seen(n);
+        for (auto& [k, v] : m) {
+            ASSERT_FALSE(seen[k]);
+            seen[k] = true;
+        }
+        EXPECT_EQ(std::count(seen.begin(), seen.end(), true), n);
+
+        ThisMap<int, int> copy(m);
+        EXPECT_EQ(copy, m);
+
+        for (auto it = m.begin(), end = m.end(); it != end;) {
+            if (it->first % 3 == 0)
+                m._erase(it++);
+            else
+                ++it;
+        }
+        for (int i = 0; i < n; ++i)
+            ASSERT_EQ(m.contains(i), i % 3 != 0);
+        EXPECT_NE(copy, m);
+
+        // keep inserting after the erasures
+        for (int i = n; i < 2 * n; ++i)
+            m[i] = i;
+        for (int i = 0; i < 2 * n; ++i)
+            ASSERT_EQ(m.contains(i), i >= n || i % 3 != 0);
+    }
+}
+
+TEST(THIS_TEST_NAME, IncrementalGrowthRehash) {
+    ThisMap<int, int> m;
+    int               n = 0;
+    for (size_t cap = m.capacity(); cap < 1023 || m.capacity() == cap; ++n) {
+        cap  = m.capacity();
+        m[n] = n;
+    }
+    m.reserve(10000);
+    EXPECT_GE(m.capacity(), 10000u);
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(m[i], i);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.begin() == m.end());
+}
+
+TEST(THIS_TEST_NAME, CompactDrains) {
+    // without insertions, compact() moves the elements of the draining table
+    using Map = ThisMap<int, int>;
+    Map m;
+    int n = 0;
+    for (size_t cap = m.capacity(); cap < 1023 || m.capacity() == cap; ++n) {
+        cap  = m.capacity();
+        m[n] = n;
+    }
+    const size_t old_capacity = m.capacity() / 2;
+
+    typename Map::compact_cursor c;
+    size_t                       calls = 1;
+    for (; m.compact(c, 1) == 0; ++calls) {
+        if (calls % 16 == 0) {
+            for (int i = 0; i < n; ++i)
+                ASSERT_EQ(m[i], i);
+        }
+    }
+    EXPECT_GT(calls, 1u);
+    EXPECT_LE(calls, old_capacity / Group::kWidth + 2);
+    EXPECT_EQ(m.size(), (size_t)n);
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(m[i], i);
+}
+
+TEST(THIS_TEST_NAME, EraseHeavyChurn) {
+    // a sliding window of keys: the tombstones left by the erasures are
+    // reclaimed during the insertions, or by rebuilding the table incrementally
+    // at the same capacity, so the table does not grow.
+    constexpr int     window = 20000;
+    ThisMap<int, int> m;
+    for (int i = 0; i < window; ++i)
+        m[i] = i;
+    size_t cap = m.capacity();
+    for (int i = window; i < 20 * window; ++i) {
+        m[i] = i;
+        m.erase(i - window);
+        if (i % 9973 == 0) {
+            for (int j = i - window + 1; j <= i; j += 7)
+                ASSERT_EQ(m[j], j);
+            ASSERT_FALSE(m.contains(i - window));
+        }
+    }
+    EXPECT_EQ(m.capacity(), cap);
+    EXPECT_EQ(m.size(), (size_t)window);
+    for (int i = 19 * window; i < 20 * window; ++i)
+        ASSERT_EQ(m[i], i);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
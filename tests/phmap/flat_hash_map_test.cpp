@@ -28,6 +28,9 @@
 
 #include "gtl/phmap.hpp"
 
+#include <atomic>
+#include <thread>
+
 #if defined(GTL_HAVE_STD_ANY)
     #include <any>
 #endif
@@ -269,6 +272,128 @@ TEST(THIS_TEST_NAME, MergeExtractInsert) {
     EXPECT_THAT(m, UnorderedElementsAre(Pair(1, 17), Pair(2, 9)));
 }
 
+TEST(THIS_TEST_NAME, InsertRange) {
+    using Map = ThisMap<int, int>;
+
+    // enough elements for several batches, every key appears twice and the
+    // first occurrence must win.
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < 1000; ++i)
+        v.emplace_back(i % 500, i);
+
+    Map m = { { 7, -1 } };
+    m.insert(v.begin(), v.end());
+    EXPECT_EQ(m.size(), 500u);
+    EXPECT_EQ(m[7], -1);
+    for (int i = 0; i < 500; ++i)
+        EXPECT_EQ(m[i], i == 7 ? -1 : i);
+
+    Map m2(v.begin(), v.end());
+    EXPECT_EQ(m2.size(), 500u);
+    EXPECT_EQ(m2[499], 499);
+}
+
+TEST(THIS_TEST_NAME, FromUniqueRange) {
+    using Map = ThisMap<int, int>;
+
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < 1000; ++i)
+        v.emplace_back(i, i * 2);
+
+    Map m(gtl::from_unique_range, v.begin(), v.end());
+    EXPECT_EQ(m.size(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(m[i], i * 2);
+
+    auto it = m.insert_unique_unchecked({ 1000, 7 });
+    EXPECT_EQ(it->first, 1000);
+    EXPECT_EQ(m.size(), 1001u);
+    EXPECT_EQ(m.find(1000), it);
+}
+
+TEST(THIS_TEST_NAME, ParallelRehash) {
+    using Map = ThisMap<int, int>;
+
+    // executor hook running the tasks on 4 threads
+    auto exec = [](size_t num_tasks, auto& task) {
+        std::atomic<size_t>      next{ 0 };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&]() {
+                for (size_t i = next++; i < num_tasks; i = next++)
+                    task(i);
+            });
+        for (auto& th : threads)
+            th.join();
+    };
+
+    Map m;
+    for (int i = 0; i < 100000; ++i)
+        m.emplace(i, i + 1);
+    auto bucket_cnt = m.bucket_count();
+
+    m.rehash(bucket_cnt * 4, exec);
+    EXPECT_GT(m.bucket_count(), bucket_cnt);
+    EXPECT_EQ(m.size(), 100000u);
+    for (int i = 0; i < 100000; ++i)
+        EXPECT_EQ(m[i], i + 1);
+
+    m.reserve(1000000, exec);
+    EXPECT_EQ(m.size(), 100000u);
+    size_t cnt = 0;
+    for (auto& p : m)
+        cnt += (p.second == p.first + 1);
+    EXPECT_EQ(cnt, 100000u);
+
+    // or the number of threads to run the tasks on
+    bucket_cnt = m.bucket_count();
+    m.rehash(bucket_cnt * 2, 4);
+    EXPECT_GT(m.bucket_count(), bucket_cnt);
+    m.reserve(4000000, 2);
+    EXPECT_EQ(m.size(), 100000u);
+    for (int i = 0; i < 100000; ++i)
+        ASSERT_EQ(m[i], i + 1);
+}
+
+TEST(THIS_TEST_NAME, FindMany) {
+    using Map = ThisMap<int, int>;
+    Map m;
+    for (int i = 0; i < 1000; i += 2)
+        m.emplace(i, i * 10);
+
+    // more keys than fit in one batch, half of them missing
+    std::vector<int> keys;
+    for (int i = 0; i < 300; ++i)
+        keys.push_back((i * 7) % 1000);
+
+    std::vector<Map::iterator> its(keys.size());
+    m.find_many(keys, its.begin());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] % 2 == 0) {
+            ASSERT_NE(its[i], m.end());
+            EXPECT_EQ(its[i]->first, keys[i]);
+            EXPECT_EQ(its[i]->second, keys[i] * 10);
+        } else {
+            EXPECT_EQ(its[i], m.end());
+        }
+    }
+
+    const Map&                       const_m = m;
+    std::vector<Map::const_iterator> cits(keys.size());
+    const_m.find_many(keys, cits.data());
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(cits[i], const_m.find(keys[i]));
+
+    std::vector<bool> found(keys.size());
+    size_t            cnt = m.contains_many(keys, found.begin());
+    EXPECT_EQ(cnt, 150u);
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(found[i], keys[i] % 2 == 0);
+
+    Map empty;
+    EXPECT_EQ(empty.contains_many(keys, found.begin()), 0u);
+}
+
 #if 0 && !defined(__ANDROID__) && !defined(__APPLE__) && !defined(__EMSCRIPTEN__) && defined(GTL_HAVE_STD_ANY)
 TEST(THIS_TEST_NAME, Any) {
   ThisMap<int, std::any> m;
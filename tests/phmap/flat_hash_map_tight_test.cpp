@@ -0,0 +1,88 @@
+#define THIS_HASH_MAP flat_hash_map_tight
+#define THIS_TEST_NAME FlatHashMapTight
+
+#include "flat_hash_map_test.cpp"
+
+#include <string>
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(THIS_TEST_NAME, TightGrowth) {
+    ThisMap<int, std::string> m;
+    size_t                    num_resizes = 0;
+    for (int i = 0; i < 100000; ++i) {
+        size_t cap = m.capacity();
+        m.emplace(i, std::to_string(i));
+        if (m.capacity() != cap) {
+            ++num_resizes;
+            // small tables double, larger ones grow by 1.5x
+            const size_t width = Group::kWidth;
+            ASSERT_EQ((m.capacity() + 1) % (cap < width - 1 ? cap + 1 : width), 0u);
+            ASSERT_LE(m.capacity(), cap < width - 1 ? 2 * cap + 1 : cap + cap / 2 + width);
+        }
+        if (i % 97 == 0) {
+            for (int j = 0; j <= i; j += 101) {
+                auto it = m.find(j);
+                ASSERT_TRUE(it != m.end());
+                ASSERT_EQ(it->second, std::to_string(j));
+            }
+            ASSERT_FALSE(m.contains(i + 1));
+        }
+    }
+    EXPECT_GT(num_resizes, 20u);
+    EXPECT_EQ(m.size(), 100000u);
+
+    size_t cnt = 0;
+    for (const auto& [k, v] : m) {
+        EXPECT_EQ(v, std::to_string(k));
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, m.size());
+}
+
+TEST(THIS_TEST_NAME, ReserveUsesOnlyWhatIsAskedFor) {
+    for (size_t n : { 1000, 5000, 100000, 1000001 }) {
+        ThisMap<int, int> m;
+        m.reserve(n);
+        const size_t cap = m.capacity();
+        // rounded up to a whole group, not to a power of 2
+        EXPECT_LT(cap, (n * 8 / 7) + Group::kWidth + 1) << n;
+        for (int i = 0; i < (int)n; ++i)
+            m.emplace(i, i);
+        EXPECT_EQ(m.capacity(), cap) << n;
+    }
+}
+
+TEST(THIS_TEST_NAME, EraseAndReinsert) {
+    // tombstones are squashed in place by tables which are not powers of 2
+    ThisMap<int, int> m;
+    m.reserve(3000);
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 3000; ++i)
+            m[round * 3000 + i] = i;
+        for (int i = 0; i < 3000; i += 3)
+            ASSERT_EQ(m.erase(round * 3000 + i), 1u);
+        for (int i = 0; i < 3000; ++i)
+            ASSERT_EQ(m.contains(round * 3000 + i), i % 3 != 0);
+        for (int i = 0; i < 3000; ++i)
+            m.erase(round * 3000 + i);
+    }
+    EXPECT_TRUE(m.empty());
+    EXPECT_LT(m.capacity(), 2 * 3000 * 8 / 7u);
+
+    for (int i = 0; i < 3000; ++i)
+        m[i] = i;
+    for (int i = 0; i < 3000; i += 2)
+        m.erase(i);
+    auto copy = m;
+    m.rehash(0);
+    EXPECT_EQ(m, copy);
+    for (int i = 0; i < 3000; ++i)
+        ASSERT_EQ(m.contains(i), i % 2 == 1);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/frozen_flat_hash_map.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(FrozenFlatHashMap, Basic) {
+    const gtl::frozen_flat_hash_map<std::string, int> m{ { "a", 1 }, { "b", 2 }, { "c", 3 }, { "a", 4 } };
+    EXPECT_EQ(m.size(), 3u);
+
+    // heterogeneous lookups, and the first of the duplicate keys is kept
+    EXPECT_EQ(m.at(std::string_view("a")), 1);
+    EXPECT_EQ(m.find("c")->second, 3);
+    EXPECT_TRUE(m.contains("b"));
+    EXPECT_EQ(m.count("d"), 0u);
+    EXPECT_EQ(m.find("d"), m.end());
+    EXPECT_THROW(m.at("d"), std::out_of_range);
+
+    int sum = 0;
+    for (auto& [k, v] : m)
+        sum += v;
+    EXPECT_EQ(sum, 6);
+
+    gtl::frozen_flat_hash_map<std::string, int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_FALSE(empty.contains("a"));
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(FrozenFlatHashMap, CompareToUnorderedMap) {
+    for (size_t n : { 1, 10, 100, 1000, 100000 }) {
+        std::unordered_map<uint64_t, uint64_t> ref;
+        std::mt19937_64                        rng(n);
+        while (ref.size() < n)
+            ref.emplace(rng(), rng());
+
+        gtl::frozen_flat_hash_map<uint64_t, uint64_t> m(ref.begin(), ref.end());
+        EXPECT_EQ(m.size(), n);
+        for (auto& [k, v] : ref)
+            ASSERT_EQ(m.at(k), v);
+        for (auto& [k, v] : m)
+            ASSERT_EQ(ref.at(k), v);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t k = rng();
+            ASSERT_EQ(m.contains(k), ref.count(k) == 1);
+        }
+        if (n >= 1000) {
+            EXPECT_GT(m.load_factor(), 0.95f);
+        }
+    }
+}
+
+TEST(FrozenFlatHashMap, SequentialKeys) {
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < 100000; ++i)
+        v.emplace_back(i, -i);
+    gtl::frozen_flat_hash_map<int, int> m(v.begin(), v.end());
+    EXPECT_EQ(m.size(), v.size());
+    EXPECT_GT(m.load_factor(), 0.95f);
+    for (int i = 0; i < 100000; ++i)
+        ASSERT_EQ(m.at(i), -i);
+    EXPECT_FALSE(m.contains(100000));
+    EXPECT_FALSE(m.contains(-1));
+}
+
+TEST(FrozenFlatHashMap, FromFlatHashMap) {
+    gtl::flat_hash_map<std::string, int> src;
+    for (int i = 0; i < 1000; ++i)
+        src.try_emplace(std::to_string(i), i);
+
+    gtl::frozen_flat_hash_map<std::string, int> m(src);
+    EXPECT_EQ(m.size(), src.size());
+    for (auto& [k, v] : src)
+        ASSERT_EQ(m.at(k), v);
+
+    auto copy = m;
+    EXPECT_EQ(copy, m);
+    gtl::frozen_flat_hash_map<std::string, int> other{ { "x", 1 } };
+    swap(copy, other);
+    EXPECT_NE(copy, m);
+    EXPECT_EQ(other, m);
+    auto moved = std::move(other);
+    EXPECT_EQ(moved.at("999"), 999);
+}
+
+TEST(FrozenFlatHashMap, MovedFrom) {
+    gtl::frozen_flat_hash_map<std::string, int> m{ { "a", 1 }, { "b", 2 } };
+    auto                                        m2 = std::move(m);
+    EXPECT_EQ(m2.at("b"), 2);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+    EXPECT_FALSE(m.contains("a"));
+    EXPECT_TRUE(m.find("b") == m.end());
+    EXPECT_EQ(m.load_factor(), 0.0f);
+    EXPECT_NE(m, m2);
+
+    gtl::frozen_flat_hash_map<std::string, int> m3{ { "c", 3 } };
+    m3 = std::move(m2);
+    EXPECT_EQ(m3.size(), 2u);
+    EXPECT_TRUE(m2.empty());
+    EXPECT_FALSE(m2.contains("a"));
+    m2 = m3;
+    EXPECT_EQ(m2, m3);
+}
+
+struct ConstantHash {
+    size_t operator()(int) const { return 42; }
+};
+
+TEST(FrozenFlatHashMap, SameHash) {
+    // up to a group of keys with the same hash value can be stored
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < (int)Group::kWidth; ++i)
+        v.emplace_back(i, i);
+    gtl::frozen_flat_hash_map<int, int, ConstantHash> m(v.begin(), v.end());
+    for (int i = 0; i < (int)Group::kWidth; ++i)
+        ASSERT_EQ(m.at(i), i);
+
+    v.emplace_back(-1, -1);
+    using Map = gtl::frozen_flat_hash_map<int, int, ConstantHash>;
+    EXPECT_THROW(Map(v.begin(), v.end()), std::length_error);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,166 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/mapped_flat_hash_map.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+constexpr const char* kFile = "./mapped_dump.data";
+
+template<class Map>
+void dump(const Map& m) {
+    gtl::BinaryOutputArchive ar_out(kFile);
+    EXPECT_TRUE(m.phmap_dump_mappable(ar_out));
+}
+
+template<class Map, class View>
+void expect_same(const Map& m, const View& v) {
+    EXPECT_EQ(v.size(), m.size());
+    EXPECT_EQ(v.capacity(), m.capacity());
+    size_t n = 0;
+    for (const auto& [k, val] : v) {
+        auto it = m.find(k);
+        ASSERT_TRUE(it != m.end());
+        EXPECT_EQ(val, it->second);
+        ++n;
+    }
+    EXPECT_EQ(n, m.size());
+    for (const auto& [k, val] : m) {
+        auto it = v.find(k);
+        ASSERT_TRUE(it != v.end());
+        EXPECT_EQ(it->second, val);
+        EXPECT_EQ(v.at(k), val);
+    }
+}
+
+TEST(MappedFlatHashMap, Basic) {
+    gtl::flat_hash_map<uint64_t, uint64_t> m;
+    for (uint64_t i = 0; i < 10000; ++i)
+        m[i * 3] = i;
+    for (uint64_t i = 0; i < 10000; i += 5)
+        m.erase(i * 3); // leaves deleted slots in the table
+    dump(m);
+
+    gtl::mapped_flat_hash_map<uint64_t, uint64_t> v;
+    ASSERT_TRUE(v.open(kFile));
+    EXPECT_TRUE(v.is_open());
+    expect_same(m, v);
+    for (uint64_t i = 0; i < 10000; ++i) {
+        EXPECT_EQ(v.contains(i * 3), i % 5 != 0);
+        EXPECT_FALSE(v.contains(i * 3 + 1));
+    }
+    EXPECT_EQ(v.count(3), 1u);
+    EXPECT_EQ(v.count(0), 0u);
+    EXPECT_THROW(v.at(1), std::out_of_range);
+
+    auto v2 = std::move(v);
+    EXPECT_EQ(v2.size(), m.size());
+    EXPECT_TRUE(v2.contains(3));
+    EXPECT_FALSE(v.is_open());
+    EXPECT_TRUE(v.empty());
+    EXPECT_FALSE(v.contains(3));
+    EXPECT_EQ(v.begin(), v.end());
+
+    v = std::move(v2);
+    EXPECT_TRUE(v.contains(3));
+    EXPECT_FALSE(v2.is_open());
+    EXPECT_FALSE(v2.contains(3));
+    v.close();
+    EXPECT_FALSE(v2.contains(3));
+    ASSERT_TRUE(v2.open(kFile));
+
+    v2.close();
+    EXPECT_FALSE(v2.is_open());
+    EXPECT_TRUE(v2.empty());
+    EXPECT_FALSE(v2.contains(3));
+    std::remove(kFile);
+}
+
+TEST(MappedFlatHashMap, Tight) {
+    gtl::flat_hash_map_tight<uint64_t, uint32_t> m;
+    m.reserve(3000);
+    std::mt19937_64 gen(7);
+    while (m.size() < 3000)
+        m[gen()] = (uint32_t)m.size();
+    dump(m);
+
+    gtl::mapped_flat_hash_map<uint64_t, uint32_t> v;
+    ASSERT_TRUE(v.open(kFile));
+    expect_same(m, v);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_FALSE(v.contains(gen()));
+    std::remove(kFile);
+}
+
+TEST(MappedFlatHashMap, Empty) {
+    gtl::flat_hash_map<uint64_t, uint64_t> m;
+    dump(m);
+
+    gtl::mapped_flat_hash_map<uint64_t, uint64_t> v;
+    ASSERT_TRUE(v.open(kFile));
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.begin(), v.end());
+    EXPECT_FALSE(v.contains(0));
+    EXPECT_EQ(v.find(0), v.end());
+    std::remove(kFile);
+}
+
+TEST(MappedFlatHashMap, RejectsOtherFiles) {
+    gtl::flat_hash_map<uint64_t, uint64_t> m = {
+        { 1, 2 },
+        { 3, 4 }
+    };
+    gtl::mapped_flat_hash_map<uint64_t, uint64_t> v;
+    EXPECT_FALSE(v.open("./does_not_exist.data"));
+
+    // a layout mismatch
+    dump(m);
+    gtl::mapped_flat_hash_map<uint32_t, uint32_t> v32;
+    EXPECT_FALSE(v32.open(kFile));
+    EXPECT_FALSE(v32.is_open());
+
+    // a dump written by phmap_dump()
+    {
+        gtl::BinaryOutputArchive ar_out(kFile);
+        EXPECT_TRUE(m.phmap_dump(ar_out));
+    }
+    EXPECT_FALSE(v.open(kFile));
+    EXPECT_TRUE(v.empty());
+
+    // a dump whose sentinel control byte was overwritten
+    dump(m);
+    std::vector<char> bytes;
+    {
+        std::ifstream in(kFile, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GE(bytes.size(), sizeof(mapped_dump_header));
+    mapped_dump_header h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    ASSERT_EQ(h.capacity, m.capacity());
+    ASSERT_EQ(bytes[h.ctrl_offset + h.capacity], static_cast<char>(kSentinel));
+    EXPECT_TRUE(v.open(kFile));
+    v.close();
+    bytes[h.ctrl_offset + h.capacity] = static_cast<char>(kEmpty);
+    {
+        std::ofstream out(kFile, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    EXPECT_FALSE(v.open(kFile));
+    EXPECT_FALSE(v.is_open());
+    std::remove(kFile);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
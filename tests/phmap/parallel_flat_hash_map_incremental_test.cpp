@@ -0,0 +1,81 @@
+#define THIS_HASH_MAP parallel_flat_hash_map_incremental
+#define THIS_TEST_NAME ParallelFlatHashMapIncremental
+
+#include <atomic>
+#include <thread>
+
+#include "parallel_hash_map_test.cpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(THIS_TEST_NAME, ConcurrentIncrementalGrowth) {
+    using Table = gtl::parallel_flat_hash_map_incremental<int,
+                                                          int,
+                                                          gtl::priv::hash_default_hash<int>,
+                                                          gtl::priv::hash_default_eq<int>,
+                                                          gtl::priv::Allocator<gtl::priv::Pair<const int, int>>,
+                                                          4,
+                                                          std::mutex>;
+    static constexpr int THREADS = 4;
+    static constexpr int PER_THREAD = 50000;
+
+    Table                    table;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&table, t]() {
+            for (int i = t; i < THREADS * PER_THREAD; i += THREADS) {
+                table.try_emplace(i, i);
+                // keys inserted earlier by this thread are still visible
+                if (i % 1000 == t) {
+                    for (int j = t; j < i; j += 997 * THREADS)
+                        ASSERT_TRUE(table.if_contains(j, [&](const auto& v) { ASSERT_EQ(v.second, j); }));
+                }
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(table.size(), (size_t)THREADS * PER_THREAD);
+    for (int i = 0; i < THREADS * PER_THREAD; ++i)
+        ASSERT_EQ(table[i], i);
+}
+
+TEST(THIS_TEST_NAME, ConcurrentCompact) {
+    using Table = gtl::parallel_flat_hash_map_incremental<int,
+                                                          int,
+                                                          gtl::priv::hash_default_hash<int>,
+                                                          gtl::priv::hash_default_eq<int>,
+                                                          gtl::priv::Allocator<gtl::priv::Pair<const int, int>>,
+                                                          4,
+                                                          std::mutex>;
+    static constexpr int WINDOW = 50000;
+
+    Table table;
+    for (int i = 0; i < WINDOW; ++i)
+        table.try_emplace(i, i);
+
+    // a background thread squashes the tombstones left by the churn
+    std::atomic<bool> done{ false };
+    std::thread       compactor([&]() {
+        while (!done)
+            if (!table.compact(1))
+                std::this_thread::yield();
+    });
+    for (int i = WINDOW; i < 10 * WINDOW; ++i) {
+        table.try_emplace(i, i);
+        table.erase(i - WINDOW);
+    }
+    done = true;
+    compactor.join();
+
+    EXPECT_EQ(table.size(), (size_t)WINDOW);
+    for (int i = 9 * WINDOW; i < 10 * WINDOW; ++i)
+        ASSERT_TRUE(table.if_contains(i, [&](const auto& v) { ASSERT_EQ(v.second, i); }));
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
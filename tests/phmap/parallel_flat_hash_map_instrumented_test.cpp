@@ -0,0 +1,81 @@
+#define THIS_HASH_MAP parallel_flat_hash_map
+#define THIS_TEST_NAME ParallelFlatHashMapInstrumented
+#define THIS_EXTRA_TPL_PARAMS , 4, gtl::InstrumentedMutex<std::shared_mutex>
+
+#include <atomic>
+#include <shared_mutex>
+#include <thread>
+
+#include "parallel_hash_map_test.cpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+template<class Mutex>
+using InstrumentedMap = gtl::parallel_flat_hash_map<int,
+                                                    int,
+                                                    gtl::priv::hash_default_hash<int>,
+                                                    gtl::priv::hash_default_eq<int>,
+                                                    gtl::priv::Allocator<gtl::priv::Pair<const int, int>>,
+                                                    4,
+                                                    gtl::InstrumentedMutex<Mutex>>;
+
+TEST(THIS_TEST_NAME, LockStats) {
+    InstrumentedMap<std::mutex> m;
+    for (int i = 0; i < 1000; ++i)
+        m.emplace(i, i);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_TRUE(m.contains(i));
+
+    lock_stats_t total;
+    for (size_t i = 0; i < m.subcnt(); ++i) {
+        lock_stats_t st = m.lock_stats(i);
+        EXPECT_GT(st.acquisitions, 0u); // 1000 keys are spread over all 16 submaps
+        EXPECT_EQ(st.contended, 0u);
+        EXPECT_EQ(st.wait_time.count(), 0);
+        total += st;
+    }
+    EXPECT_EQ(total.acquisitions, 2000u);
+
+    m.reset_lock_stats();
+    m.for_each([](const auto&) {});
+    for (size_t i = 0; i < m.subcnt(); ++i)
+        EXPECT_EQ(m.lock_stats(i).acquisitions, 1u);
+}
+
+TEST(THIS_TEST_NAME, LockStatsContended) {
+    InstrumentedMap<std::shared_mutex> m;
+    m.emplace(1, 0);
+    const size_t idx = m.subidx(m.hash(1));
+
+    // hold the lock of the submap containing 1 while another thread updates it
+    std::atomic<bool> started{ false };
+    std::thread       th;
+    m.with_submap_m(idx, [&](auto&) {
+        th = std::thread([&]() {
+            started = true;
+            m.modify_if(1, [](auto& v) { v.second = 2; });
+        });
+        while (!started)
+            std::this_thread::yield();
+        // the worker bumps `contended` once its try_lock failed, right before it blocks
+        while (m.lock_stats(idx).contended == 0)
+            std::this_thread::yield();
+    });
+    th.join();
+    EXPECT_EQ(m[1], 2);
+
+    lock_stats_t st = m.lock_stats(idx);
+    EXPECT_EQ(st.contended, 1u);
+    EXPECT_GT(st.wait_time.count(), 0);
+
+    // shared locks are counted as well
+    m.reset_lock_stats();
+    EXPECT_TRUE(m.if_contains(1, [](const auto& v) { EXPECT_EQ(v.second, 2); }));
+    EXPECT_EQ(m.lock_stats(idx).acquisitions, 1u);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,137 @@
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/phmap.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(ParallelFlatHashMapReshardable, Basic) {
+    gtl::parallel_flat_hash_map_reshardable<std::string, int> m(5);
+    EXPECT_EQ(m.subcnt(), 8u);
+    EXPECT_TRUE(m.empty());
+
+    EXPECT_TRUE(m.emplace("a", 1));
+    EXPECT_FALSE(m.emplace("a", 2));
+    EXPECT_TRUE(m.insert({ "b", 2 }));
+    EXPECT_TRUE(m.try_emplace("c", 3));
+    EXPECT_FALSE(m.insert_or_assign("c", 4));
+    EXPECT_TRUE(m.lazy_emplace_l(
+        "d", [](auto&) { FAIL(); }, [](const auto& ctor) { ctor("d", 5); }));
+    EXPECT_FALSE(m.try_emplace_l("d", [](auto& v) { ++v.second; }, 0));
+    EXPECT_EQ(m.size(), 4u);
+
+    int val = 0;
+    EXPECT_TRUE(m.if_contains("c", [&](const auto& v) { val = v.second; }));
+    EXPECT_EQ(val, 4);
+    EXPECT_TRUE(m.modify_if("a", [](auto& v) { v.second = 10; }));
+    EXPECT_TRUE(m.if_contains("a", [&](const auto& v) { val = v.second; }));
+    EXPECT_EQ(val, 10);
+    EXPECT_TRUE(m.if_contains("d", [&](const auto& v) { val = v.second; }));
+    EXPECT_EQ(val, 6);
+    EXPECT_FALSE(m.contains("e"));
+    EXPECT_EQ(m.count("b"), 1u);
+
+    EXPECT_FALSE(m.erase_if("b", [](const auto& v) { return v.second != 2; }));
+    EXPECT_TRUE(m.erase_if("b", [](const auto& v) { return v.second == 2; }));
+    EXPECT_EQ(m.erase("a"), 1u);
+    EXPECT_EQ(m.erase("a"), 0u);
+    EXPECT_EQ(m.size(), 2u);
+
+    int sum = 0;
+    m.for_each_m([](auto& v) { v.second *= 2; });
+    m.for_each([&](const auto& v) { sum += v.second; });
+    EXPECT_EQ(sum, 20);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+}
+
+TEST(ParallelFlatHashMapReshardable, Reshard) {
+    gtl::parallel_flat_hash_map_reshardable<int, int> m(1);
+    EXPECT_EQ(m.subcnt(), 1u);
+    for (int i = 0; i < 100000; ++i)
+        m.try_emplace(i, i);
+
+    // the shard count is rounded up to a power of 2, and never decreases
+    std::pair<size_t, size_t> steps[] = { { 2, 2 }, { 3, 4 }, { 16, 16 }, { 16, 16 }, { 8, 16 }, { 200, 256 } };
+    for (auto [n, expected] : steps) {
+        m.reshard(n);
+        EXPECT_EQ(m.subcnt(), expected);
+        EXPECT_EQ(m.size(), 100000u);
+        for (int i = 0; i < 100000; ++i)
+            ASSERT_TRUE(m.if_contains(i, [&](const auto& v) { ASSERT_EQ(v.second, i); }));
+    }
+
+    m.reserve(200000);
+    for (int i = 100000; i < 200000; ++i)
+        m.try_emplace(i, i);
+    EXPECT_EQ(m.size(), 200000u);
+}
+
+TEST(ParallelFlatHashMapReshardable, InsertAfterReshard) {
+    // splitting must leave the shards room to grow
+    gtl::parallel_flat_hash_map_reshardable<int, int> m(1);
+    for (int i = 0; i < 15000; ++i)
+        m.try_emplace(i, i);
+    for (size_t n = 2; n <= 128; n *= 2) {
+        m.reshard(n);
+        for (int i = 0; i < 1000; ++i)
+            EXPECT_TRUE(m.try_emplace(int(15000 + n * 1000 + i), i));
+    }
+    EXPECT_EQ(m.size(), 15000u + 7 * 1000);
+}
+
+TEST(ParallelFlatHashMapReshardable, ConcurrentReshard) {
+    using Map = gtl::parallel_flat_hash_map_reshardable<int,
+                                                        int,
+                                                        gtl::priv::hash_default_hash<int>,
+                                                        gtl::priv::hash_default_eq<int>,
+                                                        gtl::priv::Allocator<gtl::priv::Pair<const int, int>>,
+                                                        std::shared_mutex>;
+    static constexpr int THREADS = 4;
+    static constexpr int NUM     = 50000;
+
+    Map                      m(2);
+    std::atomic<bool>        done{ false };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&m, t]() {
+            // every thread increments every counter, and checks the counters
+            // it already incremented
+            for (int i = 0; i < NUM; ++i) {
+                m.try_emplace_l(i, [](auto& v) { ++v.second; }, 1);
+                if (i % 100 == t) {
+                    for (int j = 0; j <= i; j += 997)
+                        ASSERT_TRUE(m.contains(j));
+                }
+            }
+        });
+    }
+    std::thread resharder([&]() {
+        for (size_t n = 4; n <= 1024 && !done; n *= 2) {
+            m.reshard(n);
+            std::this_thread::yield();
+        }
+    });
+    for (auto& th : threads)
+        th.join();
+    done = true;
+    resharder.join();
+
+    EXPECT_EQ(m.size(), (size_t)NUM);
+    for (int i = 0; i < NUM; ++i)
+        ASSERT_TRUE(m.if_contains(i, [&](const auto& v) { ASSERT_EQ(v.second, THREADS); }));
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
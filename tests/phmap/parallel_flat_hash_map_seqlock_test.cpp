@@ -0,0 +1,115 @@
+#define THIS_HASH_MAP parallel_flat_hash_map_seqlock
+#define THIS_TEST_NAME ParallelFlatHashMapSeqlock
+
+#include <atomic>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+
+#include "parallel_hash_map_test.cpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+struct Checked {
+    uint64_t a;
+    uint64_t b; // always 3 * a, unless the read was torn
+};
+
+TEST(THIS_TEST_NAME, OptimisticReads) {
+    static_assert(gtl::parallel_flat_hash_map_seqlock<int, int>::kOptimisticReads);
+    static_assert(gtl::parallel_flat_hash_map_seqlock<int, Checked>::kOptimisticReads);
+
+    // values which can't be copied bitwise, or an allocator which may unmap
+    // the previous tables, fall back to locked lookups
+    static_assert(!gtl::parallel_flat_hash_map_seqlock<int, std::string>::kOptimisticReads);
+
+    // keys which point to memory could be dereferenced while torn
+    static_assert(!gtl::parallel_flat_hash_map_seqlock<std::string_view, int>::kOptimisticReads);
+    static_assert(!gtl::parallel_flat_hash_map_seqlock<const char*, int>::kOptimisticReads);
+    static_assert(!ThisMap<int, int>::kOptimisticReads);
+    static_assert(!gtl::parallel_flat_hash_map<int, int>::kOptimisticReads);
+
+    gtl::parallel_flat_hash_map_seqlock<int, int> m;
+    for (int i = 0; i < 1000; ++i)
+        m.emplace(i, 2 * i);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(m.contains(i));
+        ASSERT_EQ(m.count(i), 1u);
+        ASSERT_TRUE(m.if_contains(i, [&](const auto& v) { ASSERT_EQ(v.second, 2 * i); }));
+    }
+    EXPECT_FALSE(m.contains(1000));
+    EXPECT_FALSE(m.if_contains(-1, [](const auto&) { FAIL(); }));
+
+    m.clear();
+    EXPECT_FALSE(m.contains(1));
+}
+
+TEST(THIS_TEST_NAME, ConcurrentReadsDuringWrites) {
+    static constexpr uint64_t NUM_KEYS = 100000;
+    static constexpr int      READERS  = 3;
+
+    gtl::parallel_flat_hash_map_seqlock<uint64_t, Checked> m;
+    std::atomic<bool>                                      done{ false };
+    std::atomic<uint64_t>                                  hits{ 0 }, torn{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < READERS; ++t) {
+        readers.emplace_back([&, t]() {
+            uint64_t cnt = 0, bad = 0;
+            for (uint64_t i = t; !done; i += 7) {
+                cnt += m.if_contains(i % NUM_KEYS, [&](const auto& v) {
+                    bad += (v.second.b != 3 * v.second.a || v.first != v.second.a % NUM_KEYS);
+                });
+            }
+            hits += cnt;
+            torn += bad;
+        });
+    }
+
+    // the writer grows the submaps, overwrites values, erases and clears
+    for (uint64_t round = 0; round < 6; ++round) {
+        for (uint64_t i = 0; i < NUM_KEYS; ++i) {
+            uint64_t a = i + round * NUM_KEYS;
+            m.insert_or_assign(i, Checked{ a, 3 * a });
+        }
+        for (uint64_t i = round % 2; i < NUM_KEYS; i += 2)
+            m.erase(i);
+        if (round % 3 == 2)
+            m.clear();
+    }
+    done = true;
+    for (auto& th : readers)
+        th.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(m.size(), 0u);
+}
+
+TEST(THIS_TEST_NAME, SharedMutex) {
+    using Map = gtl::parallel_flat_hash_map_seqlock<int,
+                                                    int,
+                                                    gtl::priv::hash_default_hash<int>,
+                                                    gtl::priv::hash_default_eq<int>,
+                                                    gtl::retaining_allocator<gtl::priv::Pair<const int, int>>,
+                                                    4,
+                                                    gtl::SeqMutex<std::shared_mutex>>;
+    static_assert(Map::kOptimisticReads);
+
+    Map m;
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace_l(i, [](auto& v) { ++v.second; }, i);
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace_l(i, [](auto& v) { ++v.second; }, i);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_TRUE(m.if_contains(i, [&](const auto& v) { ASSERT_EQ(v.second, i + 1); }));
+
+    size_t cnt = 0;
+    m.for_each([&](const auto&) { ++cnt; });
+    EXPECT_EQ(cnt, 1000u);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
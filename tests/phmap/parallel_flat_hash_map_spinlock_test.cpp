@@ -0,0 +1,162 @@
+#define THIS_HASH_MAP parallel_flat_hash_map
+#define THIS_TEST_NAME ParallelFlatHashMapSpinlock
+#define THIS_EXTRA_TPL_PARAMS , 4, gtl::rw_spin_mutex
+
+#include <chrono>
+#include <thread>
+
+#include "parallel_hash_map_test.cpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+template<class Mutex>
+void check_mutual_exclusion() {
+    static constexpr int THREADS = 4;
+    static constexpr int ITERS   = 20000;
+
+    Mutex                    mtx;
+    uint64_t                 a = 0, b = 0; // protected by mtx
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < ITERS; ++i) {
+                if (i % 2) {
+                    std::lock_guard lock(mtx);
+                    ++a;
+                    ++b;
+                } else {
+                    while (!mtx.try_lock())
+                        ;
+                    ++a;
+                    ++b;
+                    mtx.unlock();
+                }
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    EXPECT_EQ(a, (uint64_t)THREADS * ITERS);
+    EXPECT_EQ(b, a);
+}
+
+TEST(THIS_TEST_NAME, SpinMutexes) {
+    static_assert(sizeof(gtl::spin_mutex) == 4);
+    static_assert(sizeof(gtl::ticket_mutex) == 4);
+    static_assert(sizeof(gtl::rw_spin_mutex) == 4);
+
+    check_mutual_exclusion<gtl::spin_mutex>();
+    check_mutual_exclusion<gtl::ticket_mutex>();
+    check_mutual_exclusion<gtl::rw_spin_mutex>();
+}
+
+TEST(THIS_TEST_NAME, RwSpinMutexShared) {
+    gtl::rw_spin_mutex mtx;
+    mtx.lock_shared();
+    EXPECT_TRUE(mtx.try_lock_shared());
+    EXPECT_FALSE(mtx.try_lock());
+    mtx.unlock_shared();
+    mtx.unlock_shared();
+    EXPECT_TRUE(mtx.try_lock());
+    EXPECT_FALSE(mtx.try_lock_shared());
+    mtx.unlock();
+
+    // readers see the two values written under the exclusive lock together
+    std::atomic<bool>        done{ false };
+    uint64_t                 a = 0, b = 0;
+    std::vector<std::thread> readers;
+    std::atomic<uint64_t>    torn{ 0 };
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                std::shared_lock lock(mtx);
+                torn += (a != b);
+            }
+        });
+    }
+    for (int i = 0; i < 100000; ++i) {
+        std::lock_guard lock(mtx);
+        ++a;
+        ++b;
+    }
+    done = true;
+    for (auto& th : readers)
+        th.join();
+    EXPECT_EQ(torn, 0u);
+}
+
+TEST(THIS_TEST_NAME, RwSpinMutexWaitingWriters) {
+    // readers stay out as long as any writer is waiting, not only until the
+    // first waiting writer gets the lock
+    gtl::rw_spin_mutex       mtx;
+    std::atomic<int>         acquired{ 0 };
+    std::atomic<bool>        release{ false };
+    std::vector<std::thread> writers;
+
+    mtx.lock();
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&]() {
+            mtx.lock();
+            ++acquired;
+            while (!release)
+                std::this_thread::yield();
+            mtx.unlock();
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // let both writers wait
+    EXPECT_FALSE(mtx.try_lock_shared());
+    mtx.unlock();
+
+    while (acquired == 0)
+        std::this_thread::yield();
+    EXPECT_FALSE(mtx.try_lock_shared());
+    release = true;
+    for (auto& th : writers)
+        th.join();
+    EXPECT_EQ(acquired, 2);
+    EXPECT_TRUE(mtx.try_lock_shared());
+    mtx.unlock_shared();
+}
+
+template<class Mutex>
+void check_concurrent_map() {
+    using Map = gtl::parallel_flat_hash_map<int,
+                                            int,
+                                            gtl::priv::hash_default_hash<int>,
+                                            gtl::priv::hash_default_eq<int>,
+                                            gtl::priv::Allocator<gtl::priv::Pair<const int, int>>,
+                                            4,
+                                            Mutex>;
+    static constexpr int THREADS = 4;
+    static constexpr int NUM     = 20000;
+
+    Map                      m;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&m]() {
+            // every thread increments every counter once
+            for (int i = 0; i < NUM; ++i)
+                m.try_emplace_l(i, [](auto& v) { ++v.second; }, 1);
+            for (int i = 0; i < NUM; ++i)
+                ASSERT_TRUE(m.contains(i));
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(m.size(), (size_t)NUM);
+    for (int i = 0; i < NUM; ++i)
+        ASSERT_EQ(m[i], THREADS);
+}
+
+TEST(THIS_TEST_NAME, ConcurrentUpdates) {
+    check_concurrent_map<gtl::spin_mutex>();
+    check_concurrent_map<gtl::ticket_mutex>();
+    check_concurrent_map<gtl::rw_spin_mutex>();
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -1,6 +1,7 @@
 #define THIS_HASH_MAP parallel_flat_hash_map
 #define THIS_TEST_NAME ParallelFlatHashMap
 
+#include <atomic>
 #include <thread>
 
 #include "parallel_hash_map_test.cpp"
@@ -46,4 +47,35 @@ TEST(THIS_TEST_NAME, ConcurrencyCheck) {
    }
 
    EXPECT_EQ(table[KEY], 10000);
-}
\ No newline at end of file
+}
+
+TEST(THIS_TEST_NAME, ConcurrentReadFirstEmplace) {
+   // the lookups are done under a read lock, which is upgraded to insert:
+   // each key must still be inserted exactly once
+   static constexpr int THREADS = 8;
+   static constexpr int KEYS = 20000;
+
+   Table table;
+   std::atomic<int> emplaced{0}, found{0};
+   std::vector<std::thread> threads;
+   for (int t = 0; t < THREADS; ++t) {
+      threads.emplace_back([&, t]() {
+         for (int i = 0; i < KEYS; ++i) {
+            int key = (i * 7 + t) % KEYS;
+            table.lazy_emplace_l_shared(
+               key,
+               [&](const Table::value_type &v) { found += (v.second == 2 * v.first); },
+               [&](const Table::constructor &ctor) {
+                  ++emplaced;
+                  ctor(key, 2 * key);
+               });
+         }
+      });
+   }
+   for (auto &thread : threads)
+      thread.join();
+
+   EXPECT_EQ(emplaced, KEYS);
+   EXPECT_EQ(found, THREADS * KEYS - KEYS);
+   EXPECT_EQ(table.size(), (size_t)KEYS);
+}
@@ -0,0 +1,27 @@
+#define THIS_HASH_MAP parallel_flat_hash_map_tight
+#define THIS_TEST_NAME ParallelFlatHashMapTight
+
+#include <random>
+
+#include "parallel_hash_map_test.cpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+TEST(THIS_TEST_NAME, ReserveUsesOnlyWhatIsAskedFor) {
+    gtl::parallel_flat_hash_map_tight<uint64_t, int> m;
+    m.reserve(100000);
+    const size_t cap = m.capacity();
+    EXPECT_LT(cap, 100000u * 8 / 7 * 11 / 10);
+
+    // random keys are spread evenly enough over the submaps that none grows
+    std::mt19937_64 rng(42);
+    while (m.size() < 100000)
+        m.emplace(rng(), 0);
+    EXPECT_EQ(m.capacity(), cap);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
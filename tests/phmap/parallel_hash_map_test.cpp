@@ -3,6 +3,8 @@
     #define THIS_TEST_NAME ParallelFlatHashMap
 #endif
 
+#include <deque>
+
 #include "flat_hash_map_test.cpp"
 
 namespace gtl {
@@ -117,6 +119,137 @@ TEST(THIS_TEST_NAME, LazyEmplaceL) {
     EXPECT_EQ(m[5], 6);
 }
 
+TEST(THIS_TEST_NAME, SharedEmplaceL) {
+    // ---------------------------------------------------------------------
+    // the _shared versions call the first lambda with a const value_type&,
+    // under a read lock
+    // ---------------------------------------------------------------------
+    using Map = ThisMap<int, int>;
+    Map m     = {
+        {1,  7},
+        { 2, 9}
+    };
+
+    int seen = 0;
+    EXPECT_FALSE(m.lazy_emplace_l_shared(
+        1, [&](const Map::value_type& v) { seen = v.second; }, [](const Map::constructor& ctor) { ctor(1, 0); }));
+    EXPECT_EQ(seen, 7);
+    EXPECT_TRUE(m.lazy_emplace_l_shared(
+        3, [&](auto& v) { seen = v.second; }, [](const Map::constructor& ctor) { ctor(3, 11); }));
+    EXPECT_EQ(m[3], 11);
+
+    EXPECT_FALSE(m.try_emplace_l_shared(2, [&](const Map::value_type& v) { seen = v.second; }, 0));
+    EXPECT_EQ(seen, 9);
+    EXPECT_TRUE(m.try_emplace_l_shared(4, [&](const auto& v) { seen = v.second; }, 12));
+    EXPECT_EQ(m[4], 12);
+    EXPECT_EQ(m.size(), 4u);
+
+    // lazy_emplace_l and try_emplace_l keep the write lock, whatever the
+    // lambda takes
+    EXPECT_FALSE(m.lazy_emplace_l(
+        1, [&](const Map::value_type& v) { seen = v.second; }, [](const Map::constructor& ctor) { ctor(1, 0); }));
+    EXPECT_EQ(seen, 7);
+    EXPECT_FALSE(m.try_emplace_l(2, [&](const Map::value_type& v) { seen = v.second; }, 0));
+    EXPECT_EQ(seen, 9);
+}
+
+TEST(THIS_TEST_NAME, InsertRangeDeque) {
+    using Map = ThisMap<int, int>;
+
+    // several blocks, through iterators which are not pointers
+    std::deque<std::pair<int, int>> v;
+    for (int i = 0; i < 1000; ++i)
+        v.emplace_back(i, -i);
+
+    Map m;
+    m.insert(v.begin(), v.end());
+    Map u;
+    u.insert_unique_unchecked(v.begin(), v.end());
+    EXPECT_EQ(m.size(), v.size());
+    EXPECT_EQ(m, u);
+    for (const auto& p : v)
+        EXPECT_EQ(m.at(p.first), p.second);
+}
+
+TEST(THIS_TEST_NAME, ParallelInsert) {
+    using Map = ThisMap<int, int>;
+
+    // with duplicate keys, the first occurrence wins, as with insert()
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < 100000; ++i)
+        v.emplace_back((i * 7919) % 60000, i);
+
+    Map expected;
+    expected.insert(v.begin(), v.end());
+
+    Map m = {
+        {-1, 1}
+    };
+    m.parallel_insert(v.begin(), v.end(), 4);
+    EXPECT_EQ(m.size(), expected.size() + 1);
+    m.erase(-1);
+    EXPECT_EQ(m, expected);
+
+    // executor hook, running the tasks in reverse order
+    Map m2;
+    m2.parallel_insert(v, [](size_t num_tasks, auto& task) {
+        for (size_t i = num_tasks; i-- > 0;)
+            task(i);
+    });
+    EXPECT_EQ(m2, expected);
+
+    // small ranges are inserted directly
+    Map m3;
+    m3.parallel_insert(std::span(v).first(100), 4);
+    EXPECT_EQ(m3.size(), 100u);
+}
+
+TEST(THIS_TEST_NAME, ParallelAlgorithms) {
+    using Map = ThisMap<int, int>;
+    auto pool = [](size_t num_tasks, auto& task) { // runs the tasks in reverse order
+        for (size_t i = num_tasks; i-- > 0;)
+            task(i);
+    };
+
+    Map a, b;
+    for (int i = 0; i < 10000; ++i) {
+        a.emplace(i, i);
+        b.emplace(i + 5000, -i);
+    }
+
+    // merge: the keys present in both stay in `b`
+    a.merge(b, 4);
+    EXPECT_EQ(a.size(), 15000u);
+    EXPECT_EQ(b.size(), 5000u);
+    for (int i = 5000; i < 10000; ++i)
+        ASSERT_EQ(a[i], i);
+    a.merge(Map{ { -1, 1 } }, pool);
+    EXPECT_EQ(a.size(), 15001u);
+
+    // equal
+    Map copy(a);
+    EXPECT_TRUE(copy.equal(a, 4));
+    EXPECT_TRUE(a.equal(a, pool));
+    copy[3] = 4;
+    EXPECT_FALSE(copy.equal(a, pool));
+    copy[3] = 3;
+    copy.erase(0);
+    EXPECT_FALSE(copy.equal(a, 4));
+
+    // transform_reduce
+    auto key_sum = a.transform_reduce(4, int64_t(100), std::plus<>(), [](const auto& v) { return (int64_t)v.first; });
+    EXPECT_EQ(key_sum, 100 - 1 + (int64_t)15000 * 14999 / 2);
+    EXPECT_EQ(Map().transform_reduce(pool, 7, std::plus<>(), [](const auto& v) { return v.second; }), 7);
+
+    // erase_if
+    EXPECT_EQ(a.parallel_erase_if(4, [](const auto& v) { return v.first % 2 == 0; }), 7500u);
+    EXPECT_EQ(a.size(), 7501u);
+    for (int i = 0; i < 15000; ++i)
+        ASSERT_EQ(a.contains(i), i % 2 == 1);
+    EXPECT_EQ(a.parallel_erase_if(pool, [](const auto& v) { return v.first < 0; }), 1u);
+    EXPECT_EQ(a.size(), 7500u);
+}
+
 TEST(THIS_TEST_NAME, EraseIf) {
     // -------------
     // test erase_if
@@ -197,6 +330,36 @@ TEST(THIS_TEST_NAME, EmplaceSingle) {
     EXPECT_EQ(m.count(11), 0);
 }
 
+TEST(THIS_TEST_NAME, Compact) {
+    using Map = ThisMap<int, int>;
+    Map m;
+    m.reserve(100000);
+    for (int i = 0; i < 100000; ++i)
+        m[i] = i;
+    for (int i = 0; i < 100000; i += 2)
+        m.erase(i);
+
+    // with a zero budget, compact() only returns the work left
+    size_t left = m.compact(0);
+    EXPECT_GT(left, 0u);
+    size_t cap   = m.capacity();
+    size_t calls = 0;
+    for (; left; ++calls) {
+        // one group of one submap at a time
+        left = m.compact(1);
+        if (calls % 1000 == 0) {
+            for (int i = 0; i < 100000; i += 97)
+                ASSERT_EQ(m.contains(i), i % 2 == 1);
+        }
+    }
+    // at most three passes over the groups of each submap
+    EXPECT_LE(calls, 3 * (cap / Group::kWidth + Map::subcnt()));
+    EXPECT_EQ(m.capacity(), cap);
+    EXPECT_EQ(m.size(), 50000u);
+    for (int i = 0; i < 100000; ++i)
+        ASSERT_EQ(m.contains(i), i % 2 == 1);
+}
+
 } // namespace
 } // namespace priv
 } // namespace gtl
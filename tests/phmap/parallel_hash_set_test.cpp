@@ -5,6 +5,9 @@
 
 #include "flat_hash_set_test.cpp"
 
+#include <algorithm>
+#include <memory>
+
 namespace gtl {
 namespace priv {
 namespace {
@@ -156,6 +159,45 @@ TEST(THIS_TEST_NAME, EmplaceSingle) {
     EXPECT_EQ(m.count(11), 0u);
 }
 
+// Gives each submap an allocator with its own id (see
+// select_on_submap_construction() in docs/phmap.md).
+template<class T>
+struct SubmapNumberingAllocator : std::allocator<T> {
+    SubmapNumberingAllocator() = default;
+
+    template<class U>
+    SubmapNumberingAllocator(const SubmapNumberingAllocator<U>& o)
+        : next(o.next)
+        , id(o.id) {}
+
+    SubmapNumberingAllocator select_on_submap_construction() const {
+        SubmapNumberingAllocator res(*this);
+        res.id = ++*next;
+        return res;
+    }
+
+    std::shared_ptr<int> next = std::make_shared<int>(0);
+    int                  id   = 0;
+};
+
+TEST(THIS_TEST_NAME, SubmapAllocator) {
+    using Alloc = SubmapNumberingAllocator<int>;
+    using Set   = gtl::THIS_HASH_SET<int, gtl::Hash<int>, std::equal_to<int>, Alloc>;
+
+    Alloc a;
+    Set   s(0, Set::hasher(), Set::key_equal(), a);
+    EXPECT_EQ(*a.next, (int)s.subcnt());
+    for (int i = 0; i < 1000; ++i)
+        s.insert(i);
+
+    std::vector<int> ids;
+    for (size_t i = 0; i < s.subcnt(); ++i)
+        s.with_submap(i, [&](const auto& set) { ids.push_back(set.get_allocator().id); });
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 0; i < ids.size(); ++i)
+        EXPECT_EQ(ids[i], (int)i + 1);
+}
+
 } // namespace
 } // namespace priv
 } // namespace gtl
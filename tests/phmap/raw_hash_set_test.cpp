@@ -47,6 +47,11 @@ struct RawHashSetTestOnlyAccess {
     static auto GetSlots(const C& c) -> decltype(c.slots_) {
         return c.slots_;
     }
+
+    template<typename C>
+    static size_t GetNumDeleted(const C& c) {
+        return c.num_deleted();
+    }
 };
 
 namespace {
@@ -75,24 +80,35 @@ TEST(Util, NormalizeCapacity) {
 TEST(Util, GrowthAndCapacity) {
     // Verify that GrowthToCapacity gives the minimum capacity that has enough
     // growth.
-    for (size_t growth = 0; growth < 10000; ++growth) {
-        SCOPED_TRACE(growth);
-        size_t capacity = NormalizeCapacity(GrowthToLowerboundCapacity(growth));
-        // The capacity is large enough for `growth`
-        EXPECT_THAT(CapacityToGrowth(capacity), Ge(growth));
-        if (growth != 0 && capacity > 1) {
-            // There is no smaller capacity that works.
-            EXPECT_THAT(CapacityToGrowth(capacity / 2), Lt(growth));
+    for (max_load_t max_load : { kDefaultMaxLoad, kMinMaxLoad, max_load_t(128), kMaxMaxLoad }) {
+        SCOPED_TRACE(max_load);
+        for (size_t growth = 0; growth < 10000; ++growth) {
+            SCOPED_TRACE(growth);
+            size_t capacity = NormalizeCapacity(GrowthToLowerboundCapacity(growth, max_load));
+            // The capacity is large enough for `growth`
+            EXPECT_THAT(CapacityToGrowth(capacity, max_load), Ge(growth));
+            if (growth != 0 && capacity > 1) {
+                // There is no smaller capacity that works.
+                EXPECT_THAT(CapacityToGrowth(capacity / 2, max_load), Lt(growth));
+            }
         }
-    }
 
-    for (size_t capacity = Group::kWidth - 1; capacity < 10000; capacity = 2 * capacity + 1) {
-        SCOPED_TRACE(capacity);
-        size_t growth = CapacityToGrowth(capacity);
-        EXPECT_THAT(growth, Lt(capacity));
-        EXPECT_LE(GrowthToLowerboundCapacity(growth), capacity);
-        EXPECT_EQ(NormalizeCapacity(GrowthToLowerboundCapacity(growth)), capacity);
+        for (size_t capacity = Group::kWidth - 1; capacity < 10000; capacity = 2 * capacity + 1) {
+            SCOPED_TRACE(capacity);
+            size_t growth = CapacityToGrowth(capacity, max_load);
+            EXPECT_THAT(growth, Lt(capacity));
+            EXPECT_LE(GrowthToLowerboundCapacity(growth, max_load), capacity);
+            EXPECT_EQ(NormalizeCapacity(GrowthToLowerboundCapacity(growth, max_load)), capacity);
+        }
     }
+
+    // the default is 7/8
+    for (size_t capacity = 15; capacity < 10000; capacity = 2 * capacity + 1)
+        EXPECT_EQ(CapacityToGrowth(capacity), capacity - capacity / 8);
+    EXPECT_EQ(ToMaxLoad(0.875f), kDefaultMaxLoad);
+    EXPECT_EQ(ToMaxLoad(0.5f), 128);
+    EXPECT_EQ(ToMaxLoad(1.0f), kMaxMaxLoad);
+    EXPECT_EQ(ToMaxLoad(0.0f), kMinMaxLoad);
 }
 
 TEST(Util, probe_seq) {
@@ -110,6 +126,29 @@ TEST(Util, probe_seq) {
     EXPECT_THAT(offsets, ElementsAre(0, 16, 48, 96, 32, 112, 80, 64));
 }
 
+TEST(Util, HashBytes) {
+    std::string buf(300, '\0');
+    for (size_t i = 0; i < buf.size(); ++i)
+        buf[i] = static_cast<char>(i * 131 + 7);
+
+    gtl::flat_hash_set<uint64_t> seen;
+    for (size_t len = 0; len < buf.size(); ++len) {
+        uint64_t h = gtl::hash_bytes(buf.data(), len);
+        EXPECT_TRUE(seen.insert(h).second) << len;
+        EXPECT_NE(gtl::hash_bytes(buf.data(), len, 1), h);
+        size_t folded = gtl::fold_if_needed<sizeof(size_t)>()(h);
+        EXPECT_EQ(gtl::Hash<std::string>()(buf.substr(0, len)), folded);
+        EXPECT_EQ(gtl::Hash<std::string_view>()(std::string_view(buf.data(), len)), folded);
+
+        // every input bit matters
+        for (size_t i = 0; i < len; ++i) {
+            buf[i] ^= 1 << (i % 8);
+            ASSERT_NE(gtl::hash_bytes(buf.data(), len), h) << len << " " << i;
+            buf[i] ^= 1 << (i % 8);
+        }
+    }
+}
+
 TEST(BitMask, Smoke) {
     EXPECT_FALSE((BitMask<uint8_t, 8>(0)));
     EXPECT_TRUE((BitMask<uint8_t, 8>(5)));
@@ -164,7 +203,15 @@ TEST(Group, EmptyGroup) {
 }
 
 TEST(Group, Match) {
-    if constexpr (Group::kWidth == 16) {
+    if constexpr (Group::kWidth == 32) {
+        ctrl_t group[] = { kEmpty, 1, kDeleted, 3, kEmpty, 5, kSentinel, 7, 7, 5, 3, 1, 1, 1, 1, 1,
+                           1,      1, 1,        1, 1,      1, 1,         1, 1, 1, 1, 1, 1, 1, kEmpty, kDeleted };
+        EXPECT_THAT(Group{ group }.Match(0), ElementsAre());
+        EXPECT_THAT(Group{ group }.Match(3), ElementsAre(3, 10));
+        EXPECT_THAT(Group{ group }.Match(5), ElementsAre(5, 9));
+        EXPECT_THAT(Group{ group }.Match(7), ElementsAre(7, 8));
+        EXPECT_EQ(Group{ group }.Match(1).HighestBitSet(), 29u);
+    } else if constexpr (Group::kWidth == 16) {
         ctrl_t group[] = { kEmpty, 1, kDeleted, 3, kEmpty, 5, kSentinel, 7, 7, 5, 3, 1, 1, 1, 1, 1 };
         EXPECT_THAT(Group{ group }.Match(0), ElementsAre());
         EXPECT_THAT(Group{ group }.Match(1), ElementsAre(1, 11, 12, 13, 14, 15));
@@ -182,7 +229,11 @@ TEST(Group, Match) {
 }
 
 TEST(Group, MatchEmpty) {
-    if constexpr (Group::kWidth == 16) {
+    if constexpr (Group::kWidth == 32) {
+        ctrl_t group[] = { kEmpty, 1, kDeleted, 3, kEmpty, 5, kSentinel, 7, 7, 5, 3, 1, 1, 1, 1, 1,
+                           1,      1, 1,        1, 1,      1, 1,         1, 1, 1, 1, 1, 1, 1, kEmpty, kDeleted };
+        EXPECT_THAT(Group{ group }.MatchEmpty(), ElementsAre(0, 4, 30));
+    } else if constexpr (Group::kWidth == 16) {
         ctrl_t group[] = { kEmpty, 1, kDeleted, 3, kEmpty, 5, kSentinel, 7, 7, 5, 3, 1, 1, 1, 1, 1 };
         EXPECT_THAT(Group{ group }.MatchEmpty(), ElementsAre(0, 4));
     } else if constexpr (Group::kWidth == 8) {
@@ -194,7 +245,11 @@ TEST(Group, MatchEmpty) {
 }
 
 TEST(Group, MatchEmptyOrDeleted) {
-    if constexpr (Group::kWidth == 16) {
+    if constexpr (Group::kWidth == 32) {
+        ctrl_t group[] = { kEmpty, 1, kDeleted, 3, kEmpty, 5, kSentinel, 7, 7, 5, 3, 1, 1, 1, 1, 1,
+                           1,      1, 1,        1, 1,      1, 1,         1, 1, 1, 1, 1, 1, 1, kEmpty, kDeleted };
+        EXPECT_THAT(Group{ group }.MatchEmptyOrDeleted(), ElementsAre(0, 2, 4, 30, 31));
+    } else if constexpr (Group::kWidth == 16) {
         ctrl_t group[] = { kEmpty, 1, kDeleted, 3, kEmpty, 5, kSentinel, 7, 7, 5, 3, 1, 1, 1, 1, 1 };
         EXPECT_THAT(Group{ group }.MatchEmptyOrDeleted(), ElementsAre(0, 2, 4));
     } else if constexpr (Group::kWidth == 8) {
@@ -231,7 +286,7 @@ TEST(Batch, DropDeletes) {
 }
 
 TEST(Group, CountLeadingEmptyOrDeleted) {
-    const std::vector<ctrl_t> empty_examples = { kEmpty, kDeleted };
+    const std::vector<ctrl_t> empty_examples = { kEmpty, kDeleted, kDeletedOld };
     const std::vector<ctrl_t> full_examples  = { 0, 1, 2, 3, 5, 9, 127, kSentinel };
 
     for (ctrl_t empty : empty_examples) {
@@ -1326,6 +1381,24 @@ TEST(Table, RehashZeroForcesRehash) {
     EXPECT_NE(p, &*t.find(0));
 }
 
+TEST(Table, RehashZeroAtCapacityBoundaryKeepsGrowthRoom) {
+    IntTable t;
+    int64_t  n = 0;
+    while (t.capacity() < 31)
+        t.emplace(n++);
+    size_t cap = t.capacity();
+    // as many elements as the next smaller capacity has slots, so that they
+    // would fill it completely
+    while (t.size() > cap / 2)
+        t.erase(--n);
+    t.rehash(0);
+    EXPECT_GT(CapacityToGrowth(t.capacity()), t.size());
+    t.emplace(n);
+    EXPECT_EQ(t.size(), cap / 2 + 1);
+    for (int64_t i = 0; i <= n; ++i)
+        ASSERT_TRUE(t.find(i) != t.end());
+}
+
 TEST(Table, ConstructFromInitList) {
     using P = std::pair<std::string, std::string>;
     struct Q {
@@ -1528,6 +1601,97 @@ TEST(Table, ReplacingDeletedSlotDoesNotRehash) {
     EXPECT_EQ(c, t.bucket_count()) << "rehashing threshold = " << n;
 }
 
+TEST(Table, Compact) {
+    // a full table: the erasures leave runs of tombstones that erase() cannot
+    // turn back into empty slots
+    IntTable t;
+    t.rehash(1000);
+    const size_t cap = t.bucket_count();
+    const size_t n   = CapacityToGrowth(cap);
+    for (size_t i = 0; i != n; ++i)
+        t.emplace(i);
+    ASSERT_EQ(t.bucket_count(), cap);
+    for (size_t i = 0; i < n; i += 2)
+        t.erase(i);
+    const size_t deleted = RawHashSetTestOnlyAccess::GetNumDeleted(t);
+    ASSERT_GT(deleted, 0u);
+
+    IntTable::compact_cursor c;
+    size_t                   calls = 1;
+    for (; t.compact(c, 1) == 0; ++calls) {}
+    // three passes over the groups of the table, one group per call
+    EXPECT_LE(calls, 3 * (cap / Group::kWidth + 1) + 1);
+    EXPECT_LT(RawHashSetTestOnlyAccess::GetNumDeleted(t), deleted / 2);
+    EXPECT_EQ(t.bucket_count(), cap);
+    for (size_t i = 0; i != n; ++i)
+        ASSERT_EQ(t.contains(i), i % 2 == 1) << i;
+
+    // nothing to do until the next erasure
+    EXPECT_EQ(t.compact(c, 1), 1u);
+}
+
+TEST(Table, CompactWhileModified) {
+    IntTable                 t;
+    std::vector<int64_t>     keys;
+    std::mt19937             gen(42);
+    IntTable::compact_cursor c;
+    int64_t                  next = 0;
+    for (; next != 3000; ++next) {
+        t.emplace(next);
+        keys.push_back(next);
+    }
+    for (int i = 0; i != 50000; ++i) {
+        t.compact(c, 1);
+        // erase a random key, and insert a new one
+        size_t k = std::uniform_int_distribution<size_t>(0, keys.size() - 1)(gen);
+        ASSERT_EQ(t.erase(keys[k]), 1u);
+        keys[k] = next++;
+        t.emplace(keys[k]);
+        if (i % 5000 == 0) {
+            for (int64_t key : keys)
+                ASSERT_TRUE(t.contains(key)) << key;
+        }
+    }
+    EXPECT_EQ(t.size(), keys.size());
+    for (int64_t key : keys)
+        ASSERT_TRUE(t.contains(key)) << key;
+}
+
+TEST(Table, MaxLoadFactor) {
+    for (float f : { 0.5f, 0.875f, 0.9375f }) {
+        SCOPED_TRACE(f);
+        IntTable t;
+        t.max_load_factor(f);
+        EXPECT_EQ(t.max_load_factor(), f);
+        size_t max_load = 0;
+        for (int64_t i = 0; i < 10000; ++i) {
+            t.emplace(i);
+            if (t.bucket_count() > 64) // small tables can be full
+                max_load = (std::max)(max_load, t.size() * 1024 / (t.bucket_count() + 1));
+        }
+        EXPECT_LE(max_load, size_t(f * 1024));
+        EXPECT_GT(max_load, size_t(f * 1024) - 16);
+
+        t.reserve(20000);
+        EXPECT_LE(20000u, size_t(t.bucket_count() * f));
+
+        // the copies keep the maximum load factor
+        IntTable t2(t);
+        EXPECT_EQ(t2.max_load_factor(), f);
+        IntTable t3(std::move(t2));
+        EXPECT_EQ(t3.max_load_factor(), f);
+    }
+
+    // lowering it rehashes the table
+    IntTable t;
+    for (int64_t i = 0; i < 900; ++i)
+        t.emplace(i);
+    t.max_load_factor(0.25f);
+    EXPECT_LE(t.size() * 4, t.bucket_count());
+    for (int64_t i = 0; i < 900; ++i)
+        ASSERT_TRUE(t.contains(i));
+}
+
 TEST(Table, NoThrowMoveConstruct) {
     ASSERT_TRUE(std::is_nothrow_copy_constructible<gtl::Hash<std::string_view>>::value);
     ASSERT_TRUE(std::is_nothrow_copy_constructible<std::equal_to<std::string_view>>::value);
@@ -1817,6 +1981,39 @@ TEST(TableDeathTest, EraseOfEndAsserts) {
     EXPECT_DEATH_IF_SUPPORTED(t.erase(t.end()), kDeathMsg);
 }
 
+TEST(Table, InsertUniqueUnchecked) {
+    IntTable t;
+    for (int64_t i = 0; i < 100; ++i)
+        EXPECT_EQ(*t.insert_unique_unchecked(i), i);
+
+    std::vector<int64_t> v;
+    for (int64_t i = 100; i < 1000; ++i)
+        v.push_back(i);
+    t.insert_unique_unchecked(v.begin(), v.end());
+    EXPECT_EQ(t.size(), 1000u);
+    for (int64_t i = 0; i < 1000; ++i)
+        EXPECT_TRUE(t.contains(i));
+
+    IntTable u(gtl::from_unique_range, v.begin(), v.end());
+    EXPECT_EQ(u.size(), v.size());
+    EXPECT_TRUE(u.contains(500));
+    EXPECT_FALSE(u.contains(50));
+}
+
+TEST(TableDeathTest, InsertUniqueUncheckedDuplicateAsserts) {
+    bool assert_enabled = false;
+    assert([&]() {
+        assert_enabled = true;
+        return true;
+    }());
+    if (!assert_enabled)
+        return;
+
+    IntTable t;
+    t.insert(1);
+    EXPECT_DEATH_IF_SUPPORTED(t.insert_unique_unchecked(1), "key already present");
+}
+
 #ifdef ADDRESS_SANITIZER
 TEST(Sanitizer, PoisoningUnused) {
     IntTable t;
@@ -0,0 +1,90 @@
+#include <array>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+#include "gtl/static_map.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+enum class op { add, sub, mul, div, mod };
+
+constexpr auto ops = gtl::make_static_map<std::string_view, op>(
+    { { "add", op::add }, { "sub", op::sub }, { "mul", op::mul }, { "div", op::div }, { "mod", op::mod } });
+
+static_assert(ops.size() == 5);
+static_assert(ops.at("mul") == op::mul);
+static_assert(ops["mod"] == op::mod);
+static_assert(ops.contains("div"));
+static_assert(!ops.contains("pow"));
+static_assert(!ops.contains(""));
+static_assert(ops.find("abs") == ops.end());
+
+constexpr auto op_names = gtl::make_static_map<op, std::string_view>(
+    { { op::add, "add" }, { op::sub, "sub" }, { op::mul, "mul" }, { op::div, "div" } });
+
+static_assert(op_names.at(op::sub) == "sub");
+static_assert(!op_names.contains(op::mod));
+
+constexpr auto keywords = gtl::make_static_set<std::string_view>({ "if", "else", "while", "for", "return" });
+
+static_assert(keywords.contains("while"));
+static_assert(!keywords.contains("do"));
+
+// a larger table of integral keys, built at compile time
+constexpr auto squares = [] {
+    std::array<std::pair<int64_t, int64_t>, 500> values{};
+    for (int64_t i = 0; i < 500; ++i)
+        values[i] = { i * 7919 - 1000, i * i };
+    return gtl::static_map<int64_t, int64_t, 500>(values);
+}();
+
+static_assert(squares.at(-1000) == 0);
+static_assert(squares.at(499 * 7919 - 1000) == 499 * 499);
+static_assert(!squares.contains(1));
+
+TEST(StaticMap, Lookups) {
+    EXPECT_EQ(ops.at(std::string("sub")), op::sub);
+    EXPECT_EQ(ops.find("add")->second, op::add);
+    EXPECT_EQ(ops.count("pow"), 0u);
+    EXPECT_THROW(ops.at("pow"), std::out_of_range);
+
+    // the iteration visits every key once
+    std::set<std::string_view> names;
+    for (auto& [name, o] : ops) {
+        EXPECT_EQ(ops.at(name), o);
+        names.insert(name);
+    }
+    EXPECT_EQ(names.size(), ops.size());
+    EXPECT_EQ(std::distance(keywords.begin(), keywords.end()), 5);
+
+    for (int64_t i = 0; i < 500; ++i) {
+        ASSERT_EQ(squares.at(i * 7919 - 1000), i * i);
+        ASSERT_FALSE(squares.contains(i * 7919 - 999));
+    }
+}
+
+TEST(StaticMap, RunTime) {
+    // a table can also be built at run time, from keys which are not known at
+    // compile time
+    std::array<uint32_t, 1000> keys{};
+    for (uint32_t i = 0; i < keys.size(); ++i)
+        keys[i] = i * 2654435761u;
+    gtl::static_set<uint32_t, 1000> s(keys);
+    for (uint32_t k : keys)
+        ASSERT_TRUE(s.contains(k));
+    EXPECT_FALSE(s.contains(1u));
+
+    keys[10] = keys[500];
+    using Set = gtl::static_set<uint32_t, 1000>;
+    EXPECT_THROW(Set{ keys }, std::invalid_argument);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl
@@ -0,0 +1,297 @@
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "gtl/phmap.hpp"
+
+namespace gtl {
+namespace priv {
+namespace {
+
+std::string make_key(int i) {
+    // short keys are stored inline, long ones in the arena
+    return i % 2 ? std::to_string(i) : "a somewhat longer key #" + std::to_string(i);
+}
+
+TEST(StringFlatHashMap, StringKey) {
+    static_assert(sizeof(gtl::string_key) == 16);
+
+    string_arena     arena;
+    gtl::string_key  empty(arena, "");
+    gtl::string_key  shortk(arena, "fifteen bytes!!");
+    gtl::string_key  longk(arena, "sixteen bytes!!!");
+    std::string_view sv = longk;
+
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_FALSE(shortk.is_long());
+    EXPECT_EQ(shortk.view(), "fifteen bytes!!");
+    EXPECT_TRUE(longk.is_long());
+    EXPECT_EQ(sv, "sixteen bytes!!!");
+    EXPECT_EQ(arena.bytes_used(), 16u);
+
+    EXPECT_TRUE(longk == gtl::string_key(arena, "sixteen bytes!!!"));
+    EXPECT_FALSE(longk == gtl::string_key(arena, "sixteen bytes!!?"));
+    EXPECT_FALSE(longk == std::string_view("sixteen bytes!!"));
+    EXPECT_FALSE(shortk == std::string_view("fifteen bytes!?"));
+    EXPECT_TRUE(shortk == std::string_view("fifteen bytes!!"));
+}
+
+TEST(StringFlatHashMap, InsertFindErase) {
+    gtl::string_flat_hash_map<int> m;
+    constexpr int                  num = 10000;
+    for (int i = 0; i < num; ++i)
+        m[make_key(i)] = i;
+    EXPECT_EQ(m.size(), (size_t)num);
+    EXPECT_GT(m.get_allocator().arena_bytes_used(), 0u);
+
+    for (int i = 0; i < num; ++i) {
+        std::string k = make_key(i);
+        ASSERT_EQ(m.at(k), i);
+        ASSERT_EQ(m.at(std::string_view(k)), i);
+        ASSERT_EQ(m.at(k.c_str()), i);
+        ASSERT_TRUE(m.contains(k));
+    }
+    EXPECT_FALSE(m.contains("a somewhat longer key #1"));
+    EXPECT_FALSE(m.contains(""));
+    EXPECT_TRUE(m.find("nope") == m.end());
+
+    auto [it, inserted] = m.insert({ "another long key, not inline", -1 });
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, "another long key, not inline");
+    EXPECT_FALSE(m.try_emplace("another long key, not inline", -2).second);
+    EXPECT_TRUE(m.emplace("", -3).second);
+    EXPECT_EQ(m[""], -3);
+
+    for (int i = 0; i < num; i += 3)
+        EXPECT_EQ(m.erase(make_key(i)), 1u);
+    for (int i = 0; i < num; ++i)
+        ASSERT_EQ(m.contains(make_key(i)), i % 3 != 0);
+
+    size_t cnt = 0;
+    for (const auto& [k, v] : m) {
+        if (v >= 0) {
+            EXPECT_EQ(std::string_view(k), make_key(v));
+        }
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, m.size());
+}
+
+TEST(StringFlatHashMap, CopyMoveSwap) {
+    gtl::string_flat_hash_map<int> copy, moved, swapped;
+    {
+        gtl::string_flat_hash_map<int> m;
+        for (int i = 0; i < 1000; ++i)
+            m[make_key(i)] = i;
+
+        // the copy has its own arena, and outlives the original
+        copy = m;
+        EXPECT_EQ(copy, m);
+        EXPECT_NE(copy.get_allocator(), m.get_allocator());
+
+        gtl::string_flat_hash_map<int> tmp(m);
+        moved = std::move(tmp);
+        swapped.swap(m);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(copy.at(make_key(i)), i);
+        ASSERT_EQ(moved.at(make_key(i)), i);
+        ASSERT_EQ(swapped.at(make_key(i)), i);
+    }
+    EXPECT_EQ(copy, moved);
+
+    copy.rehash(10000);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(copy.at(make_key(i)), i);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+}
+
+TEST(StringFlatHashMap, AllocatorEquality) {
+    // the arena is created with the allocator, so its copies stay equal
+    gtl::string_flat_hash_map<int> m;
+    auto                           a = m.get_allocator();
+    auto                           b = a;
+    EXPECT_TRUE(a == m.get_allocator());
+    m[make_key(0)] = 0;
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a == m.get_allocator());
+    EXPECT_FALSE(a == gtl::string_flat_hash_map<int>().get_allocator());
+
+    auto moved_to = std::move(b);
+    EXPECT_TRUE(moved_to == b);
+}
+
+TEST(StringFlatHashMap, ArenaChurn) {
+    // the space of the erased keys is reclaimed by compact(), so the arena
+    // stays proportional to the live keys (and the table) under erase/insert
+    // churn
+    using Map = gtl::string_flat_hash_map<int>;
+    Map                 m;
+    Map::compact_cursor c;
+    constexpr int       num  = 1000;
+    size_t              live = 0;
+    for (int i = 0; i < num; ++i) {
+        m[make_key(2 * i)] = i; // long keys
+        live += make_key(2 * i).size();
+    }
+    for (int i = num; i < 100 * num; ++i) {
+        std::string k = make_key(2 * (i - num));
+        live -= k.size();
+        ASSERT_EQ(m.erase(k), 1u);
+        m[make_key(2 * i)] = i;
+        live += make_key(2 * i).size();
+        m.compact(c, 1);
+        ASSERT_LE(m.get_allocator().arena_bytes_used(), 2 * (live + m.capacity() * sizeof(Map::value_type)));
+    }
+    EXPECT_EQ(m.size(), (size_t)num);
+    for (int i = 99 * num; i < 100 * num; ++i)
+        ASSERT_EQ(m.at(make_key(2 * i)), i);
+
+    // erasing every element, or clearing the map, releases the whole arena
+    auto before = m.get_allocator();
+    for (int i = 99 * num; i < 100 * num; ++i)
+        m.erase(make_key(2 * i));
+    EXPECT_EQ(m.get_allocator().arena_bytes_used(), 0u);
+    EXPECT_FALSE(m.get_allocator() == before);
+    EXPECT_GT(before.arena_bytes_used(), 0u);
+
+    for (int i = 0; i < num; ++i)
+        m[make_key(2 * i)] = i;
+    m.clear();
+    EXPECT_EQ(m.get_allocator().arena_bytes_used(), 0u);
+
+    // a rehash copies the keys to a new arena when enough of them were erased
+    for (int i = 0; i < num; ++i)
+        m[make_key(2 * i)] = i;
+    for (int i = 0; i < num * 3 / 4; ++i)
+        m.erase(make_key(2 * i));
+    size_t used = m.get_allocator().arena_bytes_used();
+    m.rehash(0);
+    EXPECT_LT(m.get_allocator().arena_bytes_used(), used);
+    for (int i = num * 3 / 4; i < num; ++i)
+        ASSERT_EQ(m.at(make_key(2 * i)), i);
+}
+
+TEST(StringFlatHashMap, EraseKeepsOtherKeys) {
+    // erase() never moves the other keys, however much of the arena the
+    // erased ones take: only compact() (or clear() and rehash()) does
+    gtl::string_flat_hash_map<int> m;
+    constexpr int                  num = 1000;
+    auto                           key = [](int i) { return std::string(100, 'k') + std::to_string(i); };
+    for (int i = 0; i < num; ++i)
+        m[key(i)] = i;
+
+    const std::string kept = key(0);
+    std::string_view  sv   = m.find(kept)->first.view();
+    for (int i = 1; i < num; ++i)
+        ASSERT_EQ(m.erase(key(i)), 1u);
+    EXPECT_EQ(m.find(kept)->first.data(), sv.data());
+    EXPECT_EQ(sv, kept);
+
+    decltype(m)::compact_cursor c;
+    m.compact(c, 1);
+    EXPECT_NE(m.find(kept)->first.data(), sv.data()); // moved to a new arena
+    EXPECT_EQ(m.at(kept), 0);
+    EXPECT_EQ(m.get_allocator().arena_bytes_used(), kept.size());
+}
+
+TEST(StringFlatHashMap, MergeAndNodes) {
+    // the long keys moved in from another map are copied to the destination's
+    // arena, so they outlive the source map
+    gtl::string_flat_hash_map<std::string> dst, nodes;
+    gtl::parallel_string_flat_hash_map<int> pdst;
+    dst[make_key(0)] = "kept";
+    {
+        gtl::string_flat_hash_map<std::string>  src;
+        gtl::parallel_string_flat_hash_map<int> psrc;
+        for (int i = 0; i < 1000; ++i) {
+            src[make_key(i)] = std::to_string(i);
+            psrc[make_key(i)] = i;
+        }
+        dst.merge(src);
+        EXPECT_EQ(src.size(), 1u); // make_key(0) was already in dst
+        for (int i = 0; i < 1000; ++i) {
+            src[make_key(i + 1000)] = std::to_string(i + 1000);
+            auto res = nodes.insert(src.extract(make_key(i + 1000)));
+            ASSERT_TRUE(res.inserted);
+        }
+        pdst.merge(psrc);
+        EXPECT_TRUE(psrc.empty());
+    }
+    EXPECT_EQ(dst.size(), 1000u);
+    EXPECT_EQ(dst.at(make_key(0)), "kept");
+    for (int i = 1; i < 1000; ++i)
+        ASSERT_EQ(dst.at(make_key(i)), std::to_string(i));
+    EXPECT_EQ(nodes.size(), 1000u);
+    for (int i = 1000; i < 2000; ++i)
+        ASSERT_EQ(nodes.at(make_key(i)), std::to_string(i));
+    EXPECT_EQ(pdst.size(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(pdst.at(make_key(i)), i);
+}
+
+TEST(StringFlatHashMap, ParallelConcurrentInsert) {
+    using Map = gtl::parallel_string_flat_hash_map<int,
+                                                   gtl::priv::string_key_hash,
+                                                   gtl::priv::string_key_eq,
+                                                   gtl::string_arena_allocator<Pair<const gtl::string_key, int>>,
+                                                   4,
+                                                   std::mutex>;
+    static constexpr int THREADS    = 4;
+    static constexpr int PER_THREAD = 20000;
+
+    // an allocator which already owns an arena: the submaps still get their own
+    Map other;
+    other.try_emplace(make_key(0), 0);
+    Map m(0, Map::hasher(), Map::key_equal(), other.get_allocator());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&m, t]() {
+            for (int i = t; i < THREADS * PER_THREAD; i += THREADS)
+                m.try_emplace(make_key(i), i);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(m.size(), (size_t)THREADS * PER_THREAD);
+    for (int i = 0; i < THREADS * PER_THREAD; ++i)
+        ASSERT_TRUE(m.if_contains(make_key(i), [&](const auto& v) { ASSERT_EQ(v.second, i); }));
+
+    std::vector<Map::allocator_type> allocs;
+    for (size_t i = 0; i < m.subcnt(); ++i)
+        m.with_submap(i, [&](const auto& set) { allocs.push_back(set.get_allocator()); });
+    for (size_t i = 0; i < allocs.size(); ++i) {
+        EXPECT_FALSE(allocs[i] == other.get_allocator());
+        for (size_t j = 0; j < i; ++j)
+            EXPECT_FALSE(allocs[i] == allocs[j]);
+    }
+
+    // an element whose key cannot be deduced is looked up without storing its key
+    struct KeyValue {
+        std::string key;
+        int         value;
+
+        operator std::pair<std::string_view, int>() const { return { key, value }; }
+    };
+    EXPECT_FALSE(m.emplace(KeyValue{ make_key(0), -1 }).second);
+    auto [it, inserted] = m.emplace(KeyValue{ "yet another long key, not inline", -1 });
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, "yet another long key, not inline");
+    m.erase(it);
+
+    // moving the map keeps the arena of each submap
+    Map moved(std::move(m));
+    for (size_t i = 0; i < moved.subcnt(); ++i)
+        moved.with_submap(i, [&](const auto& set) { EXPECT_TRUE(set.get_allocator() == allocs[i]); });
+    EXPECT_EQ(moved.at(make_key(2)), 2);
+}
+
+} // namespace
+} // namespace priv
+} // namespace gtl